@@ -0,0 +1,425 @@
+#include "AssetStreamer.h"
+#include "FrameProfiler.h"
+#include "MeshCache.h"
+#include "VRLog.h"
+#include <raymath.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#ifdef __EMSCRIPTEN__
+#include <emscripten/emscripten.h>
+#endif
+
+// Heap-allocated per web request so a response arriving after the streamer
+// is gone finds a null owner instead of a dangling pointer
+struct AssetStreamer::FetchRequest {
+    AssetStreamer* owner;
+    Asset* asset;
+};
+
+namespace {
+    struct FaceVertex {
+        int position;
+        int texcoord;   // -1 when the face has none
+        int normal;
+    };
+
+    // 1-based OBJ index (negative counts back from the end) to 0-based, -1 when out of range
+    int resolveIndex(long index, int count) {
+        long resolved = index < 0 ? count + index : index - 1;
+        return (resolved >= 0 && resolved < count) ? (int)resolved : -1;
+    }
+
+    const char* skipSpaces(const char* p) {
+        while (*p == ' ' || *p == '\t') p++;
+        return p;
+    }
+
+    // Case-sensitive and free of raylib's shared text buffers, so the worker can call it
+    bool hasExtension(const std::string& path, const char* extension) {
+        size_t length = strlen(extension);
+        return path.size() >= length && path.compare(path.size() - length, length, extension) == 0;
+    }
+
+    const char* nextLine(const char* p) {
+        while (*p && *p != '\n') p++;
+        return *p ? p + 1 : p;
+    }
+
+    template <typename T>
+    T* copyToRaylib(const T* data, int count) {
+        T* out = (T*)MemAlloc((unsigned int)(count * sizeof(T)));
+        memcpy(out, data, count * sizeof(T));
+        return out;
+    }
+}
+
+AssetStreamer::AssetStreamer() : inFlight(0), stats() {
+#ifdef ASSETSTREAMER_THREADS
+    stopping = false;
+    worker = std::thread(&AssetStreamer::workerLoop, this);
+#endif
+}
+
+AssetStreamer::~AssetStreamer() {
+#ifdef ASSETSTREAMER_THREADS
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+#endif
+    for (FetchRequest* fetch : fetches) fetch->owner = nullptr;
+
+    // GPU objects are gone with the context by now; only CPU copies are left to free
+    for (auto& asset : assets) releaseCPU(*asset);
+}
+
+AssetStreamer::Handle AssetStreamer::request(const char* path, Kind kind, int priority) {
+    std::unique_ptr<Asset> asset(new Asset());
+    asset->path = path;
+    asset->kind = kind;
+    asset->priority = priority;
+    asset->state = State::Queued;
+
+    assets.push_back(std::move(asset));
+    stats.queued++;
+    return (Handle)assets.size() - 1;
+}
+
+AssetStreamer::Handle AssetStreamer::requestModel(const char* path, int priority) {
+    return request(path, Kind::Model, priority);
+}
+
+AssetStreamer::Handle AssetStreamer::requestTexture(const char* path, int priority) {
+    return request(path, Kind::Texture, priority);
+}
+
+void AssetStreamer::setPriority(Handle handle, int priority) {
+    assets[handle]->priority = priority;
+}
+
+void AssetStreamer::startFetches() {
+    while (inFlight < MAX_IN_FLIGHT) {
+        // Highest priority first, request order among equals
+        Asset* next = nullptr;
+        for (auto& asset : assets) {
+            if (asset->state == State::Queued && (!next || asset->priority > next->priority)) next = asset.get();
+        }
+        if (!next) return;
+
+        next->state = State::Fetching;
+        inFlight++;
+
+#ifdef __EMSCRIPTEN__
+        FetchRequest* fetch = new FetchRequest{ this, next };
+        fetches.push_back(fetch);
+        // free = 0: the response buffer is handed over to the decoder
+        emscripten_async_wget2_data(next->path.c_str(), "GET", "", fetch, 0, onFetchLoad, onFetchError, nullptr);
+#else
+        // The worker reads the file itself
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(next);
+        }
+        wake.notify_one();
+#endif
+    }
+}
+
+#ifdef __EMSCRIPTEN__
+void AssetStreamer::onFetchLoad(unsigned requestHandle, void* arg, void* data, unsigned size) {
+    FetchRequest* fetch = (FetchRequest*)arg;
+    if (fetch->owner) {
+        AssetStreamer* self = fetch->owner;
+        self->fetches.erase(std::find(self->fetches.begin(), self->fetches.end(), fetch));
+        self->fetchCompleted(*fetch->asset, (unsigned char*)data, (int)size);
+    } else {
+        free(data);
+    }
+    delete fetch;
+}
+
+void AssetStreamer::onFetchError(unsigned requestHandle, void* arg, int status, const char* statusText) {
+    FetchRequest* fetch = (FetchRequest*)arg;
+    if (fetch->owner) {
+        AssetStreamer* self = fetch->owner;
+        self->fetches.erase(std::find(self->fetches.begin(), self->fetches.end(), fetch));
+        VRLOG_WARN("Asset fetch failed: %s (HTTP %d)", fetch->asset->path.c_str(), status);
+        self->fetchCompleted(*fetch->asset, nullptr, 0);
+    }
+    delete fetch;
+}
+#endif
+
+void AssetStreamer::fetchCompleted(Asset& asset, unsigned char* data, int size) {
+    asset.data = data;
+    asset.size = size;
+    asset.state = State::Decoding;
+
+#ifdef ASSETSTREAMER_THREADS
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(&asset);
+    }
+    wake.notify_one();
+#else
+    pendingDecodes.push_back(&asset);
+#endif
+}
+
+#ifdef ASSETSTREAMER_THREADS
+void AssetStreamer::workerLoop() {
+    for (;;) {
+        Asset* asset;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) return;
+            asset = jobs.front();
+            jobs.pop_front();
+        }
+
+        if (!asset->data && asset->state == State::Fetching) {
+            asset->data = LoadFileData(asset->path.c_str(), &asset->size);
+        }
+        decode(*asset);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.push_back(asset);
+    }
+}
+#endif
+
+void AssetStreamer::decode(Asset& asset) {
+    if (asset.data) {
+        if (asset.kind == Kind::Model && hasExtension(asset.path, ".rmc")) {
+            asset.decoded = MeshCache::decode(asset.data, asset.size, asset.chunks);
+        } else if (asset.kind == Kind::Model) {
+            // The parser wants a terminator the fetched bytes do not have
+            std::string text((const char*)asset.data, asset.size);
+            asset.decoded = parseOBJ(text.c_str(), asset.chunks);
+        } else {
+            asset.image = LoadImageFromMemory(GetFileExtension(asset.path.c_str()), asset.data, asset.size);
+            asset.decoded = asset.image.data != nullptr;
+        }
+        UnloadFileData(asset.data);
+        asset.data = nullptr;
+    }
+}
+
+void AssetStreamer::finishDecode(Asset& asset) {
+    inFlight--;
+    stats.bytesFetched += asset.size;
+    if (asset.decoded) {
+        asset.state = State::Uploading;
+    } else {
+        asset.state = State::Failed;
+        VRLOG_WARN("Asset failed to load: %s", asset.path.c_str());
+    }
+}
+
+bool AssetStreamer::uploadSlice(Asset& asset) {
+    if (asset.kind == Kind::Texture) {
+        asset.texture = LoadTextureFromImage(asset.image);
+        UnloadImage(asset.image);
+        asset.image = {};
+        asset.state = State::Ready;
+        return true;
+    }
+
+    int chunkCount = (int)asset.chunks.size();
+    UploadMesh(&asset.chunks[asset.chunksUploaded++], false);
+    if (asset.chunksUploaded < chunkCount) return false;
+
+    // Same layout LoadModel produces: one default material shared by all chunks
+    Model& model = asset.model;
+    model.transform = MatrixIdentity();
+    model.meshCount = chunkCount;
+    model.meshes = copyToRaylib(asset.chunks.data(), chunkCount);
+    model.materialCount = 1;
+    model.materials = (Material*)MemAlloc(sizeof(Material));
+    model.materials[0] = LoadMaterialDefault();
+    model.meshMaterial = (int*)MemAlloc(chunkCount * sizeof(int));
+
+    asset.chunks.clear();
+    asset.state = State::Ready;
+    return true;
+}
+
+void AssetStreamer::update(float budgetMs) {
+    double start = FrameProfiler::now();
+    stats.uploadsLastUpdate = 0;
+
+#ifdef ASSETSTREAMER_THREADS
+    std::deque<Asset*> decoded;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        decoded.swap(finished);
+    }
+    for (Asset* asset : decoded) finishDecode(*asset);
+#else
+    // No worker: decode here, at least one per frame, more while the budget lasts
+    while (!pendingDecodes.empty()) {
+        Asset* asset = pendingDecodes.front();
+        pendingDecodes.pop_front();
+        decode(*asset);
+        finishDecode(*asset);
+        if (FrameProfiler::now() - start >= budgetMs) break;
+    }
+#endif
+
+    startFetches();
+
+    for (;;) {
+        Asset* next = nullptr;
+        for (auto& asset : assets) {
+            if (asset->state == State::Uploading && (!next || asset->priority > next->priority)) next = asset.get();
+        }
+        if (!next) break;
+
+        uploadSlice(*next);
+        stats.uploadsLastUpdate++;
+        if (FrameProfiler::now() - start >= budgetMs) break;
+    }
+
+    stats.queued = stats.loading = stats.uploading = stats.ready = stats.failed = 0;
+    for (auto& asset : assets) {
+        switch (asset->state) {
+        case State::Queued: stats.queued++; break;
+        case State::Fetching:
+        case State::Decoding: stats.loading++; break;
+        case State::Uploading: stats.uploading++; break;
+        case State::Ready: stats.ready++; break;
+        case State::Failed: stats.failed++; break;
+        }
+    }
+    stats.updateTime = (float)(FrameProfiler::now() - start);
+}
+
+void AssetStreamer::unloadAll() {
+    for (auto& asset : assets) {
+        if (asset->state == State::Ready) {
+            if (asset->kind == Kind::Model) UnloadModel(asset->model);
+            else UnloadTexture(asset->texture);
+            asset->model = {};
+            asset->texture = {};
+        } else if (asset->state == State::Uploading) {
+            for (Mesh& chunk : asset->chunks) UnloadMesh(chunk);
+            asset->chunks.clear();
+            if (asset->image.data) UnloadImage(asset->image);
+            asset->image = {};
+        } else {
+            continue;
+        }
+        // Handles of unloaded assets read as failed
+        asset->state = State::Failed;
+    }
+}
+
+void AssetStreamer::releaseCPU(Asset& asset) {
+    if (asset.data) UnloadFileData(asset.data);
+    asset.data = nullptr;
+
+    for (Mesh& chunk : asset.chunks) {
+        MemFree(chunk.vertices);
+        MemFree(chunk.texcoords);
+        MemFree(chunk.normals);
+        MemFree(chunk.indices);
+        MemFree(chunk.vboId);
+    }
+    asset.chunks.clear();
+
+    if (asset.image.data) UnloadImage(asset.image);
+    asset.image = {};
+}
+
+bool AssetStreamer::parseOBJ(const char* text, std::vector<Mesh>& chunks) {
+    std::vector<float> positions, texcoords, normals;
+    std::vector<FaceVertex> corners;   // triangle list
+    FaceVertex polygon[64];
+
+    for (const char* p = text; *p; p = nextLine(p)) {
+        p = skipSpaces(p);
+        char* end;
+
+        if (p[0] == 'v' && (p[1] == ' ' || p[1] == 't' || p[1] == 'n')) {
+            std::vector<float>& target = p[1] == ' ' ? positions : (p[1] == 't' ? texcoords : normals);
+            int components = p[1] == 't' ? 2 : 3;
+            p += p[1] == ' ' ? 1 : 2;
+            for (int i = 0; i < components; i++) {
+                target.push_back(strtof(p, &end));
+                p = end;
+            }
+        } else if (p[0] == 'f' && p[1] == ' ') {
+            int count = 0;
+            p = skipSpaces(p + 1);
+            while (*p && *p != '\n' && *p != '\r' && *p != '#') {
+                FaceVertex v = { -1, -1, -1 };
+                long index = strtol(p, &end, 10);
+                if (end == p) return false;
+                v.position = resolveIndex(index, (int)positions.size() / 3);
+                p = end;
+                if (*p == '/') {
+                    p++;
+                    if (*p != '/') {
+                        v.texcoord = resolveIndex(strtol(p, &end, 10), (int)texcoords.size() / 2);
+                        p = end;
+                    }
+                    if (*p == '/') {
+                        p++;
+                        v.normal = resolveIndex(strtol(p, &end, 10), (int)normals.size() / 3);
+                        p = end;
+                    }
+                }
+                if (v.position < 0 || count == 64) return false;
+                polygon[count++] = v;
+                p = skipSpaces(p);
+            }
+            // Fan from the first corner
+            for (int i = 2; i < count; i++) {
+                corners.push_back(polygon[0]);
+                corners.push_back(polygon[i - 1]);
+                corners.push_back(polygon[i]);
+            }
+        }
+    }
+
+    if (corners.empty()) return false;
+
+    bool hasTexcoords = !texcoords.empty();
+    bool hasNormals = !normals.empty();
+    std::vector<float> vertexData, texcoordData, normalData;
+
+    for (size_t first = 0; first < corners.size(); first += MAX_CHUNK_VERTICES) {
+        int count = (int)std::min(corners.size() - first, (size_t)MAX_CHUNK_VERTICES);
+        vertexData.clear();
+        texcoordData.clear();
+        normalData.clear();
+
+        for (int i = 0; i < count; i++) {
+            const FaceVertex& v = corners[first + i];
+            vertexData.insert(vertexData.end(), positions.begin() + v.position * 3, positions.begin() + v.position * 3 + 3);
+            if (hasTexcoords) {
+                // OBJ puts v = 0 at the bottom of the image, raylib at the top
+                float u = v.texcoord >= 0 ? texcoords[v.texcoord * 2] : 0.0f;
+                float t = v.texcoord >= 0 ? texcoords[v.texcoord * 2 + 1] : 0.0f;
+                texcoordData.push_back(u);
+                texcoordData.push_back(1.0f - t);
+            }
+            if (hasNormals) {
+                for (int k = 0; k < 3; k++) normalData.push_back(v.normal >= 0 ? normals[v.normal * 3 + k] : 0.0f);
+            }
+        }
+
+        Mesh mesh = {};
+        mesh.vertexCount = count;
+        mesh.triangleCount = count / 3;
+        mesh.vertices = copyToRaylib(vertexData.data(), (int)vertexData.size());
+        if (hasTexcoords) mesh.texcoords = copyToRaylib(texcoordData.data(), (int)texcoordData.size());
+        if (hasNormals) mesh.normals = copyToRaylib(normalData.data(), (int)normalData.size());
+        chunks.push_back(mesh);
+    }
+    return true;
+}
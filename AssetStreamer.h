@@ -0,0 +1,131 @@
+#pragma once
+
+#include "raylib.h"
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Decoding runs on a worker thread in native builds and in web builds linked
+// with -pthread; otherwise it runs on the render thread inside update()
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+    #define ASSETSTREAMER_THREADS
+    #include <condition_variable>
+    #include <mutex>
+    #include <thread>
+#endif
+
+// Loads models (.rmc mesh caches, see MeshCache, or OBJ) and images on demand
+// instead of preloading resources/.
+//
+// Requests are fetched (HTTP on the web, file reads natively) in priority
+// order with a few in flight, decoded into CPU meshes and images off the
+// render thread, then uploaded to the GPU by update() in slices that fit a
+// per-frame time budget. Large meshes are split into chunks so a single
+// upload slice stays short.
+class AssetStreamer {
+public:
+    typedef int Handle;
+
+    enum class Kind { Model, Texture };
+    enum class State { Queued, Fetching, Decoding, Uploading, Ready, Failed };
+    enum Priority { Low = 0, Normal = 1, High = 2 };
+
+    static const int MAX_IN_FLIGHT = 4;            // fetches + decodes outstanding
+    static const int MAX_CHUNK_VERTICES = 32766;   // whole triangles per uploaded mesh chunk
+
+    struct Stats {
+        int queued;
+        int loading;            // fetching or decoding
+        int uploading;
+        int ready;
+        int failed;
+        int uploadsLastUpdate;  // upload slices done by the last update()
+        float updateTime;       // ms spent in the last update()
+        long long bytesFetched;
+    };
+
+private:
+    struct Asset {
+        std::string path;
+        Kind kind;
+        int priority;
+        State state;
+
+        // Fetch result, consumed by the decoder
+        unsigned char* data;
+        int size;
+
+        // Decode result, consumed by the uploads
+        std::vector<Mesh> chunks;
+        Image image;
+        bool decoded;
+
+        int chunksUploaded;
+        Model model;
+        Texture2D texture;
+    };
+
+    struct FetchRequest;
+
+    std::vector<std::unique_ptr<Asset>> assets;
+    std::vector<FetchRequest*> fetches;   // web requests still waiting for a response
+    int inFlight;
+    Stats stats;
+
+#ifdef ASSETSTREAMER_THREADS
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Asset*> jobs;       // to the worker: fetch (natively) and decode
+    std::deque<Asset*> finished;   // from the worker: decoded or failed
+    bool stopping;
+
+    void workerLoop();
+#else
+    std::deque<Asset*> pendingDecodes;
+#endif
+
+    Handle request(const char* path, Kind kind, int priority);
+    void startFetches();
+    void fetchCompleted(Asset& asset, unsigned char* data, int size);
+    void finishDecode(Asset& asset);
+    bool uploadSlice(Asset& asset);
+    static void decode(Asset& asset);
+    static void releaseCPU(Asset& asset);
+
+#ifdef __EMSCRIPTEN__
+    static void onFetchLoad(unsigned requestHandle, void* arg, void* data, unsigned size);
+    static void onFetchError(unsigned requestHandle, void* arg, int status, const char* statusText);
+#endif
+
+public:
+    AssetStreamer();
+    ~AssetStreamer();
+
+    // Returns immediately; the asset loads in the background while update() is called
+    Handle requestModel(const char* path, int priority = Normal);
+    Handle requestTexture(const char* path, int priority = Normal);
+    // Reorders assets that are still queued
+    void setPriority(Handle handle, int priority);
+
+    // Render thread, once per frame: starts fetches, collects decoded assets and
+    // uploads them until budgetMs is spent (at least one slice per call)
+    void update(float budgetMs);
+
+    State getState(Handle handle) const { return assets[handle]->state; }
+    bool isReady(Handle handle) const { return assets[handle]->state == State::Ready; }
+    // Valid once ready; owned by the streamer
+    Model* getModel(Handle handle) { return isReady(handle) ? &assets[handle]->model : nullptr; }
+    Texture2D getTexture(Handle handle) const { return isReady(handle) ? assets[handle]->texture : Texture2D{}; }
+    bool isIdle() const { return stats.queued + stats.loading + stats.uploading == 0; }
+
+    // Releases GPU resources of every loaded asset, call before CloseWindow()
+    void unloadAll();
+
+    const Stats& getStats() const { return stats; }
+
+    // CPU-side OBJ parse of null-terminated text: positions, texcoords and normals,
+    // polygons fanned into triangles, split into chunks of at most MAX_CHUNK_VERTICES
+    static bool parseOBJ(const char* text, std::vector<Mesh>& chunks);
+};
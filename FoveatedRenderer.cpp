@@ -0,0 +1,102 @@
+#include "FoveatedRenderer.h"
+#include <raymath.h>
+#include <rlgl.h>
+#include <algorithm>
+
+FoveatedRenderer::FoveatedRenderer() : targets(), level(0.0f), clearColor{ 0, 0, 0, 255 } {
+}
+
+FoveatedRenderer::~FoveatedRenderer() {
+    unload();
+}
+
+void FoveatedRenderer::setLevel(float newLevel) {
+    level = std::min(1.0f, std::max(0.0f, newLevel));
+    if (level == 0.0f) unload();
+}
+
+FoveatedRenderer::Rect FoveatedRenderer::centerRect(const int viewport[4], const float projection[16]) const {
+    float fraction = 1.0f - 0.5f * level;
+    Rect rect;
+    rect.width = (int)(viewport[2] * fraction + 0.5f);
+    rect.height = (int)(viewport[3] * fraction + 0.5f);
+
+    // The view direction (0, 0, -1) projects to NDC (-m8, -m9)
+    float centerX = viewport[0] + 0.5f * viewport[2] * (1.0f - projection[8]);
+    float centerY = viewport[1] + 0.5f * viewport[3] * (1.0f - projection[9]);
+    rect.x = std::min(std::max((int)(centerX - 0.5f * rect.width), viewport[0]), viewport[0] + viewport[2] - rect.width);
+    rect.y = std::min(std::max((int)(centerY - 0.5f * rect.height), viewport[1]), viewport[1] + viewport[3] - rect.height);
+    return rect;
+}
+
+int FoveatedRenderer::beginPeriphery(int eye, const int viewport[4], const Rect& center) {
+    float scale = getPeripheryScale();
+    int width = std::max(1, (int)(viewport[2] * scale + 0.5f));
+    int height = std::max(1, (int)(viewport[3] * scale + 0.5f));
+
+    RenderTexture2D& target = targets[eye];
+    if (target.id == 0 || target.texture.width != width || target.texture.height != height) {
+        if (target.id != 0) UnloadRenderTexture(target);
+        target = LoadRenderTexture(width, height);
+        SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+    }
+
+    rlEnableFramebuffer(target.id);
+    rlViewport(0, 0, width, height);
+    rlClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
+    rlClearScreenBuffers();
+
+    // Depth 0 where the center pass will draw anyway, so scene fragments there fail
+    // the depth test. Inset one texel so filtering never reaches the unshaded area.
+    float x0 = (center.x - viewport[0]) * scale + 1.0f;
+    float y0 = (center.y - viewport[1]) * scale + 1.0f;
+    float x1 = (center.x + center.width - viewport[0]) * scale - 1.0f;
+    float y1 = (center.y + center.height - viewport[1]) * scale - 1.0f;
+    if (x1 <= x0 || y1 <= y0) return width * height;
+
+    rlSetMatrixProjection(MatrixOrtho(0.0, width, 0.0, height, 0.0, 1.0));
+    rlSetMatrixModelview(MatrixIdentity());
+    rlBegin(RL_QUADS);
+        rlColor4ub(0, 0, 0, 255);
+        rlVertex3f(x0, y0, 0.0f);
+        rlVertex3f(x1, y0, 0.0f);
+        rlVertex3f(x1, y1, 0.0f);
+        rlVertex3f(x0, y1, 0.0f);
+    rlEnd();
+    rlDrawRenderBatchActive();
+
+    int masked = (int)(x1 - x0) * (int)(y1 - y0);
+    return width * height - masked;
+}
+
+void FoveatedRenderer::composite(int eye, int width, int height) {
+    const Texture2D& texture = targets[eye].texture;
+
+    rlSetMatrixProjection(MatrixOrtho(0.0, width, height, 0.0, -1.0, 1.0));
+    rlSetMatrixModelview(MatrixIdentity());
+    rlDisableDepthTest();
+    // Render textures are stored bottom-up, hence the negative source height
+    DrawTexturePro(texture, Rectangle{ 0.0f, 0.0f, (float)texture.width, -(float)texture.height },
+                   Rectangle{ 0.0f, 0.0f, (float)width, (float)height }, Vector2{ 0.0f, 0.0f }, 0.0f, WHITE);
+    rlDrawRenderBatchActive();
+    rlEnableDepthTest();
+}
+
+int FoveatedRenderer::beginCenter(const Rect& center) {
+    rlEnableScissorTest();
+    rlScissor(center.x, center.y, center.width, center.height);
+    rlClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
+    rlClearScreenBuffers();
+    return center.width * center.height;
+}
+
+void FoveatedRenderer::endCenter() {
+    rlDisableScissorTest();
+}
+
+void FoveatedRenderer::unload() {
+    for (RenderTexture2D& target : targets) {
+        if (target.id != 0) UnloadRenderTexture(target);
+        target = {};
+    }
+}
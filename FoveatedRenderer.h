@@ -0,0 +1,54 @@
+#pragma once
+
+#include "raylib.h"
+
+// Software fixed foveation, for runtimes whose XRWebGLLayer has no fixedFoveation.
+//
+// Each eye is drawn twice: once into a smaller offscreen target that is
+// stretched over the eye viewport, then once more at full resolution,
+// scissored to a center region around the eye's optical axis. The center of
+// the offscreen target is masked with a near-plane depth quad first, so the
+// first pass only shades the periphery. Scene passes must be depth tested.
+// Both the periphery scale and the center's share of each axis go from 1 at
+// level 0 to 0.5 at level 1, where 44% of the pixels of an unfoveated eye are shaded.
+class FoveatedRenderer {
+public:
+    struct Rect {
+        int x, y, width, height;
+    };
+
+private:
+    RenderTexture2D targets[2];   // periphery per eye, reallocated when the viewport size changes
+    float level;
+    Color clearColor;
+
+public:
+    FoveatedRenderer();
+    ~FoveatedRenderer();
+
+    // 0 (off) to 1, the range of XRWebGLLayer.fixedFoveation
+    void setLevel(float newLevel);
+    float getLevel() const { return level; }
+    bool isActive() const { return level > 0.0f; }
+    // The layer's clear color, for the periphery target and the center region
+    void setClearColor(Color color) { clearColor = color; }
+
+    // Periphery target size per axis, relative to the eye viewport
+    float getPeripheryScale() const { return 1.0f - 0.5f * level; }
+    // Full-resolution region of the viewport, centered where the view direction
+    // lands (projection[8], projection[9] shift it for asymmetric eye frusta)
+    Rect centerRect(const int viewport[4], const float projection[16]) const;
+
+    // Binds and clears the eye's periphery target, viewport set to all of it,
+    // and masks the part under center. Returns the pixels left to shade.
+    int beginPeriphery(int eye, const int viewport[4], const Rect& center);
+    // Draws the periphery target over the currently bound framebuffer's viewport;
+    // the layer framebuffer must be bound again first
+    void composite(int eye, int width, int height);
+    // Clears the center region and scissors drawing to it; returns its pixels
+    int beginCenter(const Rect& center);
+    void endCenter();
+
+    // Releases the offscreen targets, call before CloseWindow()
+    void unload();
+};
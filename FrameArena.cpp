@@ -0,0 +1,79 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+FrameArena::FrameArena(size_t capacity) : buffers(), current(0), stats() {
+    capacity = std::max(capacity, (size_t)64);
+    for (Buffer& buffer : buffers) {
+        buffer.data = (unsigned char*)malloc(capacity);
+        buffer.capacity = capacity;
+    }
+    stats.capacity = capacity;
+}
+
+FrameArena::~FrameArena() {
+    for (Buffer& buffer : buffers) {
+        for (void* block : buffer.overflow) free(block);
+        free(buffer.data);
+    }
+}
+
+void FrameArena::beginFrame() {
+    const Buffer& previous = buffers[current];
+    stats.lastFrame = previous.used + previous.overflowBytes;
+
+    current ^= 1;
+    reset(buffers[current]);
+    stats.capacity = buffers[current].capacity;
+    stats.used = 0;
+}
+
+void FrameArena::reset(Buffer& buffer) {
+    for (void* block : buffer.overflow) free(block);
+    buffer.overflow.clear();
+
+    // Grow to the high-water mark, which covers a frame that overflowed either buffer
+    size_t needed = std::max(buffer.used + buffer.overflowBytes, stats.highWater);
+    if (buffer.capacity < needed) {
+        size_t capacity = buffer.capacity;
+        while (capacity < needed) capacity *= 2;
+        free(buffer.data);
+        buffer.data = (unsigned char*)malloc(capacity);
+        buffer.capacity = capacity;
+        stats.grows++;
+    }
+    buffer.used = 0;
+    buffer.overflowBytes = 0;
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment) {
+    Buffer& buffer = buffers[current];
+
+    // Aligned against the address, so alignments beyond malloc's work too
+    uintptr_t base = (uintptr_t)buffer.data;
+    uintptr_t aligned = (base + buffer.used + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    size_t offset = (size_t)(aligned - base);
+
+    void* memory;
+    if (offset + size <= buffer.capacity) {
+        buffer.used = offset + size;
+        memory = buffer.data + offset;
+    } else {
+        memory = allocateOverflow(buffer, size, alignment);
+    }
+
+    stats.used = buffer.used + buffer.overflowBytes;
+    stats.highWater = std::max(stats.highWater, stats.used);
+    return memory;
+}
+
+void* FrameArena::allocateOverflow(Buffer& buffer, size_t size, size_t alignment) {
+    unsigned char* block = (unsigned char*)malloc(size + alignment);
+    buffer.overflow.push_back(block);
+    buffer.overflowBytes += size + alignment;
+    stats.overflows++;
+
+    uintptr_t aligned = ((uintptr_t)block + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    return (void*)aligned;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Scratch memory for one frame: allocation bumps an offset into a
+// preallocated buffer, and nothing is freed individually.
+//
+// There are two buffers. beginFrame() switches to the other one and resets
+// it, so what a frame allocates stays valid through the next frame too (for
+// results the next frame compares against) and is reclaimed after that.
+// A request that does not fit is served by malloc, and each buffer grows to
+// the high-water mark at its next reset, so steady-state frames never reach
+// the heap. Only the frame thread may allocate; jobs get their scratch
+// handed out before they are queued.
+class FrameArena {
+public:
+    static const size_t DEFAULT_CAPACITY = 64 * 1024;   // per buffer, grows on demand
+
+    struct Stats {
+        size_t capacity;        // of the current buffer
+        size_t used;            // by the current frame so far, overflow included
+        size_t lastFrame;       // used by the previous frame
+        size_t highWater;       // most used by any frame since construction
+        int overflows;          // allocations that went to malloc
+        int grows;              // buffer reallocations at reset
+    };
+
+    // std::allocator-compatible adapter, e.g. std::vector<int, FrameArena::Allocator<int>>.
+    // deallocate() is a no-op, so reserve() up front to avoid leaving old copies behind.
+    template<typename T>
+    class Allocator {
+    public:
+        typedef T value_type;
+
+        explicit Allocator(FrameArena& arena) : arena(&arena) {}
+        template<typename U>
+        Allocator(const Allocator<U>& other) : arena(other.arena) {}
+
+        T* allocate(size_t count) { return (T*)arena->allocate(count * sizeof(T), alignof(T)); }
+        void deallocate(T*, size_t) {}
+
+        template<typename U>
+        bool operator==(const Allocator<U>& other) const { return arena == other.arena; }
+        template<typename U>
+        bool operator!=(const Allocator<U>& other) const { return arena != other.arena; }
+
+    private:
+        FrameArena* arena;
+        template<typename U> friend class Allocator;
+    };
+
+    template<typename T>
+    using Vector = std::vector<T, Allocator<T>>;
+
+private:
+    struct Buffer {
+        unsigned char* data;
+        size_t capacity;
+        size_t used;
+        size_t overflowBytes;
+        std::vector<void*> overflow;   // malloc blocks, freed at reset
+    };
+
+    Buffer buffers[2];
+    int current;
+    Stats stats;
+
+    void reset(Buffer& buffer);
+    void* allocateOverflow(Buffer& buffer, size_t size, size_t alignment);
+
+public:
+    explicit FrameArena(size_t capacity = DEFAULT_CAPACITY);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Start of a frame: the older buffer becomes current and is emptied
+    void beginFrame();
+
+    // Uninitialized bytes, valid until the beginFrame() after next
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    // count default-initialized objects (no constructor call for trivial types).
+    // Destructors never run, hence the trivially destructible requirement.
+    template<typename T>
+    T* allocate(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "frame arena objects are never destroyed");
+        T* objects = (T*)allocate(count * sizeof(T), alignof(T));
+        for (size_t i = 0; i < count; i++) new (&objects[i]) T;
+        return objects;
+    }
+
+    // count zeroed objects
+    template<typename T>
+    T* allocateZeroed(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "frame arena objects are never destroyed");
+        T* objects = (T*)allocate(count * sizeof(T), alignof(T));
+        for (size_t i = 0; i < count; i++) new (&objects[i]) T();
+        return objects;
+    }
+
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value, "frame arena objects are never destroyed");
+        return new (allocate(sizeof(T), alignof(T))) T(static_cast<Args&&>(args)...);
+    }
+
+    template<typename T>
+    Allocator<T> allocator() { return Allocator<T>(*this); }
+
+    const Stats& getStats() const { return stats; }
+};
@@ -0,0 +1,132 @@
+#include "FrameProfiler.h"
+#include "raylib.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+FrameProfiler::FrameProfiler() {
+    reset();
+}
+
+double FrameProfiler::now() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+const char* FrameProfiler::phaseName(Phase phase) {
+    static const char* names[PhaseCount] = {
+        "jsMarshal", "frameCallback", "leftEyeDraw", "rightEyeDraw", "stereoDraw", "batchFlush", "gestures", "assetUpload",
+        "foveationComposite", "jobWait"
+    };
+    return (phase >= 0 && phase < PhaseCount) ? names[phase] : "unknown";
+}
+
+const char* FrameProfiler::counterName(Counter counter) {
+    static const char* names[CounterCount] = { "frameArenaBytes" };
+    return (counter >= 0 && counter < CounterCount) ? names[counter] : "unknown";
+}
+
+void FrameProfiler::push(Ring& ring, float value) {
+    uint32_t head = ring.head.load(std::memory_order_relaxed);
+    ring.samples[head % HISTORY_SIZE] = value;
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+void FrameProfiler::record(Phase phase, float milliseconds) {
+    push(rings[phase], milliseconds);
+}
+
+void FrameProfiler::recordCounter(Counter counter, float value) {
+    push(counters[counter], value);
+    // One writer per counter, so no compare-exchange
+    if (value > peaks[counter].load(std::memory_order_relaxed)) peaks[counter].store(value, std::memory_order_relaxed);
+}
+
+FrameProfiler::PhaseStats FrameProfiler::getStats(Phase phase) const {
+    return ringStats(rings[phase]);
+}
+
+FrameProfiler::PhaseStats FrameProfiler::getCounterStats(Counter counter) const {
+    return ringStats(counters[counter]);
+}
+
+FrameProfiler::PhaseStats FrameProfiler::ringStats(const Ring& ring) {
+    PhaseStats stats = {};
+
+    uint32_t head = ring.head.load(std::memory_order_acquire);
+    int count = (int)std::min<uint32_t>(head, HISTORY_SIZE);
+    if (count == 0) return stats;
+
+    float sorted[HISTORY_SIZE];
+    std::copy(ring.samples, ring.samples + count, sorted);
+    std::sort(sorted, sorted + count);
+
+    float sum = 0.0f;
+    for (int i = 0; i < count; i++) sum += sorted[i];
+
+    auto percentile = [&](float p) { return sorted[std::min(count - 1, (int)(p * count))]; };
+
+    stats.count = count;
+    stats.mean = sum / count;
+    stats.p50 = percentile(0.50f);
+    stats.p95 = percentile(0.95f);
+    stats.p99 = percentile(0.99f);
+    stats.max = sorted[count - 1];
+    return stats;
+}
+
+void FrameProfiler::reset() {
+    for (Ring& ring : rings) {
+        ring.head.store(0, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < CounterCount; i++) {
+        counters[i].head.store(0, std::memory_order_relaxed);
+        peaks[i].store(0.0f, std::memory_order_relaxed);
+    }
+}
+
+std::string FrameProfiler::toJson() const {
+    std::string json = "{";
+    char entry[192];
+
+    for (int i = 0; i < PhaseCount; i++) {
+        PhaseStats s = getStats((Phase)i);
+        snprintf(entry, sizeof(entry),
+                 "%s\"%s\":{\"count\":%d,\"mean\":%.4f,\"p50\":%.4f,\"p95\":%.4f,\"p99\":%.4f,\"max\":%.4f}",
+                 i > 0 ? "," : "", phaseName((Phase)i), s.count, s.mean, s.p50, s.p95, s.p99, s.max);
+        json += entry;
+    }
+    for (int i = 0; i < CounterCount; i++) {
+        PhaseStats s = getCounterStats((Counter)i);
+        snprintf(entry, sizeof(entry),
+                 ",\"%s\":{\"count\":%d,\"mean\":%.0f,\"p50\":%.0f,\"p95\":%.0f,\"max\":%.0f,\"peak\":%.0f}",
+                 counterName((Counter)i), s.count, s.mean, s.p50, s.p95, s.max, getCounterPeak((Counter)i));
+        json += entry;
+    }
+
+    json += "}";
+    return json;
+}
+
+void FrameProfiler::drawOverlay(int x, int y, int fontSize) const {
+    DrawText("phase            p50     p95     p99  (ms)", x, y, fontSize, DARKGRAY);
+
+    for (int i = 0; i < PhaseCount; i++) {
+        PhaseStats s = getStats((Phase)i);
+        if (s.count == 0) continue;
+
+        y += fontSize + 2;
+        DrawText(TextFormat("%-14s %7.3f %7.3f %7.3f", phaseName((Phase)i), s.p50, s.p95, s.p99),
+                 x, y, fontSize, DARKGRAY);
+    }
+
+    for (int i = 0; i < CounterCount; i++) {
+        PhaseStats s = getCounterStats((Counter)i);
+        if (s.count == 0) continue;
+
+        y += fontSize + 2;
+        DrawText(TextFormat("%-14s %7.1f %7.1f %7.1f  (KB p50, p95, peak)", counterName((Counter)i),
+                            s.p50 / 1024.0f, s.p95 / 1024.0f, getCounterPeak((Counter)i) / 1024.0f),
+                 x, y, fontSize, DARKGRAY);
+    }
+}
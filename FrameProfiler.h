@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Per-phase frame timings kept in fixed-size ring buffers. Recording is one
+// store plus one atomic increment, so it is safe to leave enabled in release
+// builds; percentiles are only computed when stats are requested.
+class FrameProfiler {
+public:
+    enum Phase {
+        JsMarshal,      // onFrame writing views/hands/input into the heap (measured in JS)
+        FrameCallback,  // whole C++ frame callback
+        LeftEyeDraw,    // scene recording for the left eye (multi-pass)
+        RightEyeDraw,   // scene recording for the right eye (multi-pass)
+        StereoDraw,     // scene recording for both eyes (single-pass)
+        BatchFlush,     // rlDrawRenderBatchActive
+        Gestures,       // hand gesture classification before the frame handler
+        AssetUpload,    // AssetStreamer::update: collecting decoded assets and GPU upload slices
+        FoveationComposite, // stretching the low-resolution periphery over an eye viewport
+        JobWait,        // frame thread joining the frame jobs before draw submission
+        PhaseCount
+    };
+
+    // Per-frame quantities other than time, kept in the same rings
+    enum Counter {
+        FrameArenaBytes,    // VRHandler frame arena bytes used by one frame callback
+        CounterCount
+    };
+
+    static const int HISTORY_SIZE = 512;
+
+    struct PhaseStats {
+        int count;
+        float mean;
+        float p50;
+        float p95;
+        float p99;
+        float max;
+    };
+
+    // RAII timer recording the scope duration into a phase
+    class Scope {
+    public:
+        Scope(FrameProfiler& profiler, Phase phase) : profiler(profiler), phase(phase), start(now()) {}
+        ~Scope() { profiler.record(phase, (float)(now() - start)); }
+
+    private:
+        FrameProfiler& profiler;
+        Phase phase;
+        double start;
+    };
+
+private:
+    struct Ring {
+        float samples[HISTORY_SIZE];
+        std::atomic<uint32_t> head;
+    };
+
+    Ring rings[PhaseCount];
+    Ring counters[CounterCount];
+    std::atomic<float> peaks[CounterCount];   // high-water marks since reset, beyond the history
+
+    static PhaseStats ringStats(const Ring& ring);
+    static void push(Ring& ring, float value);
+
+public:
+    FrameProfiler();
+
+    // Monotonic time in milliseconds
+    static double now();
+    static const char* phaseName(Phase phase);
+    static const char* counterName(Counter counter);
+
+    void record(Phase phase, float milliseconds);
+    PhaseStats getStats(Phase phase) const;
+    void recordCounter(Counter counter, float value);
+    PhaseStats getCounterStats(Counter counter) const;
+    float getCounterPeak(Counter counter) const { return peaks[counter].load(std::memory_order_relaxed); }
+    void reset();
+
+    std::string toJson() const;
+    void drawOverlay(int x, int y, int fontSize) const;
+};
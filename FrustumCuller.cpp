@@ -0,0 +1,354 @@
+#include "FrustumCuller.h"
+#include "VRMath.h"
+#include <raymath.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+    const float COMBINE_EPSILON = 1e-4f;
+
+    bool nearlyEqual(float a, float b) {
+        return fabsf(a - b) <= COMBINE_EPSILON * std::max(1.0f, std::max(fabsf(a), fabsf(b)));
+    }
+
+    // Half-angle tangents of a GL-style WebXR projection (column-major)
+    float tanLeft(const float* p) { return (1.0f - p[8]) / p[0]; }
+    float tanRight(const float* p) { return (1.0f + p[8]) / p[0]; }
+}
+
+void Frustum::setPlane(int plane, float x, float y, float z, float w) {
+    float length = sqrtf(x * x + y * y + z * z);
+    float scale = length > 0.0f ? 1.0f / length : 0.0f;
+
+    nx[plane] = x * scale;
+    ny[plane] = y * scale;
+    nz[plane] = z * scale;
+    d[plane] = w * scale;
+    ax[plane] = fabsf(nx[plane]);
+    ay[plane] = fabsf(ny[plane]);
+    az[plane] = fabsf(nz[plane]);
+}
+
+void Frustum::copyPlane(int plane, const Frustum& from) {
+    nx[plane] = from.nx[plane];
+    ny[plane] = from.ny[plane];
+    nz[plane] = from.nz[plane];
+    d[plane] = from.d[plane];
+    ax[plane] = from.ax[plane];
+    ay[plane] = from.ay[plane];
+    az[plane] = from.az[plane];
+}
+
+Frustum Frustum::fromViewProjection(Matrix m) {
+    // Clip-space rows of projection * view; a point is inside when -w <= x, y, z <= w
+    Frustum frustum;
+    frustum.setPlane(Left, m.m3 + m.m0, m.m7 + m.m4, m.m11 + m.m8, m.m15 + m.m12);
+    frustum.setPlane(Right, m.m3 - m.m0, m.m7 - m.m4, m.m11 - m.m8, m.m15 - m.m12);
+    frustum.setPlane(Bottom, m.m3 + m.m1, m.m7 + m.m5, m.m11 + m.m9, m.m15 + m.m13);
+    frustum.setPlane(Top, m.m3 - m.m1, m.m7 - m.m5, m.m11 - m.m9, m.m15 - m.m13);
+    frustum.setPlane(Near, m.m3 + m.m2, m.m7 + m.m6, m.m11 + m.m10, m.m15 + m.m14);
+    frustum.setPlane(Far, m.m3 - m.m2, m.m7 - m.m6, m.m11 - m.m10, m.m15 - m.m14);
+
+    for (int padding = Far + 1; padding < PLANE_LANES; padding++) {
+        frustum.nx[padding] = frustum.ny[padding] = frustum.nz[padding] = 0.0f;
+        frustum.ax[padding] = frustum.ay[padding] = frustum.az[padding] = 0.0f;
+        frustum.d[padding] = 1.0f;
+    }
+    return frustum;
+}
+
+Frustum Frustum::fromView(const WebXRView& view) {
+    Matrix projection = VRMath::fromWebXR(view.projectionMatrix);
+    Matrix modelview = VRMath::rigidInverseFromWebXR(view.viewMatrix);
+    return fromViewProjection(MatrixMultiply(modelview, projection));
+}
+
+FrustumCuller::FrustumCuller() : dirty(false), stats(), jobs(nullptr), subtreeJobCount(0) {
+}
+
+int FrustumCuller::add(BoundingBox bounds) {
+    Bounds b;
+    b.center[0] = (bounds.min.x + bounds.max.x) * 0.5f;
+    b.center[1] = (bounds.min.y + bounds.max.y) * 0.5f;
+    b.center[2] = (bounds.min.z + bounds.max.z) * 0.5f;
+    b.extent[0] = (bounds.max.x - bounds.min.x) * 0.5f;
+    b.extent[1] = (bounds.max.y - bounds.min.y) * 0.5f;
+    b.extent[2] = (bounds.max.z - bounds.min.z) * 0.5f;
+
+    objects.push_back(b);
+    visibleFlags.push_back(0);
+    dirty = true;
+    return (int)objects.size() - 1;
+}
+
+void FrustumCuller::clear() {
+    objects.clear();
+    order.clear();
+    nodes.clear();
+    visible.clear();
+    visibleFlags.clear();
+    dirty = false;
+    stats = {};
+}
+
+FrustumCuller::Bounds FrustumCuller::merge(const Bounds* bounds, const int* ids, int count) {
+    float lo[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float hi[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (int i = 0; i < count; i++) {
+        const Bounds& b = bounds[ids[i]];
+        for (int k = 0; k < 3; k++) {
+            lo[k] = std::min(lo[k], b.center[k] - b.extent[k]);
+            hi[k] = std::max(hi[k], b.center[k] + b.extent[k]);
+        }
+    }
+
+    Bounds result;
+    for (int k = 0; k < 3; k++) {
+        result.center[k] = (lo[k] + hi[k]) * 0.5f;
+        result.extent[k] = (hi[k] - lo[k]) * 0.5f;
+    }
+    return result;
+}
+
+int FrustumCuller::buildNode(int first, int count) {
+    int index = (int)nodes.size();
+    nodes.push_back({ merge(objects.data(), order.data() + first, count), first, count, -1 });
+    if (count <= LEAF_SIZE) return index;
+
+    // Median split on the longest axis of the object centers
+    float lo[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float hi[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (int i = first; i < first + count; i++) {
+        const float* c = objects[order[i]].center;
+        for (int k = 0; k < 3; k++) {
+            lo[k] = std::min(lo[k], c[k]);
+            hi[k] = std::max(hi[k], c[k]);
+        }
+    }
+    int axis = 0;
+    for (int k = 1; k < 3; k++) {
+        if (hi[k] - lo[k] > hi[axis] - lo[axis]) axis = k;
+    }
+
+    int half = count / 2;
+    const std::vector<Bounds>& bounds = objects;
+    std::nth_element(order.begin() + first, order.begin() + first + half, order.begin() + first + count,
+                     [&bounds, axis](int a, int b) { return bounds[a].center[axis] < bounds[b].center[axis]; });
+
+    buildNode(first, half);
+    int right = buildNode(first + half, count - half);
+    nodes[index].right = right;
+    return index;
+}
+
+void FrustumCuller::rebuild() {
+    int count = (int)objects.size();
+    order.resize(count);
+    for (int i = 0; i < count; i++) order[i] = i;
+
+    nodes.clear();
+    nodes.reserve(std::max(1, 4 * count / LEAF_SIZE));
+    visible.reserve(count);
+    if (count > 0) buildNode(0, count);
+    dirty = false;
+}
+
+FrustumCuller::Containment FrustumCuller::test(const Frustum& frustum, const Bounds& bounds) {
+    using VRMath::Vec4;
+    using VRMath::load;
+    using VRMath::mul;
+    using VRMath::splat;
+
+    Vec4 cx = splat(bounds.center[0]), cy = splat(bounds.center[1]), cz = splat(bounds.center[2]);
+    Vec4 ex = splat(bounds.extent[0]), ey = splat(bounds.extent[1]), ez = splat(bounds.extent[2]);
+    bool intersecting = false;
+
+    // Per plane: signed distance of the center and the box's projected radius
+    for (int lane = 0; lane < Frustum::PLANE_LANES; lane += 4) {
+        Vec4 distance = VRMath::add(VRMath::add(mul(load(frustum.nx + lane), cx), mul(load(frustum.ny + lane), cy)),
+                                    VRMath::add(mul(load(frustum.nz + lane), cz), load(frustum.d + lane)));
+        Vec4 radius = VRMath::add(VRMath::add(mul(load(frustum.ax + lane), ex), mul(load(frustum.ay + lane), ey)),
+                                  mul(load(frustum.az + lane), ez));
+
+        if (VRMath::signMask(VRMath::add(distance, radius))) return Outside;
+        if (VRMath::signMask(VRMath::sub(distance, radius))) intersecting = true;
+    }
+    return intersecting ? Intersecting : Inside;
+}
+
+FrustumCuller::Containment FrustumCuller::test(const Frustum* frusta, int frustumCount, const Bounds& bounds) {
+    // Union of the frusta: inside any is inside, outside all is outside
+    Containment result = Outside;
+    for (int i = 0; i < frustumCount; i++) {
+        Containment c = test(frusta[i], bounds);
+        if (c == Inside) return Inside;
+        if (c == Intersecting) result = Intersecting;
+    }
+    return result;
+}
+
+void FrustumCuller::traverse(const Frustum* frusta, int frustumCount) {
+    for (int id : visible) visibleFlags[id] = 0;
+    visible.clear();
+
+    if (!nodes.empty()) {
+        // About four subtree jobs per worker: nodes at depth d are at most 2^d
+        int splitDepth = -1;
+        if (jobs && jobs->getWorkerCount() > 1 && (int)objects.size() >= PARALLEL_MIN_OBJECTS) {
+            splitDepth = 1;
+            while ((1 << splitDepth) < 4 * jobs->getWorkerCount()) splitDepth++;
+            if ((int)subtreeJobs.size() < (1 << splitDepth)) subtreeJobs.resize(1 << splitDepth);
+        }
+        subtreeJobCount = 0;
+
+        traverseSubtree(0, frusta, frustumCount, splitDepth, visible, stats.nodesTested, stats.objectsTested);
+
+        if (subtreeJobCount > 0) {
+            jobs->wait(subtreeGroup);
+            spliced.clear();
+            for (int id : visible) {
+                if (id >= 0) {
+                    spliced.push_back(id);
+                    continue;
+                }
+                const SubtreeJob& job = subtreeJobs[-1 - id];
+                spliced.insert(spliced.end(), job.visible.begin(), job.visible.end());
+                stats.nodesTested += job.nodesTested;
+                stats.objectsTested += job.objectsTested;
+            }
+            visible.swap(spliced);
+        }
+    }
+
+    for (int id : visible) visibleFlags[id] = 1;
+    stats.objects = (int)objects.size();
+    stats.objectsVisible = (int)visible.size();
+    stats.objectsCulled = stats.objects - stats.objectsVisible;
+}
+
+void FrustumCuller::traverseSubtree(int root, const Frustum* frusta, int frustumCount, int splitDepth,
+                                    std::vector<int>& out, int& nodesTested, int& objectsTested) {
+    int stack[MAX_DEPTH];
+    int depths[MAX_DEPTH];
+    int top = 0;
+    stack[top] = root;
+    depths[top++] = 0;
+
+    while (top > 0) {
+        top--;
+        int index = stack[top];
+        int depth = depths[top];
+        const Node& node = nodes[index];
+        nodesTested++;
+
+        Containment c = test(frusta, frustumCount, node.bounds);
+        if (c == Outside) continue;
+
+        if (c == Inside) {
+            out.insert(out.end(), order.begin() + node.first, order.begin() + node.first + node.count);
+        } else if (node.right < 0) {
+            for (int i = node.first; i < node.first + node.count; i++) {
+                objectsTested++;
+                if (test(frusta, frustumCount, objects[order[i]]) != Outside) out.push_back(order[i]);
+            }
+        } else if (depth == splitDepth) {
+            SubtreeJob& job = subtreeJobs[subtreeJobCount];
+            job.culler = this;
+            job.frusta = frusta;
+            job.frustumCount = frustumCount;
+            job.root = index;
+            out.push_back(-1 - subtreeJobCount);
+            subtreeJobCount++;
+            jobs->run(subtreeGroup, subtreeJob, &job);
+        } else {
+            stack[top] = node.right;
+            depths[top++] = depth + 1;
+            stack[top] = index + 1;
+            depths[top++] = depth + 1;
+        }
+    }
+}
+
+void FrustumCuller::subtreeJob(void* data) {
+    SubtreeJob& job = *(SubtreeJob*)data;
+    job.visible.clear();
+    job.nodesTested = 0;
+    job.objectsTested = 0;
+    job.culler->traverseSubtree(job.root, job.frusta, job.frustumCount, -1, job.visible, job.nodesTested, job.objectsTested);
+}
+
+const std::vector<int>& FrustumCuller::cull(const WebXRView views[2]) {
+    if (dirty) rebuild();
+    stats = {};
+
+    Frustum frusta[2];
+    stats.combined = combineViews(views, &frusta[0]);
+    if (!stats.combined) {
+        frusta[0] = Frustum::fromView(views[0]);
+        frusta[1] = Frustum::fromView(views[1]);
+    }
+    traverse(frusta, stats.combined ? 1 : 2);
+    return visible;
+}
+
+const std::vector<int>& FrustumCuller::cull(Matrix viewProjection) {
+    if (dirty) rebuild();
+    stats = {};
+
+    Frustum frustum = Frustum::fromViewProjection(viewProjection);
+    stats.combined = true;
+    traverse(&frustum, 1);
+    return visible;
+}
+
+bool FrustumCuller::combineViews(const WebXRView views[2], Frustum* combined) {
+    const float* left = views[0].viewMatrix;
+    const float* right = views[1].viewMatrix;
+    const float* leftProjection = views[0].projectionMatrix;
+    const float* rightProjection = views[1].projectionMatrix;
+
+    // Same orientation (columns 0-2 are the camera axes in world space)
+    for (int column = 0; column < 3; column++) {
+        for (int row = 0; row < 3; row++) {
+            if (!nearlyEqual(left[column * 4 + row], right[column * 4 + row])) return false;
+        }
+    }
+
+    // Same vertical field of view and depth range, no skew
+    const int shared[] = { 1, 5, 9, 10, 14 };
+    for (int index : shared) {
+        if (!nearlyEqual(leftProjection[index], rightProjection[index])) return false;
+    }
+
+    // Right eye offset along the shared x axis only
+    float offset[3] = { right[12] - left[12], right[13] - left[13], right[14] - left[14] };
+    float along[3];
+    for (int axis = 0; axis < 3; axis++) {
+        along[axis] = offset[0] * left[axis * 4] + offset[1] * left[axis * 4 + 1] + offset[2] * left[axis * 4 + 2];
+    }
+    if (along[0] < 0.0f || fabsf(along[1]) > COMBINE_EPSILON || fabsf(along[2]) > COMBINE_EPSILON) return false;
+
+    // Each outer plane must enclose the other eye's frustum on its side
+    if (tanLeft(leftProjection) + COMBINE_EPSILON < tanLeft(rightProjection)) return false;
+    if (tanRight(rightProjection) + COMBINE_EPSILON < tanRight(leftProjection)) return false;
+
+    *combined = Frustum::fromView(views[0]);
+    combined->copyPlane(Frustum::Right, Frustum::fromView(views[1]));
+    return true;
+}
+
+BoundingBox FrustumCuller::transformBounds(BoundingBox bounds, Matrix transform) {
+    BoundingBox result = { { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+    for (int i = 0; i < 8; i++) {
+        Vector3 corner = {
+            (i & 1) ? bounds.max.x : bounds.min.x,
+            (i & 2) ? bounds.max.y : bounds.min.y,
+            (i & 4) ? bounds.max.z : bounds.min.z
+        };
+        corner = Vector3Transform(corner, transform);
+        result.min = Vector3Min(result.min, corner);
+        result.max = Vector3Max(result.max, corner);
+    }
+    return result;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "raylib.h"
+#include "JobSystem.h"
+#include <webxr.h>
+#include <vector>
+
+// View frustum as six planes (n . p + d >= 0 inside), stored as structure of
+// arrays in two groups of four so a box is tested against four planes at once.
+// Lanes 6 and 7 are padding that never rejects anything.
+struct Frustum {
+    static const int PLANE_LANES = 8;
+
+    float nx[PLANE_LANES], ny[PLANE_LANES], nz[PLANE_LANES], d[PLANE_LANES];
+    float ax[PLANE_LANES], ay[PLANE_LANES], az[PLANE_LANES];   // |n|, for the box extent term
+
+    enum Plane { Left, Right, Bottom, Top, Near, Far };
+
+    // Planes of the raylib matrix view * projection (MatrixMultiply(view, projection))
+    static Frustum fromViewProjection(Matrix viewProjection);
+    // Planes of one WebXR eye
+    static Frustum fromView(const WebXRView& view);
+
+    void setPlane(int plane, float x, float y, float z, float w);
+    void copyPlane(int plane, const Frustum& from);
+};
+
+// Culls static object bounds against the eye frusta through a bounding volume
+// hierarchy, once per frame for both eyes.
+//
+// When the eyes share orientation, vertical field of view and depth range
+// and sit side by side (every current headset), the union of the two eye
+// frusta is covered by one frustum: the left eye's left plane, the right
+// eye's right plane and the shared top, bottom, near and far planes. Other
+// layouts fall back to testing both eye frusta during the same traversal.
+//
+// With a job system, large hierarchies are culled in parallel: the top of the
+// tree is traversed on the calling thread, and the subtrees below it that
+// still need descending become jobs. Their results are spliced back in
+// hierarchy order, so the visible list is the same as a serial cull's.
+class FrustumCuller {
+public:
+    struct Stats {
+        int objects;          // registered objects
+        int nodesTested;      // BVH node boxes tested against the frustum
+        int objectsTested;    // object boxes tested in partially visible leaves
+        int objectsCulled;
+        int objectsVisible;
+        bool combined;        // one stereo frustum (true) or both eye frusta (false)
+    };
+
+private:
+    static const int LEAF_SIZE = 4;
+    static const int MAX_DEPTH = 64;
+    // Fewer objects are culled serially; a subtree job has to outweigh its scheduling
+    static const int PARALLEL_MIN_OBJECTS = 1024;
+
+    struct Bounds {
+        float center[3];
+        float extent[3];
+    };
+
+    struct Node {
+        Bounds bounds;
+        int first;     // into order; a node covers order[first .. first + count)
+        int count;
+        int right;     // child index, left child is the next node; -1 for leaves
+    };
+
+    enum Containment { Outside, Intersecting, Inside };
+
+    struct SubtreeJob {
+        FrustumCuller* culler;
+        const Frustum* frusta;
+        int frustumCount;
+        int root;
+        std::vector<int> visible;
+        int nodesTested;
+        int objectsTested;
+    };
+
+    std::vector<Bounds> objects;
+    std::vector<int> order;        // object ids in BVH leaf order
+    std::vector<Node> nodes;
+    std::vector<int> visible;
+    std::vector<unsigned char> visibleFlags;
+    bool dirty;
+    Stats stats;
+
+    JobSystem* jobs;
+    JobSystem::Group subtreeGroup;
+    std::vector<SubtreeJob> subtreeJobs;   // sized before the traversal, so jobs can point into it
+    int subtreeJobCount;
+    std::vector<int> spliced;
+
+    int buildNode(int first, int count);
+    void rebuild();
+    void traverse(const Frustum* frusta, int frustumCount);
+    // Appends the objects under root that are not outside the frusta. Internal nodes
+    // at splitDepth (-1: none) that need descending are queued as subtree jobs and
+    // stand in the output as -1 - job index.
+    void traverseSubtree(int root, const Frustum* frusta, int frustumCount, int splitDepth,
+                         std::vector<int>& out, int& nodesTested, int& objectsTested);
+    static void subtreeJob(void* data);
+    static Containment test(const Frustum& frustum, const Bounds& bounds);
+    static Containment test(const Frustum* frusta, int frustumCount, const Bounds& bounds);
+    static Bounds merge(const Bounds* bounds, const int* ids, int count);
+
+public:
+    FrustumCuller();
+
+    // Returns the object id, which indexes isVisible(); the hierarchy is rebuilt on the next cull
+    int add(BoundingBox bounds);
+    void clear();
+
+    // Culls of PARALLEL_MIN_OBJECTS objects or more fan out over jobSystem; nullptr culls serially
+    void setJobSystem(JobSystem* jobSystem) { jobs = jobSystem; }
+
+    // Stereo cull for this frame's views
+    const std::vector<int>& cull(const WebXRView views[2]);
+    // Mono cull, e.g. for the desktop preview camera
+    const std::vector<int>& cull(Matrix viewProjection);
+
+    // Combined stereo frustum for the two eyes; false when one frustum cannot cover both
+    static bool combineViews(const WebXRView views[2], Frustum* combined);
+    // World bounds of a box under a transform (conservative, from the eight corners)
+    static BoundingBox transformBounds(BoundingBox bounds, Matrix transform);
+
+    // Ids of the objects that survived the last cull, in hierarchy order
+    const std::vector<int>& getVisible() const { return visible; }
+    bool isVisible(int id) const { return visibleFlags[id] != 0; }
+    const Stats& getStats() const { return stats; }
+};
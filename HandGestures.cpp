@@ -0,0 +1,156 @@
+#include "HandGestures.h"
+#include "VRMath.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    // Enter/exit pairs; the gap between them is the hysteresis band
+    const float PINCH_ENTER = 0.020f;        // m, thumb tip to index tip
+    const float PINCH_EXIT = 0.035f;
+    const float GRAB_ENTER = 0.55f;          // most extended of the four fingers
+    const float GRAB_EXIT = 0.70f;
+    const float POINT_INDEX_ENTER = 0.85f;   // index extension
+    const float POINT_INDEX_EXIT = 0.75f;
+    const float POINT_CURLED_ENTER = 0.60f;  // most extended of middle, ring, pinky
+    const float POINT_CURLED_EXIT = 0.70f;
+    const float PALM_ENTER = 0.60f;          // cosine between palm normal and the direction to the head
+    const float PALM_EXIT = 0.40f;
+
+    const int FINGER_BASE = WEBXR_HAND_JOINT_INDEX_FINGER_METACARPAL;
+    const int FINGER_STRIDE = WEBXR_HAND_JOINT_MIDDLE_FINGER_METACARPAL - WEBXR_HAND_JOINT_INDEX_FINGER_METACARPAL;
+    const int FINGER_TIP = WEBXR_HAND_JOINT_INDEX_FINGER_TIP - WEBXR_HAND_JOINT_INDEX_FINGER_METACARPAL;
+
+    float clamp01(float value) {
+        return std::min(1.0f, std::max(0.0f, value));
+    }
+
+    // Four consecutive joints of each coordinate array, as lanes
+    struct Lanes {
+        VRMath::Vec4 x, y, z;
+    };
+
+    Lanes loadLanes(const WebXRHandJointsSoA& joints, int first) {
+        return { VRMath::load(joints.x + first), VRMath::load(joints.y + first), VRMath::load(joints.z + first) };
+    }
+
+    Lanes gatherLanes(const WebXRHandJointsSoA& joints, const int index[4]) {
+        return {
+            VRMath::set(joints.x[index[0]], joints.x[index[1]], joints.x[index[2]], joints.x[index[3]]),
+            VRMath::set(joints.y[index[0]], joints.y[index[1]], joints.y[index[2]], joints.y[index[3]]),
+            VRMath::set(joints.z[index[0]], joints.z[index[1]], joints.z[index[2]], joints.z[index[3]])
+        };
+    }
+
+    VRMath::Vec4 distance(const Lanes& a, const Lanes& b) {
+        return VRMath::length3(VRMath::sub(a.x, b.x), VRMath::sub(a.y, b.y), VRMath::sub(a.z, b.z));
+    }
+}
+
+HandGestures::HandGestures() {
+    reset();
+}
+
+void HandGestures::reset() {
+    memset(hands, 0, sizeof(hands));
+    eventCount = 0;
+}
+
+const char* HandGestures::gestureName(Gesture gesture) {
+    static const char* names[GestureCount] = { "pinch", "grab", "point", "palmFacing" };
+    return (gesture >= 0 && gesture < GestureCount) ? names[gesture] : "unknown";
+}
+
+void HandGestures::transition(int hand, Gesture gesture, bool active) {
+    HandState& state = hands[hand];
+    if (state.active[gesture] == active) return;
+
+    state.active[gesture] = active;
+    events[eventCount++] = { hand, gesture, active, state.strength[gesture] };
+}
+
+void HandGestures::measure(const WebXRHandJointsSoA& joints, int hand, const float headPosition[3]) {
+    HandState& state = hands[hand];
+    const int o = hand * WEBXR_HAND_JOINT_COUNT;
+
+    // Lane j of segments[f] is the length of segment j of finger f (metacarpal to tip);
+    // transposed, lane f of each row belongs to finger f and the rows sum to its chain length
+    VRMath::Vec4 segments[4];
+    int bases[4], tips[4];
+    for (int finger = 0; finger < 4; finger++) {
+        bases[finger] = o + FINGER_BASE + finger * FINGER_STRIDE;
+        tips[finger] = bases[finger] + FINGER_TIP;
+        segments[finger] = distance(loadLanes(joints, bases[finger] + 1), loadLanes(joints, bases[finger]));
+    }
+    VRMath::transpose(segments[0], segments[1], segments[2], segments[3]);
+    VRMath::Vec4 chain = VRMath::add(VRMath::add(segments[0], segments[1]), VRMath::add(segments[2], segments[3]));
+
+    Lanes tipLanes = gatherLanes(joints, tips);
+    VRMath::Vec4 chord = distance(tipLanes, gatherLanes(joints, bases));
+
+    const int thumb = o + WEBXR_HAND_JOINT_THUMB_TIP;
+    Lanes thumbLanes = {
+        VRMath::set(joints.x[thumb], joints.x[thumb], joints.x[thumb], joints.x[thumb]),
+        VRMath::set(joints.y[thumb], joints.y[thumb], joints.y[thumb], joints.y[thumb]),
+        VRMath::set(joints.z[thumb], joints.z[thumb], joints.z[thumb], joints.z[thumb])
+    };
+
+    float thumbToTips[4];
+    VRMath::store(state.extension, VRMath::div(chord, VRMath::add(chain, VRMath::set(1e-6f, 1e-6f, 1e-6f, 1e-6f))));
+    VRMath::store(thumbToTips, distance(thumbLanes, tipLanes));
+    state.pinchDistance = thumbToTips[0];
+
+    const float* extension = state.extension;
+    float curledMax = std::max(extension[1], std::max(extension[2], extension[3]));
+    float fingersMax = std::max(extension[0], curledMax);
+
+    // Palm normal from the wrist and the index/pinky metacarpals; the cross
+    // product points out of the back of the left hand, so flip it there
+    const int wrist = o + WEBXR_HAND_JOINT_WRIST;
+    const int index = bases[0], pinky = bases[3];
+    float a[3] = { joints.x[index] - joints.x[wrist], joints.y[index] - joints.y[wrist], joints.z[index] - joints.z[wrist] };
+    float b[3] = { joints.x[pinky] - joints.x[wrist], joints.y[pinky] - joints.y[wrist], joints.z[pinky] - joints.z[wrist] };
+    float normal[3] = { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+    float toHead[3] = { headPosition[0] - joints.x[wrist], headPosition[1] - joints.y[wrist], headPosition[2] - joints.z[wrist] };
+    float side = hand == 0 ? -1.0f : 1.0f;
+    float lengths = sqrtf((normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]) *
+                          (toHead[0] * toHead[0] + toHead[1] * toHead[1] + toHead[2] * toHead[2]));
+    float facing = lengths > 0.0f ? side * (normal[0] * toHead[0] + normal[1] * toHead[1] + normal[2] * toHead[2]) / lengths : 0.0f;
+
+    state.strength[Pinch] = clamp01((0.05f - state.pinchDistance) / 0.04f);
+    state.strength[Grab] = clamp01((1.0f - fingersMax) / 0.6f);
+    state.strength[Point] = clamp01((extension[0] - curledMax) / 0.5f);
+    state.strength[PalmFacing] = clamp01(facing);
+
+    bool pinch = state.active[Pinch] ? state.pinchDistance < PINCH_EXIT : state.pinchDistance < PINCH_ENTER;
+    bool grab = state.active[Grab] ? fingersMax < GRAB_EXIT : fingersMax < GRAB_ENTER;
+    bool point = state.active[Point]
+        ? extension[0] > POINT_INDEX_EXIT && curledMax < POINT_CURLED_EXIT
+        : extension[0] > POINT_INDEX_ENTER && curledMax < POINT_CURLED_ENTER;
+    bool palm = state.active[PalmFacing] ? facing > PALM_EXIT : facing > PALM_ENTER;
+
+    transition(hand, Pinch, pinch);
+    transition(hand, Grab, grab);
+    transition(hand, Point, point);
+    transition(hand, PalmFacing, palm);
+}
+
+void HandGestures::update(const WebXRHandJointsSoA& joints, const float headPosition[3]) {
+    eventCount = 0;
+
+    for (int hand = 0; hand < 2; hand++) {
+        HandState& state = hands[hand];
+        state.detected = joints.detected[hand] != 0;
+
+        if (state.detected) {
+            measure(joints, hand, headPosition);
+            continue;
+        }
+
+        // A lost hand ends whatever it was doing
+        for (int g = 0; g < GestureCount; g++) {
+            state.strength[g] = 0.0f;
+            transition(hand, (Gesture)g, false);
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <webxr.h>
+
+// Pinch, grab, point and palm-facing recognition for both tracked hands.
+//
+// Works on the structure-of-arrays joint gather, so the finger measurements
+// (segment lengths, tip-to-base chords, thumb-to-tip distances) are computed
+// four fingers at a time with the VRMath vector ops. Every gesture has
+// separate enter and exit thresholds so noisy tracking near a threshold does
+// not toggle it every frame; transitions are reported as events.
+class HandGestures {
+public:
+    enum Gesture {
+        Pinch,        // thumb tip on the index tip
+        Grab,         // all four fingers curled
+        Point,        // index extended, the other fingers curled
+        PalmFacing,   // palm turned towards the head
+        GestureCount
+    };
+
+    static const int MAX_EVENTS = 2 * GestureCount;
+
+    struct Event {
+        int hand;         // 0 left, 1 right
+        Gesture gesture;
+        bool active;      // started (true) or ended (false)
+        float strength;
+    };
+
+    struct HandState {
+        bool detected;
+        bool active[GestureCount];
+        float strength[GestureCount];   // 0..1, also tracked while inactive
+        float extension[4];             // index..pinky, tip-to-base distance over chain length (1 straight)
+        float pinchDistance;            // thumb tip to index tip, meters
+    };
+
+private:
+    HandState hands[2];
+    Event events[MAX_EVENTS];
+    int eventCount;
+
+    void measure(const WebXRHandJointsSoA& joints, int hand, const float headPosition[3]);
+    void transition(int hand, Gesture gesture, bool active);
+
+public:
+    HandGestures();
+
+    // Classifies this frame's joints; headPosition is the viewer position in
+    // the same reference space. Replaces the previous frame's events.
+    void update(const WebXRHandJointsSoA& joints, const float headPosition[3]);
+    // Ends every active gesture without reporting it (new session)
+    void reset();
+
+    bool isActive(int hand, Gesture gesture) const { return hands[hand].active[gesture]; }
+    float getStrength(int hand, Gesture gesture) const { return hands[hand].strength[gesture]; }
+    const HandState& getHand(int hand) const { return hands[hand]; }
+
+    int getEventCount() const { return eventCount; }
+    const Event& getEvent(int index) const { return events[index]; }
+
+    static const char* gestureName(Gesture gesture);
+};
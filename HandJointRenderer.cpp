@@ -0,0 +1,184 @@
+#include "HandJointRenderer.h"
+#include <raymath.h>
+#include <rlgl.h>
+
+#if defined(PLATFORM_WEB)
+static const char* jointVertexShader =
+    "#version 100\n"
+    "attribute vec3 vertexPosition;\n"
+    "attribute vec4 instanceSphere;\n"
+    "attribute vec4 instanceColor;\n"
+    "uniform mat4 mvp;\n"
+    "varying vec4 fragColor;\n"
+    "void main() {\n"
+    "    fragColor = instanceColor;\n"
+    "    gl_Position = mvp*vec4(vertexPosition*instanceSphere.w + instanceSphere.xyz, 1.0);\n"
+    "}\n";
+
+static const char* jointFragmentShader =
+    "#version 100\n"
+    "precision mediump float;\n"
+    "varying vec4 fragColor;\n"
+    "void main() {\n"
+    "    gl_FragColor = fragColor;\n"
+    "}\n";
+#else
+static const char* jointVertexShader =
+    "#version 330\n"
+    "in vec3 vertexPosition;\n"
+    "in vec4 instanceSphere;\n"
+    "in vec4 instanceColor;\n"
+    "uniform mat4 mvp;\n"
+    "out vec4 fragColor;\n"
+    "void main() {\n"
+    "    fragColor = instanceColor;\n"
+    "    gl_Position = mvp*vec4(vertexPosition*instanceSphere.w + instanceSphere.xyz, 1.0);\n"
+    "}\n";
+
+static const char* jointFragmentShader =
+    "#version 330\n"
+    "in vec4 fragColor;\n"
+    "out vec4 finalColor;\n"
+    "void main() {\n"
+    "    finalColor = fragColor;\n"
+    "}\n";
+#endif
+
+HandJointRenderer::HandJointRenderer()
+    : sphere(), shader(), instanceVbo(0), vao(0),
+      locPosition(-1), locSphere(-1), locColor(-1), locMvp(-1), loaded(false),
+      instances(), instanceCount(0), stats() {
+}
+
+HandJointRenderer::~HandJointRenderer() {
+    unload();
+}
+
+void HandJointRenderer::load() {
+    // Joints are ~1cm spheres, a coarse tessellation is enough
+    sphere = GenMeshSphere(1.0f, 8, 12);
+
+    shader = LoadShaderFromMemory(jointVertexShader, jointFragmentShader);
+    locPosition = GetShaderLocationAttrib(shader, "vertexPosition");
+    locSphere = GetShaderLocationAttrib(shader, "instanceSphere");
+    locColor = GetShaderLocationAttrib(shader, "instanceColor");
+    locMvp = GetShaderLocation(shader, "mvp");
+
+    instanceVbo = rlLoadVertexBuffer(instances, sizeof(instances), true);
+
+    // VAOs are optional on WebGL 1; without one the attributes are bound per draw
+    vao = rlLoadVertexArray();
+    if (vao > 0) {
+        bindAttributes();
+        rlDisableVertexArray();
+    }
+
+    loaded = true;
+}
+
+void HandJointRenderer::bindAttributes() {
+    rlEnableVertexBuffer(sphere.vboId[0]);
+    rlSetVertexAttribute(locPosition, 3, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(locPosition);
+
+    rlEnableVertexBuffer(instanceVbo);
+    rlSetVertexAttribute(locSphere, 4, RL_FLOAT, false, sizeof(JointInstance), 0);
+    rlSetVertexAttributeDivisor(locSphere, 1);
+    rlEnableVertexAttribute(locSphere);
+
+    rlSetVertexAttribute(locColor, 4, RL_UNSIGNED_BYTE, true, sizeof(JointInstance), 4 * sizeof(float));
+    rlSetVertexAttributeDivisor(locColor, 1);
+    rlEnableVertexAttribute(locColor);
+}
+
+void HandJointRenderer::unbindAttributes() {
+    // Divisors are global state without a VAO, leave them as rlgl expects
+    rlSetVertexAttributeDivisor(locSphere, 0);
+    rlSetVertexAttributeDivisor(locColor, 0);
+    rlDisableVertexAttribute(locSphere);
+    rlDisableVertexAttribute(locColor);
+    rlDisableVertexAttribute(locPosition);
+}
+
+void HandJointRenderer::addHand(const WebXRHandData* hand, Color color) {
+    if (!hand) return;
+
+    for (int i = 0; i < WEBXR_HAND_JOINT_COUNT && instanceCount < MAX_INSTANCES; i++) {
+        const WebXRHandJointPose& joint = hand->joints[i];
+        if (joint.radius <= 0.0f) continue;
+
+        JointInstance& instance = instances[instanceCount++];
+        instance.center[0] = joint.position[0];
+        instance.center[1] = joint.position[1];
+        instance.center[2] = joint.position[2];
+        instance.radius = joint.radius;
+        instance.color[0] = color.r;
+        instance.color[1] = color.g;
+        instance.color[2] = color.b;
+        instance.color[3] = color.a;
+    }
+}
+
+void HandJointRenderer::draw() {
+    stats = {};
+    if (instanceCount == 0) return;
+    if (!loaded) load();
+
+    rlUpdateVertexBuffer(instanceVbo, instances, instanceCount * sizeof(JointInstance), 0);
+
+    rlEnableShader(shader.id);
+    if (vao > 0) {
+        rlEnableVertexArray(vao);
+    } else {
+        bindAttributes();
+    }
+
+    Matrix matModelView = MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview());
+    int eyeCount = rlIsStereoRenderEnabled() ? 2 : 1;
+    int eyeWidth = rlGetFramebufferWidth() / 2;
+
+    for (int eye = 0; eye < eyeCount; eye++) {
+        Matrix mvp;
+        if (eyeCount == 1) {
+            mvp = MatrixMultiply(matModelView, rlGetMatrixProjection());
+        } else {
+            rlViewport(eye * eyeWidth, 0, eyeWidth, rlGetFramebufferHeight());
+            mvp = MatrixMultiply(MatrixMultiply(matModelView, rlGetMatrixViewOffsetStereo(eye)),
+                                 rlGetMatrixProjectionStereo(eye));
+        }
+        rlSetUniformMatrix(locMvp, mvp);
+        rlDrawVertexArrayInstanced(0, sphere.vertexCount, instanceCount);
+        stats.drawCalls++;
+    }
+
+    if (vao > 0) {
+        rlDisableVertexArray();
+    } else {
+        unbindAttributes();
+    }
+    rlDisableVertexBuffer();
+    rlDisableShader();
+
+    if (eyeCount == 2) {
+        rlViewport(0, 0, rlGetFramebufferWidth(), rlGetFramebufferHeight());
+    }
+
+    stats.instances = instanceCount;
+    stats.verticesSubmitted = sphere.vertexCount * instanceCount * eyeCount;
+    instanceCount = 0;
+}
+
+void HandJointRenderer::unload() {
+    if (!loaded) return;
+
+    if (vao > 0) rlUnloadVertexArray(vao);
+    rlUnloadVertexBuffer(instanceVbo);
+    UnloadShader(shader);
+    UnloadMesh(sphere);
+
+    sphere = {};
+    shader = {};
+    vao = 0;
+    instanceVbo = 0;
+    loaded = false;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "raylib.h"
+#include <webxr.h>
+
+// Draws all tracked hand joints as one instanced draw of a unit sphere.
+// The sphere mesh is uploaded once; per frame only the instance buffer
+// (center, radius, color per joint) is refilled from WebXRHandData.
+class HandJointRenderer {
+public:
+    static const int MAX_INSTANCES = 2 * WEBXR_HAND_JOINT_COUNT;
+
+    struct Stats {
+        int drawCalls;          // instanced draws issued by the last draw()
+        int instances;          // joints drawn by the last draw()
+        int verticesSubmitted;  // sphere vertices * instances * eyes for the last draw()
+    };
+
+private:
+    struct JointInstance {
+        float center[3];
+        float radius;
+        unsigned char color[4];
+    };
+
+    Mesh sphere;
+    Shader shader;
+    unsigned int instanceVbo;
+    unsigned int vao;
+    int locPosition;
+    int locSphere;
+    int locColor;
+    int locMvp;
+    bool loaded;
+
+    JointInstance instances[MAX_INSTANCES];
+    int instanceCount;
+    Stats stats;
+
+    void load();
+    void bindAttributes();
+    void unbindAttributes();
+
+public:
+    HandJointRenderer();
+    ~HandJointRenderer();
+
+    // Queue the tracked joints (radius > 0) of one hand
+    void addHand(const WebXRHandData* hand, Color color);
+    // Draws the queued joints with the current rlgl matrices (stereo aware) and clears the queue
+    void draw();
+    // Releases GPU resources, call before CloseWindow()
+    void unload();
+
+    const Stats& getStats() const { return stats; }
+};
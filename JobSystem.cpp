@@ -0,0 +1,226 @@
+#include "JobSystem.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    // How long an idle thread polls for jobs before it sleeps; covers the gaps
+    // between fan-outs within a frame but not the wait for the next frame
+    const int SPIN_MICROSECONDS = 100;
+
+    struct CurrentWorker {
+        const JobSystem* system;
+        int index;
+    };
+
+    thread_local CurrentWorker current = { nullptr, 0 };
+}
+
+JobSystem::JobSystem(int workers) : workerCount(1) {
+#ifdef JOBSYSTEM_THREADS
+    queued.store(0);
+    sleeping.store(0);
+    stopping.store(false);
+#endif
+    resetStats();
+    setWorkerCount(workers);
+}
+
+JobSystem::~JobSystem() {
+#ifdef JOBSYSTEM_THREADS
+    stop();
+#endif
+}
+
+void JobSystem::setWorkerCount(int workers) {
+#ifdef JOBSYSTEM_THREADS
+    if (workers <= 0) {
+        workers = (int)std::thread::hardware_concurrency();
+#ifdef __EMSCRIPTEN__
+        workers = std::min(workers, (int)MAX_WEB_WORKERS);
+#endif
+    }
+    workers = std::min(std::max(workers, 1), (int)MAX_WORKERS);
+
+    stop();
+    start(workers);
+#else
+    // Without threads there is only the calling thread
+    (void)workers;
+    workerCount = 1;
+#endif
+}
+
+int JobSystem::currentWorker() const {
+    return current.system == this ? current.index : 0;
+}
+
+void JobSystem::execute(int index, const Job& job) {
+    job.function(job.data);
+    job.group->pending.fetch_sub(1, std::memory_order_release);
+#ifdef JOBSYSTEM_THREADS
+    workers[index].executed.fetch_add(1, std::memory_order_relaxed);
+#else
+    (void)index;
+    executed.fetch_add(1, std::memory_order_relaxed);
+#endif
+}
+
+void JobSystem::run(Group& group, JobFunction function, void* data) {
+    group.pending.fetch_add(1, std::memory_order_relaxed);
+    Job job = { function, data, &group };
+    int index = currentWorker();
+
+#ifdef JOBSYSTEM_THREADS
+    if (workerCount > 1 && push(index, job)) return;
+    workers[index].inlined.fetch_add(1, std::memory_order_relaxed);
+#else
+    inlined.fetch_add(1, std::memory_order_relaxed);
+#endif
+    execute(index, job);
+}
+
+void JobSystem::wait(Group& group) {
+#ifdef JOBSYSTEM_THREADS
+    int index = currentWorker();
+    Job job;
+    while (!group.isDone()) {
+        if (findJob(index, job)) {
+            execute(index, job);
+        } else {
+            // The rest of the group is running on other workers
+            std::this_thread::yield();
+        }
+    }
+#else
+    (void)group;   // run() executed everything already
+#endif
+}
+
+JobSystem::Stats JobSystem::getStats() const {
+    Stats stats = {};
+    stats.workers = workerCount;
+#ifdef JOBSYSTEM_THREADS
+    for (int i = 0; i < workerCount; i++) {
+        stats.jobs += workers[i].executed.load(std::memory_order_relaxed);
+        stats.stolen += workers[i].stolen.load(std::memory_order_relaxed);
+        stats.inlined += workers[i].inlined.load(std::memory_order_relaxed);
+    }
+#else
+    stats.jobs = executed.load(std::memory_order_relaxed);
+    stats.inlined = inlined.load(std::memory_order_relaxed);
+#endif
+    return stats;
+}
+
+void JobSystem::resetStats() {
+#ifdef JOBSYSTEM_THREADS
+    for (Worker& worker : workers) {
+        worker.executed.store(0);
+        worker.stolen.store(0);
+        worker.inlined.store(0);
+    }
+#else
+    executed.store(0);
+    inlined.store(0);
+#endif
+}
+
+#ifdef JOBSYSTEM_THREADS
+
+void JobSystem::start(int count) {
+    workerCount = count;
+    stopping.store(false);
+    current = { this, 0 };
+    for (int i = 0; i < count; i++) {
+        workers[i].front = workers[i].back = 0;
+    }
+    for (int i = 1; i < count; i++) {
+        threads[i] = std::thread(&JobSystem::workerLoop, this, i);
+    }
+}
+
+void JobSystem::stop() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping.store(true);
+    }
+    wake.notify_all();
+    for (int i = 1; i < workerCount; i++) {
+        if (threads[i].joinable()) threads[i].join();
+    }
+    workerCount = 1;
+}
+
+void JobSystem::workerLoop(int index) {
+    current = { this, index };
+    Job job;
+
+    while (!stopping.load(std::memory_order_relaxed)) {
+        if (findJob(index, job)) {
+            execute(index, job);
+            continue;
+        }
+
+        auto spinEnd = std::chrono::steady_clock::now() + std::chrono::microseconds(SPIN_MICROSECONDS);
+        while (queued.load(std::memory_order_acquire) == 0 && !stopping.load(std::memory_order_relaxed) &&
+               std::chrono::steady_clock::now() < spinEnd) {
+            std::this_thread::yield();
+        }
+        if (queued.load(std::memory_order_acquire) > 0) continue;
+
+        // run() reads sleeping after raising queued, so one of the two sees the other
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleeping.fetch_add(1);
+        wake.wait(lock, [this] { return stopping.load() || queued.load() > 0; });
+        sleeping.fetch_sub(1);
+    }
+}
+
+bool JobSystem::push(int index, const Job& job) {
+    Worker& worker = workers[index];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.back - worker.front == (unsigned)QUEUE_SIZE) return false;
+        worker.jobs[worker.back % QUEUE_SIZE] = job;
+        worker.back++;
+        queued.fetch_add(1);
+    }
+
+    if (sleeping.load() > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wake.notify_one();
+    }
+    return true;
+}
+
+bool JobSystem::pop(int index, Job& job) {
+    Worker& worker = workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.back == worker.front) return false;
+    worker.back--;
+    job = worker.jobs[worker.back % QUEUE_SIZE];
+    queued.fetch_sub(1);
+    return true;
+}
+
+bool JobSystem::steal(int thief, Job& job) {
+    for (int i = 1; i < workerCount; i++) {
+        Worker& victim = workers[(thief + i) % workerCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.back == victim.front) continue;
+        job = victim.jobs[victim.front % QUEUE_SIZE];
+        victim.front++;
+        queued.fetch_sub(1);
+        workers[thief].stolen.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::findJob(int index, Job& job) {
+    // Cheap check first: with nothing queued anywhere there is no lock to take
+    if (queued.load(std::memory_order_acquire) == 0) return false;
+    return pop(index, job) || steal(index, job);
+}
+
+#endif
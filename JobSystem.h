@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+
+// Worker threads natively and in web builds linked with -pthread; otherwise
+// every job runs on the calling thread inside run()
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+    #define JOBSYSTEM_THREADS
+    #include <condition_variable>
+    #include <mutex>
+    #include <thread>
+#endif
+
+// Fork-join jobs for work inside one frame: culling, animation, gesture
+// evaluation, physics.
+//
+// The thread that creates the system is worker 0 and only runs jobs while it
+// waits for a group; the other workers are threads of their own. Every worker
+// has a deque: jobs are pushed to and popped from the back of the submitting
+// worker's deque (newest first, still warm in cache), and idle workers steal
+// the oldest job from the front of another deque. Idle threads spin briefly
+// before sleeping, so jobs submitted back to back within a frame do not pay
+// for a wake-up each time.
+class JobSystem {
+public:
+    typedef void (*JobFunction)(void* data);
+
+    static const int MAX_WORKERS = 8;
+    static const int QUEUE_SIZE = 256;   // per worker; run() executes inline when its deque is full
+    // Web builds start their threads from the PTHREAD_POOL_SIZE pool (see the Makefile)
+    static const int MAX_WEB_WORKERS = 4;
+
+    // Jobs that are joined together. Must outlive the jobs run in it.
+    class Group {
+        std::atomic<int> pending;
+        friend class JobSystem;
+
+    public:
+        Group() : pending(0) {}
+        bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+    };
+
+    struct Stats {
+        int workers;
+        long long jobs;       // executed, by any worker
+        long long stolen;     // taken from another worker's deque
+        long long inlined;    // run inside run() because the deque was full or there are no threads
+    };
+
+private:
+    struct Job {
+        JobFunction function;
+        void* data;
+        Group* group;
+    };
+
+    int workerCount;
+
+#ifdef JOBSYSTEM_THREADS
+    struct alignas(64) Worker {
+        std::mutex mutex;
+        Job jobs[QUEUE_SIZE];
+        unsigned front, back;        // steal at front, owner pushes and pops at back
+        std::atomic<long long> executed, stolen, inlined;
+    };
+
+    Worker workers[MAX_WORKERS];
+    std::thread threads[MAX_WORKERS];   // [0] unused, worker 0 is the owning thread
+    std::atomic<int> queued;            // jobs sitting in any deque
+    std::atomic<int> sleeping;
+    std::atomic<bool> stopping;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+
+    void start(int count);
+    void stop();
+    void workerLoop(int index);
+    bool push(int index, const Job& job);
+    bool pop(int index, Job& job);
+    bool steal(int thief, Job& job);
+    bool findJob(int index, Job& job);
+#else
+    std::atomic<long long> executed, inlined;
+#endif
+
+    void execute(int index, const Job& job);
+    // The calling thread's worker index, 0 for threads that are not workers of this system
+    int currentWorker() const;
+
+public:
+    // workers counts the creating thread; 0 picks one per hardware thread, up to
+    // MAX_WORKERS (MAX_WEB_WORKERS on the web)
+    explicit JobSystem(int workers = 0);
+    ~JobSystem();
+
+    // Joins every thread and starts count - 1 new ones; no jobs may be pending
+    void setWorkerCount(int workers);
+    int getWorkerCount() const { return workerCount; }
+
+    // Queues function(data) in group; data must stay valid until the group is done
+    void run(Group& group, JobFunction function, void* data);
+    // Runs queued jobs (of any group) on the calling thread until group is done
+    void wait(Group& group);
+
+    // Calls body(begin, end) over [0, count) in chunks of at least grain items
+    // spread across the workers, and returns once all of them are done
+    template<typename Body>
+    void parallelFor(int count, int grain, const Body& body);
+
+    Stats getStats() const;
+    void resetStats();
+};
+
+template<typename Body>
+void JobSystem::parallelFor(int count, int grain, const Body& body) {
+    static const int MAX_CHUNKS = 4 * MAX_WORKERS;
+
+    struct Chunk {
+        const Body* body;
+        int begin, end;
+        static void call(void* data) {
+            Chunk* chunk = (Chunk*)data;
+            (*chunk->body)(chunk->begin, chunk->end);
+        }
+    };
+
+    if (count <= 0) return;
+    if (grain < 1) grain = 1;
+    // Four chunks per worker leave room for stealing when chunks differ in cost
+    int chunks = (count + grain - 1) / grain;
+    if (chunks > 4 * workerCount) chunks = 4 * workerCount;
+    if (chunks > MAX_CHUNKS) chunks = MAX_CHUNKS;
+    if (chunks <= 1) {
+        body(0, count);
+        return;
+    }
+
+    Chunk ranges[MAX_CHUNKS];
+    Group group;
+    int size = (count + chunks - 1) / chunks;
+    int submitted = 0;
+    for (int begin = 0; begin < count; begin += size) {
+        ranges[submitted] = { &body, begin, begin + size < count ? begin + size : count };
+        submitted++;
+    }
+    // The caller runs the first chunk and then pops from the back (chunk 1 next);
+    // thieves take the last chunks from the front
+    for (int i = submitted - 1; i > 0; i--) {
+        run(group, Chunk::call, &ranges[i]);
+    }
+    Chunk::call(&ranges[0]);
+    wait(group);
+}
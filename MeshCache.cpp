@@ -0,0 +1,422 @@
+#include "MeshCache.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+    const char MAGIC[4] = { 'R', 'M', 'C', 0 };
+    const int CACHE_SIZE = 32;   // vertex cache modelled by the reordering and by the ACMR figures
+
+    struct QuantizedVertex {
+        uint16_t position[3];
+        uint16_t texcoord[2];
+        int16_t normal[2];
+        uint16_t padding;
+    };
+
+    struct VertexKey {
+        uint64_t low, high;
+        bool operator==(const VertexKey& other) const { return low == other.low && high == other.high; }
+    };
+
+    struct VertexKeyHash {
+        size_t operator()(const VertexKey& key) const {
+            uint64_t h = key.low * 0x9E3779B97F4A7C15ull ^ (key.high + 0x632BE59BD9B4E019ull + (key.low >> 7));
+            return (size_t)(h ^ (h >> 29));
+        }
+    };
+
+    size_t align4(size_t n) {
+        return (n + 3) & ~(size_t)3;
+    }
+
+    // Range [min, max] as offset and step for 16-bit values
+    void quantization(float min, float max, float& offset, float& scale) {
+        offset = min;
+        scale = max > min ? (max - min) / 65535.0f : 0.0f;
+    }
+
+    uint16_t quantize(float value, float offset, float scale) {
+        if (scale <= 0.0f) return 0;
+        float q = (value - offset) / scale + 0.5f;
+        return (uint16_t)std::min(65535.0f, std::max(0.0f, q));
+    }
+
+    float signNotZero(float value) {
+        return value >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    // Unit vector onto the octahedron, folded into [-1, 1]^2; a zero vector encodes as +Z
+    void octEncode(const float* n, int16_t out[2]) {
+        float l1 = fabsf(n[0]) + fabsf(n[1]) + fabsf(n[2]);
+        if (l1 <= 0.0f) {
+            out[0] = out[1] = 0;
+            return;
+        }
+        float x = n[0] / l1, y = n[1] / l1;
+        if (n[2] < 0.0f) {
+            float folded = (1.0f - fabsf(y)) * signNotZero(x);
+            y = (1.0f - fabsf(x)) * signNotZero(y);
+            x = folded;
+        }
+        out[0] = (int16_t)lrintf(std::min(1.0f, std::max(-1.0f, x)) * 32767.0f);
+        out[1] = (int16_t)lrintf(std::min(1.0f, std::max(-1.0f, y)) * 32767.0f);
+    }
+
+    void octDecode(const int16_t* q, float* n) {
+        float x = std::max(-1.0f, q[0] / 32767.0f);
+        float y = std::max(-1.0f, q[1] / 32767.0f);
+        float z = 1.0f - fabsf(x) - fabsf(y);
+        float t = std::max(-z, 0.0f);
+        x -= t * signNotZero(x);
+        y -= t * signNotZero(y);
+        float inv = 1.0f / sqrtf(x * x + y * y + z * z);
+        n[0] = x * inv;
+        n[1] = y * inv;
+        n[2] = z * inv;
+    }
+
+    // Average cache misses per triangle through a FIFO cache of CACHE_SIZE entries
+    float averageCacheMisses(const std::vector<uint32_t>& indices, size_t vertexCount) {
+        if (indices.empty()) return 0.0f;
+        std::vector<int> insertedAt(vertexCount, -CACHE_SIZE - 1);
+        int misses = 0;
+        for (uint32_t v : indices) {
+            if (misses - insertedAt[v] > CACHE_SIZE) insertedAt[v] = misses++;
+        }
+        return misses / (indices.size() / 3.0f);
+    }
+
+    // Forsyth's linear-speed vertex cache optimisation: greedily emits the
+    // triangle whose vertices score highest, favouring vertices recently used
+    // (still in the modelled LRU cache) and vertices with few triangles left
+    float vertexScore(int cachePosition, int remaining) {
+        if (remaining == 0) return -1.0f;
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            // The last triangle's vertices score the same so its winding does not matter
+            score = cachePosition < 3 ? 0.75f : powf(1.0f - (cachePosition - 3) / (float)(CACHE_SIZE - 3), 1.5f);
+        }
+        return score + 2.0f * powf((float)remaining, -0.5f);
+    }
+
+    void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount) {
+        size_t triangleCount = indices.size() / 3;
+
+        // Triangles around each vertex; the first remaining[v] entries are not emitted yet
+        std::vector<int> remaining(vertexCount, 0), offsets(vertexCount + 1, 0);
+        for (uint32_t v : indices) remaining[v]++;
+        for (size_t v = 0; v < vertexCount; v++) offsets[v + 1] = offsets[v] + remaining[v];
+        std::vector<uint32_t> adjacency(indices.size());
+        std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++) adjacency[fill[indices[i]]++] = (uint32_t)(i / 3);
+
+        std::vector<int> cachePosition(vertexCount, -1);
+        std::vector<float> scores(vertexCount);
+        for (size_t v = 0; v < vertexCount; v++) scores[v] = vertexScore(-1, remaining[v]);
+
+        std::vector<char> emitted(triangleCount, 0);
+        std::vector<uint32_t> out;
+        out.reserve(indices.size());
+
+        uint32_t cache[CACHE_SIZE + 3], next[CACHE_SIZE + 3];
+        int cacheCount = 0;
+        size_t scan = 0;
+        long best = -1;
+
+        for (size_t count = 0; count < triangleCount; count++) {
+            // Nothing cached touches a remaining triangle: continue with the next one in input order
+            if (best < 0) {
+                while (emitted[scan]) scan++;
+                best = (long)scan;
+            }
+
+            const uint32_t* triangle = &indices[best * 3];
+            emitted[best] = 1;
+            out.insert(out.end(), triangle, triangle + 3);
+
+            int nextCount = 0;
+            for (int k = 0; k < 3; k++) {
+                uint32_t v = triangle[k];
+                next[nextCount++] = v;
+
+                uint32_t* around = &adjacency[offsets[v]];
+                int last = --remaining[v];
+                for (int j = 0; j <= last; j++) {
+                    if (around[j] == (uint32_t)best) {
+                        std::swap(around[j], around[last]);
+                        break;
+                    }
+                }
+            }
+            for (int i = 0; i < cacheCount; i++) {
+                uint32_t v = cache[i];
+                if (v != triangle[0] && v != triangle[1] && v != triangle[2]) next[nextCount++] = v;
+            }
+
+            for (int i = 0; i < nextCount; i++) {
+                uint32_t v = next[i];
+                cachePosition[v] = i < CACHE_SIZE ? i : -1;
+                scores[v] = vertexScore(cachePosition[v], remaining[v]);
+            }
+
+            // Only triangles around vertices whose score changed can have become the best
+            best = -1;
+            float bestScore = -1.0f;
+            for (int i = 0; i < nextCount; i++) {
+                uint32_t v = next[i];
+                const uint32_t* around = &adjacency[offsets[v]];
+                for (int j = 0; j < remaining[v]; j++) {
+                    const uint32_t* t = &indices[around[j] * 3];
+                    float score = scores[t[0]] + scores[t[1]] + scores[t[2]];
+                    if (score > bestScore) {
+                        bestScore = score;
+                        best = (long)around[j];
+                    }
+                }
+            }
+
+            cacheCount = std::min(nextCount, CACHE_SIZE);
+            memcpy(cache, next, cacheCount * sizeof(uint32_t));
+        }
+        indices.swap(out);
+    }
+
+    struct ChunkBuild {
+        std::vector<uint32_t> vertices;   // welded vertex ids in first-use order
+        std::vector<uint16_t> indices;
+    };
+
+    bool inBounds(uint32_t offset, size_t bytes, size_t tableEnd, size_t size) {
+        return offset % 4 == 0 && offset >= tableEnd && offset <= size && bytes <= size - offset;
+    }
+}
+
+const MeshCache::Header* MeshCache::validate(const void* data, size_t size) {
+    if (!data || ((uintptr_t)data & 3) != 0 || size < sizeof(Header)) return nullptr;
+
+    const unsigned char* bytes = (const unsigned char*)data;
+    const Header* header = (const Header*)data;
+    if (memcmp(header->magic, MAGIC, 4) != 0 || header->version != VERSION || header->size != size) return nullptr;
+    if (header->chunkCount > (size - sizeof(Header)) / sizeof(Chunk)) return nullptr;
+
+    size_t tableEnd = sizeof(Header) + header->chunkCount * sizeof(Chunk);
+    const Chunk* chunks = (const Chunk*)(bytes + sizeof(Header));
+
+    for (uint32_t c = 0; c < header->chunkCount; c++) {
+        const Chunk& chunk = chunks[c];
+        size_t n = chunk.vertexCount;
+        if (n == 0 || n > (size_t)MAX_CHUNK_VERTICES || chunk.indexCount == 0 || chunk.indexCount % 3 != 0) return nullptr;
+        if (!inBounds(chunk.positions, n * 3 * sizeof(uint16_t), tableEnd, size)) return nullptr;
+        if ((header->flags & HasTexcoords) && !inBounds(chunk.texcoords, n * 2 * sizeof(uint16_t), tableEnd, size)) return nullptr;
+        if ((header->flags & HasNormals) && !inBounds(chunk.normals, n * 2 * sizeof(int16_t), tableEnd, size)) return nullptr;
+        if (!inBounds(chunk.indices, chunk.indexCount * sizeof(uint16_t), tableEnd, size)) return nullptr;
+
+        const uint16_t* indices = (const uint16_t*)(bytes + chunk.indices);
+        uint16_t maxIndex = 0;
+        for (uint32_t i = 0; i < chunk.indexCount; i++) maxIndex = std::max(maxIndex, indices[i]);
+        if (maxIndex >= n) return nullptr;
+    }
+    return header;
+}
+
+bool MeshCache::decode(const void* data, size_t size, std::vector<Mesh>& chunks) {
+    const Header* header = validate(data, size);
+    if (!header) return false;
+
+    const unsigned char* bytes = (const unsigned char*)data;
+    const Chunk* table = (const Chunk*)(bytes + sizeof(Header));
+
+    for (uint32_t c = 0; c < header->chunkCount; c++) {
+        const Chunk& chunk = table[c];
+        int n = (int)chunk.vertexCount;
+
+        Mesh mesh = {};
+        mesh.vertexCount = n;
+        mesh.triangleCount = (int)chunk.indexCount / 3;
+
+        const uint16_t* positions = (const uint16_t*)(bytes + chunk.positions);
+        mesh.vertices = (float*)MemAlloc((unsigned int)(n * 3 * sizeof(float)));
+        for (int i = 0; i < n * 3; i += 3) {
+            for (int k = 0; k < 3; k++) {
+                mesh.vertices[i + k] = header->positionOffset[k] + positions[i + k] * header->positionScale[k];
+            }
+        }
+
+        if (header->flags & HasTexcoords) {
+            const uint16_t* texcoords = (const uint16_t*)(bytes + chunk.texcoords);
+            mesh.texcoords = (float*)MemAlloc((unsigned int)(n * 2 * sizeof(float)));
+            for (int i = 0; i < n * 2; i += 2) {
+                mesh.texcoords[i] = header->texcoordOffset[0] + texcoords[i] * header->texcoordScale[0];
+                mesh.texcoords[i + 1] = header->texcoordOffset[1] + texcoords[i + 1] * header->texcoordScale[1];
+            }
+        }
+
+        if (header->flags & HasNormals) {
+            const int16_t* normals = (const int16_t*)(bytes + chunk.normals);
+            mesh.normals = (float*)MemAlloc((unsigned int)(n * 3 * sizeof(float)));
+            for (int i = 0; i < n; i++) octDecode(normals + i * 2, mesh.normals + i * 3);
+        }
+
+        mesh.indices = (unsigned short*)MemAlloc(chunk.indexCount * sizeof(unsigned short));
+        memcpy(mesh.indices, bytes + chunk.indices, chunk.indexCount * sizeof(unsigned short));
+        chunks.push_back(mesh);
+    }
+    return true;
+}
+
+bool MeshCache::encode(const std::vector<Mesh>& meshes, std::vector<unsigned char>& out, BuildStats* stats) {
+    Header header = {};
+    memcpy(header.magic, MAGIC, 4);
+    header.version = VERSION;
+
+    // Quantization ranges over the whole model, so a vertex shared by two
+    // chunks lands on the same value in both and chunk seams do not crack
+    float minPosition[3] = { INFINITY, INFINITY, INFINITY }, maxPosition[3] = { -INFINITY, -INFINITY, -INFINITY };
+    float minTexcoord[2] = { INFINITY, INFINITY }, maxTexcoord[2] = { -INFINITY, -INFINITY };
+    int inputVertices = 0;
+    for (const Mesh& mesh : meshes) {
+        if (!mesh.vertices) continue;
+        if (mesh.texcoords) header.flags |= HasTexcoords;
+        if (mesh.normals) header.flags |= HasNormals;
+        for (int i = 0; i < mesh.vertexCount; i++) {
+            for (int k = 0; k < 3; k++) {
+                minPosition[k] = std::min(minPosition[k], mesh.vertices[i * 3 + k]);
+                maxPosition[k] = std::max(maxPosition[k], mesh.vertices[i * 3 + k]);
+            }
+            for (int k = 0; mesh.texcoords && k < 2; k++) {
+                minTexcoord[k] = std::min(minTexcoord[k], mesh.texcoords[i * 2 + k]);
+                maxTexcoord[k] = std::max(maxTexcoord[k], mesh.texcoords[i * 2 + k]);
+            }
+        }
+        inputVertices += mesh.vertexCount;
+    }
+    if (inputVertices == 0) return false;
+
+    for (int k = 0; k < 3; k++) quantization(minPosition[k], maxPosition[k], header.positionOffset[k], header.positionScale[k]);
+    for (int k = 0; (header.flags & HasTexcoords) && k < 2; k++) {
+        quantization(minTexcoord[k], maxTexcoord[k], header.texcoordOffset[k], header.texcoordScale[k]);
+    }
+
+    // Weld on the quantized values: corners that end up identical in the file share a vertex
+    std::vector<QuantizedVertex> vertices;
+    std::vector<uint32_t> indices;
+    std::unordered_map<VertexKey, uint32_t, VertexKeyHash> welded;
+
+    for (const Mesh& mesh : meshes) {
+        if (!mesh.vertices) continue;
+        int cornerCount = mesh.indices ? mesh.triangleCount * 3 : mesh.vertexCount - mesh.vertexCount % 3;
+
+        for (int first = 0; first < cornerCount; first += 3) {
+            uint32_t triangle[3];
+            for (int k = 0; k < 3; k++) {
+                int source = mesh.indices ? mesh.indices[first + k] : first + k;
+
+                QuantizedVertex q = {};
+                for (int c = 0; c < 3; c++) q.position[c] = quantize(mesh.vertices[source * 3 + c], header.positionOffset[c], header.positionScale[c]);
+                if (mesh.texcoords) {
+                    for (int c = 0; c < 2; c++) q.texcoord[c] = quantize(mesh.texcoords[source * 2 + c], header.texcoordOffset[c], header.texcoordScale[c]);
+                }
+                if (mesh.normals) octEncode(mesh.normals + source * 3, q.normal);
+
+                VertexKey key;
+                memcpy(&key, &q, sizeof(key));
+                auto found = welded.emplace(key, (uint32_t)vertices.size());
+                if (found.second) vertices.push_back(q);
+                triangle[k] = found.first->second;
+            }
+            // Corners that welded together leave a triangle with no area
+            if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2]) continue;
+            indices.insert(indices.end(), triangle, triangle + 3);
+        }
+    }
+    if (indices.empty()) return false;
+
+    float acmrBefore = averageCacheMisses(indices, vertices.size());
+    optimizeVertexCache(indices, vertices.size());
+    float acmrAfter = averageCacheMisses(indices, vertices.size());
+
+    // Split in emission order; renumbering by first use also orders each chunk's
+    // vertex streams for sequential fetch
+    std::vector<ChunkBuild> builds(1);
+    std::vector<int> chunkOf(vertices.size(), -1);
+    std::vector<uint16_t> local(vertices.size());
+
+    for (size_t first = 0; first < indices.size(); first += 3) {
+        int current = (int)builds.size() - 1;
+        int added = 0;
+        for (int k = 0; k < 3; k++) added += chunkOf[indices[first + k]] != current;
+
+        if (builds[current].vertices.size() + added > (size_t)MAX_CHUNK_VERTICES) {
+            builds.emplace_back();
+            current++;
+        }
+
+        ChunkBuild& build = builds[current];
+        for (int k = 0; k < 3; k++) {
+            uint32_t v = indices[first + k];
+            if (chunkOf[v] != current) {
+                chunkOf[v] = current;
+                local[v] = (uint16_t)build.vertices.size();
+                build.vertices.push_back(v);
+            }
+            build.indices.push_back(local[v]);
+        }
+    }
+
+    header.chunkCount = (uint32_t)builds.size();
+    std::vector<Chunk> table(builds.size());
+    size_t offset = sizeof(Header) + builds.size() * sizeof(Chunk);
+
+    for (size_t c = 0; c < builds.size(); c++) {
+        size_t n = builds[c].vertices.size();
+        Chunk& chunk = table[c];
+        chunk.vertexCount = (uint32_t)n;
+        chunk.indexCount = (uint32_t)builds[c].indices.size();
+        chunk.positions = (uint32_t)offset;
+        offset = align4(offset + n * 3 * sizeof(uint16_t));
+        if (header.flags & HasTexcoords) {
+            chunk.texcoords = (uint32_t)offset;
+            offset += n * 2 * sizeof(uint16_t);
+        }
+        if (header.flags & HasNormals) {
+            chunk.normals = (uint32_t)offset;
+            offset += n * 2 * sizeof(int16_t);
+        }
+        chunk.indices = (uint32_t)offset;
+        offset = align4(offset + chunk.indexCount * sizeof(uint16_t));
+    }
+    header.size = (uint32_t)offset;
+
+    out.assign(offset, 0);
+    memcpy(out.data(), &header, sizeof(Header));
+    memcpy(out.data() + sizeof(Header), table.data(), table.size() * sizeof(Chunk));
+
+    for (size_t c = 0; c < builds.size(); c++) {
+        const Chunk& chunk = table[c];
+        const ChunkBuild& build = builds[c];
+        uint16_t* positions = (uint16_t*)(out.data() + chunk.positions);
+        uint16_t* texcoords = (uint16_t*)(out.data() + chunk.texcoords);
+        int16_t* normals = (int16_t*)(out.data() + chunk.normals);
+
+        for (size_t i = 0; i < build.vertices.size(); i++) {
+            const QuantizedVertex& q = vertices[build.vertices[i]];
+            memcpy(positions + i * 3, q.position, sizeof(q.position));
+            if (header.flags & HasTexcoords) memcpy(texcoords + i * 2, q.texcoord, sizeof(q.texcoord));
+            if (header.flags & HasNormals) memcpy(normals + i * 2, q.normal, sizeof(q.normal));
+        }
+        memcpy(out.data() + chunk.indices, build.indices.data(), build.indices.size() * sizeof(uint16_t));
+    }
+
+    if (stats) {
+        stats->inputVertices = inputVertices;
+        stats->vertices = (int)vertices.size();
+        stats->triangles = (int)(indices.size() / 3);
+        stats->chunks = (int)builds.size();
+        stats->acmrBefore = acmrBefore;
+        stats->acmrAfter = acmrAfter;
+        stats->bytes = out.size();
+    }
+    return true;
+}
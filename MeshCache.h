@@ -0,0 +1,68 @@
+#pragma once
+
+#include "raylib.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Binary mesh cache (.rmc), written offline by meshcache_tool and loaded at
+// runtime without any text parsing.
+//
+// The file is a header, a chunk table and 4-byte aligned vertex and index
+// streams addressed by byte offset, so it can be used in place from a fetch
+// buffer or a memory mapping. Positions are 16-bit per component over the
+// model bounds, texcoords 16-bit over the model's UV range and normals
+// octahedral, two 16-bit components. Vertices are welded and triangles are
+// ordered for the post-transform vertex cache, then split into chunks of at
+// most MAX_CHUNK_VERTICES so every chunk uses raylib's 16-bit indices.
+// All values are little-endian.
+class MeshCache {
+public:
+    static const uint32_t VERSION = 1;
+    static const int MAX_CHUNK_VERTICES = 65535;
+
+    enum Flags { HasTexcoords = 1, HasNormals = 2 };
+
+    struct Header {
+        char magic[4];              // "RMC\0"
+        uint32_t version;
+        uint32_t flags;
+        uint32_t size;              // total file size in bytes
+        uint32_t chunkCount;        // Chunk entries follow the header
+        float positionOffset[3];    // position = offset + q * scale
+        float positionScale[3];
+        float texcoordOffset[2];
+        float texcoordScale[2];
+    };
+
+    struct Chunk {
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t positions;         // byte offsets from the start of the file; uint16 x3
+        uint32_t texcoords;         // uint16 x2, 0 without HasTexcoords
+        uint32_t normals;           // int16 x2 octahedral, 0 without HasNormals
+        uint32_t indices;           // uint16
+    };
+
+    struct BuildStats {
+        int inputVertices;          // vertices before welding
+        int vertices;
+        int triangles;
+        int chunks;
+        float acmrBefore;           // average cache misses per triangle, 32-entry FIFO
+        float acmrAfter;
+        size_t bytes;
+    };
+
+    // Header of a well-formed cache image, nullptr when the data is not one;
+    // checks every offset and index so nothing after it reads out of bounds
+    static const Header* validate(const void* data, size_t size);
+
+    // Dequantizes every chunk into CPU-side raylib meshes (not uploaded), the
+    // same contract as AssetStreamer::parseOBJ
+    static bool decode(const void* data, size_t size, std::vector<Mesh>& chunks);
+
+    // Welds, quantizes and reorders the triangles of meshes (indexed or not)
+    // into a cache image
+    static bool encode(const std::vector<Mesh>& meshes, std::vector<unsigned char>& out, BuildStats* stats = nullptr);
+};
@@ -0,0 +1,231 @@
+#include "PosePredictor.h"
+#include "VRMath.h"
+#include <raymath.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+PosePredictor::PosePredictor() {
+    reset();
+    resetStats();
+}
+
+void PosePredictor::reset() {
+    for (GripTrack& grip : grips) {
+        resetTrack(grip.position);
+        grip.hasRotation = false;
+    }
+    for (auto& hand : joints) {
+        for (Track& track : hand) resetTrack(track);
+    }
+}
+
+void PosePredictor::resetStats() {
+    gripErrors = {};
+    jointErrors = {};
+}
+
+void PosePredictor::resetTrack(Track& track) {
+    track.count = 0;
+    track.head = 0;
+    track.pendingCount = 0;
+}
+
+void PosePredictor::addSample(Track& track, double time, const float position[3], ErrorAccumulator& errors) {
+    if (track.count > 0) {
+        int newest = (track.head + HISTORY_SIZE - 1) % HISTORY_SIZE;
+        double lastTime = track.times[newest];
+
+        if (time <= lastTime) {
+            // Clock went backwards (replay looped) or a repeated frame
+            resetTrack(track);
+        } else {
+            // Ground truth at each target time, interpolated between the samples around it
+            const float* last = track.positions[newest];
+            int kept = 0;
+            for (int i = 0; i < track.pendingCount; i++) {
+                const Prediction& prediction = track.pending[i];
+                if (prediction.targetTime > time) {
+                    track.pending[kept++] = prediction;
+                    continue;
+                }
+                if (prediction.targetTime < lastTime) continue;
+
+                float alpha = (float)((prediction.targetTime - lastTime) / (time - lastTime));
+                float error = 0.0f, errorUnpredicted = 0.0f;
+                for (int k = 0; k < 3; k++) {
+                    float truth = last[k] + (position[k] - last[k]) * alpha;
+                    error += (prediction.predicted[k] - truth) * (prediction.predicted[k] - truth);
+                    errorUnpredicted += (prediction.unpredicted[k] - truth) * (prediction.unpredicted[k] - truth);
+                }
+                error = sqrtf(error);
+                errors.samples++;
+                errors.sum += error;
+                errors.sumUnpredicted += sqrtf(errorUnpredicted);
+                errors.max = std::max(errors.max, error);
+            }
+            track.pendingCount = kept;
+        }
+    }
+
+    track.times[track.head] = time;
+    track.positions[track.head][0] = position[0];
+    track.positions[track.head][1] = position[1];
+    track.positions[track.head][2] = position[2];
+    track.head = (track.head + 1) % HISTORY_SIZE;
+    track.count = std::min(track.count + 1, (int)HISTORY_SIZE);
+}
+
+bool PosePredictor::estimateVelocity(const Track& track, float velocity[3]) {
+    if (track.count < 2) return false;
+
+    // Oldest to newest over the whole history smooths per-frame tracking noise
+    int newest = (track.head + HISTORY_SIZE - 1) % HISTORY_SIZE;
+    int oldest = (track.head + HISTORY_SIZE - track.count) % HISTORY_SIZE;
+    float dt = (float)(track.times[newest] - track.times[oldest]);
+    if (dt <= 0.0f) return false;
+
+    for (int k = 0; k < 3; k++) {
+        velocity[k] = (track.positions[newest][k] - track.positions[oldest][k]) / dt;
+    }
+    return true;
+}
+
+void PosePredictor::predictPoint(Track& track, double time, float horizon, const float* velocity, float position[3]) {
+    float estimated[3];
+    if (!velocity) {
+        if (!estimateVelocity(track, estimated)) return;
+        velocity = estimated;
+    }
+
+    // With a full queue the prediction is applied but not scored
+    Prediction* prediction = track.pendingCount < PENDING_SIZE ? &track.pending[track.pendingCount++] : nullptr;
+    if (prediction) prediction->targetTime = time + horizon;
+
+    for (int k = 0; k < 3; k++) {
+        if (prediction) prediction->unpredicted[k] = position[k];
+        position[k] += velocity[k] * horizon;
+        if (prediction) prediction->predicted[k] = position[k];
+    }
+}
+
+void PosePredictor::predictGrip(GripTrack& grip, double time, float horizon, WebXRInputState& state) {
+    float* m = state.gripMatrix;
+
+    // Velocities are per second from XRPose, per millisecond here
+    float linear[3];
+    const float* velocity = nullptr;
+    if (state.hasGripVelocity) {
+        for (int k = 0; k < 3; k++) linear[k] = state.gripLinearVelocity[k] * 0.001f;
+        velocity = linear;
+    }
+
+    float position[3] = { m[12], m[13], m[14] };
+    addSample(grip.position, time, position, gripErrors);
+    predictPoint(grip.position, time, horizon, velocity, position);
+    m[12] = position[0];
+    m[13] = position[1];
+    m[14] = position[2];
+
+    Quaternion rotation = QuaternionFromMatrix(VRMath::fromWebXR(m));
+    Vector3 omega = { 0.0f, 0.0f, 0.0f };   // world-space axis * radians per millisecond
+    bool hasOmega = false;
+
+    if (state.hasGripVelocity) {
+        omega = { state.gripAngularVelocity[0] * 0.001f, state.gripAngularVelocity[1] * 0.001f, state.gripAngularVelocity[2] * 0.001f };
+        hasOmega = true;
+    } else if (grip.hasRotation && grip.position.count >= 2) {
+        const Track& track = grip.position;
+        int newest = (track.head + HISTORY_SIZE - 1) % HISTORY_SIZE;
+        int previous = (track.head + HISTORY_SIZE - 2) % HISTORY_SIZE;
+        float dt = (float)(track.times[newest] - track.times[previous]);
+
+        Quaternion last = { grip.rotation[0], grip.rotation[1], grip.rotation[2], grip.rotation[3] };
+        Quaternion delta = QuaternionMultiply(rotation, QuaternionInvert(last));
+        if (delta.w < 0.0f) delta = { -delta.x, -delta.y, -delta.z, -delta.w };
+
+        Vector3 axis;
+        float angle;
+        QuaternionToAxisAngle(delta, &axis, &angle);
+        if (dt > 0.0f) {
+            omega = Vector3Scale(axis, angle / dt);
+            hasOmega = true;
+        }
+    }
+
+    grip.rotation[0] = rotation.x;
+    grip.rotation[1] = rotation.y;
+    grip.rotation[2] = rotation.z;
+    grip.rotation[3] = rotation.w;
+    grip.hasRotation = true;
+
+    float rate = Vector3Length(omega);
+    if (hasOmega && horizon > 0.0f && rate > 1e-6f) {
+        Quaternion step = QuaternionFromAxisAngle(Vector3Scale(omega, 1.0f / rate), rate * horizon);
+        Matrix r = QuaternionToMatrix(QuaternionMultiply(step, rotation));
+        m[0] = r.m0; m[1] = r.m1; m[2] = r.m2;
+        m[4] = r.m4; m[5] = r.m5; m[6] = r.m6;
+        m[8] = r.m8; m[9] = r.m9; m[10] = r.m10;
+    }
+}
+
+void PosePredictor::predict(int time, float horizon, WebXRInputSnapshot& input, WebXRHandData hands[2], const int handDetected[2]) {
+    if (horizon < 0.0f) horizon = 0.0f;
+
+    bool gripSeen[2] = { false, false };
+    for (int i = 0; i < input.count; i++) {
+        WebXRInputState& state = input.inputs[i];
+        int handedness = state.source.handedness;
+        if (handedness < 0 || handedness > 1 || !state.hasGripPose || gripSeen[handedness]) continue;
+
+        predictGrip(grips[handedness], time, horizon, state);
+        gripSeen[handedness] = true;
+    }
+
+    for (int hand = 0; hand < 2; hand++) {
+        if (!gripSeen[hand]) {
+            resetTrack(grips[hand].position);
+            grips[hand].hasRotation = false;
+        }
+
+        for (int joint = 0; joint < WEBXR_HAND_JOINT_COUNT; joint++) {
+            Track& track = joints[hand][joint];
+            if (!handDetected[hand]) {
+                resetTrack(track);
+                continue;
+            }
+
+            float* position = hands[hand].joints[joint].position;
+            addSample(track, time, position, jointErrors);
+            predictPoint(track, time, horizon, nullptr, position);
+        }
+    }
+}
+
+PosePredictor::Stats PosePredictor::toStats(const ErrorAccumulator& errors) {
+    Stats stats = {};
+    stats.samples = errors.samples;
+    if (errors.samples > 0) {
+        stats.meanError = (float)(errors.sum / errors.samples) * 1000.0f;
+        stats.meanErrorUnpredicted = (float)(errors.sumUnpredicted / errors.samples) * 1000.0f;
+        stats.maxError = errors.max * 1000.0f;
+    }
+    return stats;
+}
+
+std::string PosePredictor::toJson() const {
+    std::string json = "{";
+    char entry[160];
+    const char* names[2] = { "grip", "joints" };
+    Stats stats[2] = { getGripStats(), getJointStats() };
+
+    for (int i = 0; i < 2; i++) {
+        snprintf(entry, sizeof(entry),
+                 "%s\"%s\":{\"samples\":%d,\"meanError\":%.3f,\"meanErrorUnpredicted\":%.3f,\"maxError\":%.3f}",
+                 i > 0 ? "," : "", names[i], stats[i].samples, stats[i].meanError, stats[i].meanErrorUnpredicted, stats[i].maxError);
+        json += entry;
+    }
+
+    json += "}";
+    return json;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <webxr.h>
+#include <string>
+
+// Extrapolates controller grips and hand joints from the time they were
+// sampled to the time the frame is expected on screen.
+//
+// Velocity comes from XRPose.linearVelocity/angularVelocity when the runtime
+// reports them, otherwise from a short per-point history. Every prediction is
+// checked against the samples of the following frames, so the stats report
+// the error with and without prediction on live sessions and replays alike.
+class PosePredictor {
+public:
+    static const int HISTORY_SIZE = 4;   // samples per tracked point, ~33 ms at 90 Hz
+    static const int PENDING_SIZE = 4;   // predictions awaiting a sample past their target time
+
+    struct Stats {
+        int samples;                  // predictions checked against later samples
+        float meanError;              // mm, predicted position vs. the sampled one at the target time
+        float meanErrorUnpredicted;   // mm, same for the pose as reported
+        float maxError;               // mm
+    };
+
+private:
+    struct Prediction {
+        double targetTime;
+        float predicted[3];
+        float unpredicted[3];
+    };
+
+    struct Track {
+        double times[HISTORY_SIZE];   // ms
+        float positions[HISTORY_SIZE][3];
+        int count;
+        int head;
+
+        // Scored once a later sample brackets their target time
+        Prediction pending[PENDING_SIZE];
+        int pendingCount;
+    };
+
+    struct GripTrack {
+        Track position;
+        float rotation[4];            // quaternion of the last sample
+        bool hasRotation;
+    };
+
+    struct ErrorAccumulator {
+        int samples;
+        double sum;
+        double sumUnpredicted;
+        float max;
+    };
+
+    GripTrack grips[2];               // by handedness
+    Track joints[2][WEBXR_HAND_JOINT_COUNT];
+    ErrorAccumulator gripErrors;
+    ErrorAccumulator jointErrors;
+
+    static void resetTrack(Track& track);
+    static void addSample(Track& track, double time, const float position[3], ErrorAccumulator& errors);
+    static bool estimateVelocity(const Track& track, float velocity[3]);
+    static void predictPoint(Track& track, double time, float horizon, const float* velocity, float position[3]);
+    static Stats toStats(const ErrorAccumulator& errors);
+
+    void predictGrip(GripTrack& grip, double time, float horizon, WebXRInputState& state);
+
+public:
+    PosePredictor();
+
+    // Moves grip and joint poses in place, `horizon` milliseconds past `time`
+    void predict(int time, float horizon, WebXRInputSnapshot& input, WebXRHandData hands[2], const int handDetected[2]);
+    // Drops history (new session); error stats are kept
+    void reset();
+    void resetStats();
+
+    Stats getGripStats() const { return toStats(gripErrors); }
+    Stats getJointStats() const { return toStats(jointErrors); }
+    std::string toJson() const;
+};
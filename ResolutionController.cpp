@@ -0,0 +1,146 @@
+#include "ResolutionController.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+    const float MISS_FACTOR = 1.5f;   // an interval this many periods long is a missed frame
+}
+
+ResolutionController::Settings ResolutionController::defaultSettings() {
+    Settings s;
+    s.minScale = 0.5f;
+    s.maxScale = 1.0f;
+    s.step = 0.05f;
+    s.shrinkSteps = 2;
+    s.headroom = 0.9f;
+    s.growLoad = 0.75f;
+    s.missWindow = 16;
+    s.missesToShrink = 2;
+    s.cooldownFrames = 8;
+    s.growDelay = 45;
+    s.maxGrowDelay = 720;
+    return s;
+}
+
+ResolutionController::ResolutionController() : stats() {
+    setSettings(defaultSettings());
+}
+
+void ResolutionController::setSettings(const Settings& newSettings) {
+    settings = newSettings;
+    settings.missWindow = std::min(std::max(settings.missWindow, 1), 32);
+    maxLevel = settings.step > 0.0f ? (int)((settings.maxScale - settings.minScale) / settings.step + 1e-4f) : 0;
+    reset();
+}
+
+void ResolutionController::reset() {
+    level = 0;
+    smoothedFrameTime = -1.0f;
+    intervalCount = 0;
+    intervalHead = 0;
+    missHistory = 0;
+    framesSinceChange = 0;
+    quietFrames = 0;
+    growDelay = settings.growDelay;
+    probing = false;
+}
+
+void ResolutionController::resetStats() {
+    stats = {};
+    stats.scale = getScale();
+    stats.growDelay = growDelay;
+}
+
+float ResolutionController::getScale() const {
+    return std::max(settings.minScale, settings.maxScale - level * settings.step);
+}
+
+float ResolutionController::estimatePeriod(float frameInterval, float targetFrameRate) {
+    if (frameInterval > 0.0f) {
+        intervals[intervalHead] = frameInterval;
+        intervalHead = (intervalHead + 1) % PERIOD_HISTORY;
+        intervalCount = std::min(intervalCount + 1, (int)PERIOD_HISTORY);
+    }
+    if (targetFrameRate > 0.0f) return 1000.0f / targetFrameRate;
+
+    // Without XRSession.frameRate, the display period is the shortest recent interval
+    if (intervalCount == 0) return 0.0f;
+    return *std::min_element(intervals, intervals + intervalCount);
+}
+
+void ResolutionController::changeLevel(int newLevel) {
+    newLevel = std::min(std::max(newLevel, 0), maxLevel);
+    if (newLevel == level) return;
+
+    if (newLevel > level) stats.shrinks++;
+    else stats.grows++;
+    level = newLevel;
+
+    // Misses before the change say nothing about the new scale
+    framesSinceChange = 0;
+    missHistory = 0;
+    quietFrames = 0;
+    probing = false;
+}
+
+float ResolutionController::update(float frameTime, float frameInterval, float targetFrameRate) {
+    stats.frames++;
+
+    float period = estimatePeriod(frameInterval, targetFrameRate);
+    bool missed = frameInterval > 0.0f && period > 0.0f && frameInterval > MISS_FACTOR * period;
+    if (missed) stats.missedFrames++;
+
+    smoothedFrameTime = smoothedFrameTime < 0.0f ? frameTime : smoothedFrameTime + 0.1f * (frameTime - smoothedFrameTime);
+    framesSinceChange++;
+
+    // Frames still in flight at the old scale are ignored until the cooldown ends.
+    // After a growth step the old scale was known to fit, so misses count at once.
+    int cooldown = probing ? 1 : settings.cooldownFrames;
+    if (framesSinceChange > cooldown) {
+        missHistory = (missHistory << 1) | (missed ? 1u : 0u);
+
+        uint32_t window = settings.missWindow >= 32 ? ~0u : (1u << settings.missWindow) - 1;
+        int misses = __builtin_popcount(missHistory & window);
+        float budget = period * settings.headroom;
+        bool overBudget = budget > 0.0f && smoothedFrameTime > budget;
+
+        if (misses >= settings.missesToShrink || overBudget) {
+            if (probing) {
+                // The last growth step did not fit: back to the previous level, and wait longer next time
+                growDelay = std::min(growDelay * 2, settings.maxGrowDelay);
+                stats.failedGrows++;
+                changeLevel(level + 1);
+            } else {
+                changeLevel(level + settings.shrinkSteps);
+            }
+        } else {
+            if (probing && framesSinceChange > cooldown + settings.missWindow) {
+                probing = false;
+                growDelay = std::max(settings.growDelay, growDelay / 2);
+            }
+
+            bool quiet = !missed && (budget <= 0.0f || smoothedFrameTime < settings.growLoad * budget);
+            quietFrames = quiet ? quietFrames + 1 : 0;
+            if (!probing && level > 0 && quietFrames >= growDelay) {
+                changeLevel(level - 1);
+                probing = true;
+            }
+        }
+    }
+
+    stats.scale = getScale();
+    stats.framePeriod = period;
+    stats.frameTime = smoothedFrameTime;
+    stats.growDelay = growDelay;
+    return stats.scale;
+}
+
+std::string ResolutionController::toJson() const {
+    char json[256];
+    snprintf(json, sizeof(json),
+             "{\"scale\":%.2f,\"framePeriod\":%.3f,\"frameTime\":%.3f,\"frames\":%d,\"missedFrames\":%d,"
+             "\"shrinks\":%d,\"grows\":%d,\"failedGrows\":%d,\"growDelay\":%d}",
+             stats.scale, stats.framePeriod, stats.frameTime, stats.frames, stats.missedFrames,
+             stats.shrinks, stats.grows, stats.failedGrows, stats.growDelay);
+    return json;
+}
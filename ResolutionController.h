@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+// Picks the per-eye viewport scale from frame-time feedback.
+//
+// WebGL work is queued, so GPU load shows up as frames that miss the display
+// interval rather than in the callback time. The controller shrinks the scale
+// when frames miss (or the CPU side alone runs over budget) and grows it one
+// step after a quiet period. A growth step that causes misses right away is
+// undone and the quiet period doubles, so with steady load the scale settles
+// just below the largest one that fits instead of oscillating around it.
+class ResolutionController {
+public:
+    struct Settings {
+        float minScale;        // smallest viewport scale
+        float maxScale;        // scale with no load problems, relative to the layer's framebuffer
+        float step;            // scale levels are maxScale - n * step
+        int shrinkSteps;       // levels dropped at once
+        float headroom;        // share of the frame period the CPU side may use
+        float growLoad;        // CPU time below growLoad * budget counts as quiet
+        int missWindow;        // frames looked at for misses (max 32)
+        int missesToShrink;    // misses within missWindow that trigger a shrink
+        int cooldownFrames;    // after a change, until its effect reaches the timing
+        int growDelay;         // quiet frames before growing one step
+        int maxGrowDelay;      // growDelay after repeated failed growth
+    };
+
+    struct Stats {
+        float scale;
+        float framePeriod;     // ms, from the session frame rate or the shortest recent interval
+        float frameTime;       // ms, smoothed CPU time of the frame
+        int frames;
+        int missedFrames;      // frames whose interval exceeded 1.5 periods
+        int shrinks;
+        int grows;
+        int failedGrows;       // growth steps undone because frames missed right after
+        int growDelay;         // current quiet period required before growing
+    };
+
+    static Settings defaultSettings();
+
+private:
+    static const int PERIOD_HISTORY = 90;
+
+    Settings settings;
+    int level;                 // 0 is maxScale
+    int maxLevel;
+    float smoothedFrameTime;
+    float intervals[PERIOD_HISTORY];
+    int intervalCount;
+    int intervalHead;
+    uint32_t missHistory;      // bit 0 is the latest frame
+    int framesSinceChange;
+    int quietFrames;
+    int growDelay;
+    bool probing;              // the last change was a growth step still being watched
+    Stats stats;
+
+    float estimatePeriod(float frameInterval, float targetFrameRate);
+    void changeLevel(int newLevel);
+
+public:
+    ResolutionController();
+
+    void setSettings(const Settings& newSettings);
+    const Settings& getSettings() const { return settings; }
+
+    // Once per frame: frameTime is the CPU time of the frame in ms, frameInterval
+    // the time since the previous frame (0 if unknown), targetFrameRate the
+    // session's rate (0 if unknown). Returns the scale to request for the next frame.
+    float update(float frameTime, float frameInterval, float targetFrameRate);
+    // Back to maxScale with fresh history (new session); stats keep the last frame's values
+    void reset();
+    void resetStats();
+
+    float getScale() const;
+    const Stats& getStats() const { return stats; }
+    std::string toJson() const;
+};
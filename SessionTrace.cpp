@@ -0,0 +1,153 @@
+#include "SessionTrace.h"
+#include <cstring>
+
+SessionRecorder::SessionRecorder() : file(nullptr), frameCount(0) {
+}
+
+SessionRecorder::~SessionRecorder() {
+    stop();
+}
+
+bool SessionRecorder::start(const char* path, int sessionMode) {
+    stop();
+
+    file = fopen(path, "wb");
+    if (!file) return false;
+
+    SessionTrace::Header header = { { 'W', 'X', 'R', 'T' }, SessionTrace::VERSION, sessionMode, 0 };
+    fwrite(&header, sizeof(header), 1, file);
+    frameCount = 0;
+    return true;
+}
+
+void SessionRecorder::recordFrame(int time, const WebXRFrameData& frame, const WebXRInputSnapshot& input, const WebXRFrameStats& stats) {
+    if (!file) return;
+
+    uint32_t flags = 0;
+    if (frame.handDetected[0]) flags |= SessionTrace::FLAG_LEFT_HAND;
+    if (frame.handDetected[1]) flags |= SessionTrace::FLAG_RIGHT_HAND;
+    int32_t time32 = time;
+    int32_t inputCount = input.count;
+
+    fwrite(&flags, sizeof(flags), 1, file);
+    fwrite(&time32, sizeof(time32), 1, file);
+    fwrite(&stats.predictedDisplayDelta, sizeof(float), 1, file);
+    fwrite(frame.views, sizeof(frame.views), 1, file);
+    fwrite(frame.modelMatrix, sizeof(frame.modelMatrix), 1, file);
+    if (flags & SessionTrace::FLAG_LEFT_HAND) fwrite(&frame.hands[0], sizeof(WebXRHandData), 1, file);
+    if (flags & SessionTrace::FLAG_RIGHT_HAND) fwrite(&frame.hands[1], sizeof(WebXRHandData), 1, file);
+    fwrite(&inputCount, sizeof(inputCount), 1, file);
+    fwrite(input.inputs, sizeof(WebXRInputState), inputCount, file);
+
+    frameCount++;
+}
+
+void SessionRecorder::stop() {
+    if (file) {
+        fclose(file);
+        file = nullptr;
+    }
+}
+
+SessionTraceReader::SessionTraceReader() : sessionMode(WEBXR_SESSION_MODE_IMMERSIVE_VR) {
+}
+
+bool SessionTraceReader::open(const char* path) {
+    close();
+
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size < (long)sizeof(SessionTrace::Header)) {
+        fclose(f);
+        return false;
+    }
+
+    data.resize((size_t)size);
+    size_t read = fread(data.data(), 1, data.size(), f);
+    fclose(f);
+    if (read != data.size()) {
+        close();
+        return false;
+    }
+
+    SessionTrace::Header header;
+    memcpy(&header, data.data(), sizeof(header));
+    if (memcmp(header.magic, "WXRT", 4) != 0 || header.version != SessionTrace::VERSION) {
+        close();
+        return false;
+    }
+    sessionMode = header.sessionMode;
+
+    // Index frame offsets so frames can be read in any order
+    const size_t fixedSize = 2 * sizeof(uint32_t) + sizeof(float) + 2 * sizeof(WebXRView) + 16 * sizeof(float);
+    size_t offset = sizeof(header);
+    while (offset + fixedSize + sizeof(int32_t) <= data.size()) {
+        uint32_t flags;
+        memcpy(&flags, &data[offset], sizeof(flags));
+
+        size_t handsSize = 0;
+        if (flags & SessionTrace::FLAG_LEFT_HAND) handsSize += sizeof(WebXRHandData);
+        if (flags & SessionTrace::FLAG_RIGHT_HAND) handsSize += sizeof(WebXRHandData);
+
+        size_t countOffset = offset + fixedSize + handsSize;
+        if (countOffset + sizeof(int32_t) > data.size()) break;
+
+        int32_t inputCount;
+        memcpy(&inputCount, &data[countOffset], sizeof(inputCount));
+        if (inputCount < 0 || inputCount > WEBXR_MAX_INPUT_SOURCES) break;
+
+        size_t end = countOffset + sizeof(int32_t) + inputCount * sizeof(WebXRInputState);
+        if (end > data.size()) break;
+
+        frameOffsets.push_back(offset);
+        offset = end;
+    }
+
+    return true;
+}
+
+void SessionTraceReader::close() {
+    data.clear();
+    frameOffsets.clear();
+}
+
+bool SessionTraceReader::readFrame(int index, int* time, WebXRFrameData* frame, WebXRInputSnapshot* input, WebXRFrameStats* stats) const {
+    if (index < 0 || index >= getFrameCount()) return false;
+
+    const uint8_t* p = &data[frameOffsets[index]];
+
+    uint32_t flags;
+    int32_t time32;
+    memcpy(&flags, p, sizeof(flags)); p += sizeof(flags);
+    memcpy(&time32, p, sizeof(time32)); p += sizeof(time32);
+    if (time) *time = time32;
+    if (stats) memcpy(&stats->predictedDisplayDelta, p, sizeof(float));
+    p += sizeof(float);
+
+    if (frame) memcpy(frame->views, p, sizeof(frame->views));
+    p += sizeof(frame->views);
+    if (frame) memcpy(frame->modelMatrix, p, sizeof(frame->modelMatrix));
+    p += sizeof(frame->modelMatrix);
+
+    for (int hand = 0; hand < 2; hand++) {
+        bool detected = (flags & (hand == 0 ? SessionTrace::FLAG_LEFT_HAND : SessionTrace::FLAG_RIGHT_HAND)) != 0;
+        if (frame) frame->handDetected[hand] = detected ? 1 : 0;
+        if (detected) {
+            if (frame) memcpy(&frame->hands[hand], p, sizeof(WebXRHandData));
+            p += sizeof(WebXRHandData);
+        }
+    }
+
+    int32_t inputCount;
+    memcpy(&inputCount, p, sizeof(inputCount)); p += sizeof(inputCount);
+    if (input) {
+        input->count = inputCount;
+        memcpy(input->inputs, p, inputCount * sizeof(WebXRInputState));
+    }
+
+    return true;
+}
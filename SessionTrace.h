@@ -0,0 +1,65 @@
+#pragma once
+
+#include <webxr.h>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Binary trace of WebXR frames, used to replay sessions without a headset.
+//
+// Layout (native endianness):
+//   header:  "WXRT", uint32 version, int32 session mode, uint32 reserved
+//   frame:   uint32 flags (bit 0 = left hand, bit 1 = right hand), int32 time,
+//            float predicted display delta, WebXRView[2], float[16] model matrix,
+//            WebXRHandData per flagged hand, int32 input count,
+//            WebXRInputState[input count]
+namespace SessionTrace {
+    static const uint32_t VERSION = 2;   // 2: display delta, grip velocities in WebXRInputState
+    static const uint32_t FLAG_LEFT_HAND = 1u << 0;
+    static const uint32_t FLAG_RIGHT_HAND = 1u << 1;
+
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        int32_t sessionMode;
+        uint32_t reserved;
+    };
+}
+
+class SessionRecorder {
+private:
+    FILE* file;
+    int frameCount;
+
+public:
+    SessionRecorder();
+    ~SessionRecorder();
+
+    bool start(const char* path, int sessionMode);
+    void recordFrame(int time, const WebXRFrameData& frame, const WebXRInputSnapshot& input, const WebXRFrameStats& stats);
+    void stop();
+
+    bool isRecording() const { return file != nullptr; }
+    int getFrameCount() const { return frameCount; }
+};
+
+class SessionTraceReader {
+private:
+    std::vector<uint8_t> data;
+    std::vector<size_t> frameOffsets;
+    int sessionMode;
+
+public:
+    SessionTraceReader();
+
+    // Loads and indexes the whole trace; returns false on I/O or format errors
+    bool open(const char* path);
+    void close();
+
+    int getFrameCount() const { return (int)frameOffsets.size(); }
+    int getSessionMode() const { return sessionMode; }
+
+    // Writes frame `index` into the same structures the JS library fills
+    // (only predictedDisplayDelta of stats is recorded)
+    bool readFrame(int index, int* time, WebXRFrameData* frame, WebXRInputSnapshot* input, WebXRFrameStats* stats) const;
+};
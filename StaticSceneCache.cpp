@@ -0,0 +1,218 @@
+#include "StaticSceneCache.h"
+#include <raymath.h>
+#include <rlgl.h>
+#include <cstring>
+
+namespace {
+
+struct CubeFace {
+    Vector3 normal;
+    Vector3 u;
+    Vector3 v;  // u x v == normal, so (-u-v, +u-v, +u+v, -u+v) is counter-clockwise
+};
+
+const CubeFace cubeFaces[6] = {
+    { {  0.0f,  0.0f,  1.0f }, {  1.0f, 0.0f,  0.0f }, { 0.0f, 1.0f,  0.0f } },
+    { {  0.0f,  0.0f, -1.0f }, { -1.0f, 0.0f,  0.0f }, { 0.0f, 1.0f,  0.0f } },
+    { {  1.0f,  0.0f,  0.0f }, {  0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f,  0.0f } },
+    { { -1.0f,  0.0f,  0.0f }, {  0.0f, 0.0f,  1.0f }, { 0.0f, 1.0f,  0.0f } },
+    { {  0.0f,  1.0f,  0.0f }, {  1.0f, 0.0f,  0.0f }, { 0.0f, 0.0f, -1.0f } },
+    { {  0.0f, -1.0f,  0.0f }, {  1.0f, 0.0f,  0.0f }, { 0.0f, 0.0f,  1.0f } },
+};
+
+Vector3 scaled(Vector3 a, Vector3 s) {
+    return (Vector3){ a.x * s.x, a.y * s.y, a.z * s.z };
+}
+
+struct MeshBuilder {
+    std::vector<float> vertices;
+    std::vector<float> normals;
+    std::vector<unsigned char> colors;
+
+    void vertex(Vector3 p, Vector3 n, Color c) {
+        vertices.insert(vertices.end(), { p.x, p.y, p.z });
+        normals.insert(normals.end(), { n.x, n.y, n.z });
+        colors.insert(colors.end(), { c.r, c.g, c.b, c.a });
+    }
+
+    void quad(Vector3 center, Vector3 u, Vector3 v, Vector3 normal, Color color) {
+        Vector3 p0 = Vector3Subtract(Vector3Subtract(center, u), v);
+        Vector3 p1 = Vector3Subtract(Vector3Add(center, u), v);
+        Vector3 p2 = Vector3Add(Vector3Add(center, u), v);
+        Vector3 p3 = Vector3Add(Vector3Subtract(center, u), v);
+
+        vertex(p0, normal, color); vertex(p1, normal, color); vertex(p2, normal, color);
+        vertex(p0, normal, color); vertex(p2, normal, color); vertex(p3, normal, color);
+    }
+
+    int vertexCount() const { return (int)(vertices.size() / 3); }
+};
+
+template <typename T>
+T* copyToRaylib(const std::vector<T>& data) {
+    T* out = (T*)MemAlloc((unsigned int)(data.size() * sizeof(T)));
+    memcpy(out, data.data(), data.size() * sizeof(T));
+    return out;
+}
+
+}
+
+StaticSceneCache::StaticSceneCache()
+    : mesh(), material(), meshLoaded(false), materialLoaded(false), dirty(true), stats() {
+}
+
+StaticSceneCache::~StaticSceneCache() {
+    unload();
+}
+
+void StaticSceneCache::addCube(Vector3 position, float width, float height, float length, Color color) {
+    primitives.push_back({ PrimitiveType::Cube, position, { width, height, length }, color, 0 });
+    dirty = true;
+}
+
+void StaticSceneCache::addCubeWires(Vector3 position, float width, float height, float length, Color color) {
+    primitives.push_back({ PrimitiveType::CubeWires, position, { width, height, length }, color, 0 });
+    dirty = true;
+}
+
+void StaticSceneCache::addPlane(Vector3 centerPos, Vector2 size, Color color) {
+    primitives.push_back({ PrimitiveType::Plane, centerPos, { size.x, 0.0f, size.y }, color, 0 });
+    dirty = true;
+}
+
+void StaticSceneCache::addGrid(int slices, float spacing) {
+    primitives.push_back({ PrimitiveType::Grid, { 0.0f, 0.0f, 0.0f }, { spacing, 0.0f, spacing }, LIGHTGRAY, slices });
+    dirty = true;
+}
+
+void StaticSceneCache::clear() {
+    primitives.clear();
+    dirty = true;
+}
+
+void StaticSceneCache::addLine(Vector3 start, Vector3 end, Color color) {
+    linePositions.push_back(start);
+    linePositions.push_back(end);
+    lineColors.push_back(color);
+    lineColors.push_back(color);
+}
+
+void StaticSceneCache::rebuild() {
+    if (meshLoaded) {
+        UnloadMesh(mesh);
+        mesh = {};
+        meshLoaded = false;
+    }
+    linePositions.clear();
+    lineColors.clear();
+
+    MeshBuilder builder;
+
+    for (const Primitive& p : primitives) {
+        Vector3 half = Vector3Scale(p.size, 0.5f);
+
+        switch (p.type) {
+        case PrimitiveType::Cube:
+            for (const CubeFace& face : cubeFaces) {
+                Vector3 center = Vector3Add(p.position, scaled(face.normal, half));
+                builder.quad(center, scaled(face.u, half), scaled(face.v, half), face.normal, p.color);
+            }
+            break;
+
+        case PrimitiveType::Plane:
+            builder.quad(p.position, (Vector3){ half.x, 0.0f, 0.0f }, (Vector3){ 0.0f, 0.0f, -half.z },
+                         (Vector3){ 0.0f, 1.0f, 0.0f }, p.color);
+            break;
+
+        case PrimitiveType::CubeWires: {
+            // Corner i has bit 0 = +x, bit 1 = +y, bit 2 = +z; edges join corners one bit apart
+            Vector3 corners[8];
+            for (int i = 0; i < 8; i++) {
+                corners[i] = (Vector3){
+                    p.position.x + ((i & 1) ? half.x : -half.x),
+                    p.position.y + ((i & 2) ? half.y : -half.y),
+                    p.position.z + ((i & 4) ? half.z : -half.z)
+                };
+            }
+            for (int i = 0; i < 8; i++) {
+                for (int bit = 1; bit < 8; bit <<= 1) {
+                    if (!(i & bit)) addLine(corners[i], corners[i | bit], p.color);
+                }
+            }
+            break;
+        }
+
+        case PrimitiveType::Grid: {
+            // Matches DrawGrid(): darker center lines, lighter others
+            int halfSlices = p.slices / 2;
+            float extent = halfSlices * p.size.x;
+            for (int i = -halfSlices; i <= halfSlices; i++) {
+                Color color = (i == 0) ? (Color){ 127, 127, 127, 255 } : (Color){ 191, 191, 191, 255 };
+                float offset = i * p.size.x;
+                addLine((Vector3){ offset, 0.0f, -extent }, (Vector3){ offset, 0.0f, extent }, color);
+                addLine((Vector3){ -extent, 0.0f, offset }, (Vector3){ extent, 0.0f, offset }, color);
+            }
+            break;
+        }
+        }
+    }
+
+    if (builder.vertexCount() > 0) {
+        mesh.vertexCount = builder.vertexCount();
+        mesh.triangleCount = mesh.vertexCount / 3;
+        mesh.vertices = copyToRaylib(builder.vertices);
+        mesh.normals = copyToRaylib(builder.normals);
+        mesh.colors = copyToRaylib(builder.colors);
+        UploadMesh(&mesh, false);
+        meshLoaded = true;
+    }
+
+    if (!materialLoaded) {
+        material = LoadMaterialDefault();
+        materialLoaded = true;
+    }
+
+    dirty = false;
+}
+
+void StaticSceneCache::draw() {
+    if (dirty) {
+        rebuild();
+    }
+
+    stats = {};
+
+    if (meshLoaded) {
+        DrawMesh(mesh, material, MatrixIdentity());
+        stats.drawCalls++;
+        stats.verticesResident += mesh.vertexCount;
+    }
+
+    int lineVertexCount = (int)linePositions.size();
+    if (lineVertexCount > 0) {
+        rlCheckRenderBatchLimit(lineVertexCount);
+        rlBegin(RL_LINES);
+        for (int i = 0; i < lineVertexCount; i++) {
+            const Color& c = lineColors[i];
+            const Vector3& v = linePositions[i];
+            rlColor4ub(c.r, c.g, c.b, c.a);
+            rlVertex3f(v.x, v.y, v.z);
+        }
+        rlEnd();
+        stats.verticesStreamed += lineVertexCount;
+    }
+}
+
+void StaticSceneCache::unload() {
+    if (meshLoaded) {
+        UnloadMesh(mesh);
+        mesh = {};
+        meshLoaded = false;
+    }
+    if (materialLoaded) {
+        UnloadMaterial(material);
+        material = {};
+        materialLoaded = false;
+    }
+    dirty = true;
+}
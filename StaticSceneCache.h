@@ -0,0 +1,63 @@
+#pragma once
+
+#include "raylib.h"
+#include <vector>
+
+// Static scene geometry baked once instead of re-streamed through the rlgl
+// batch every eye. Solid primitives are merged into one vertex-colored mesh
+// that lives on the GPU; lines are pre-transformed and replayed from a flat
+// array (rlgl has no resident line buffers). Re-baked only when dirty.
+class StaticSceneCache {
+public:
+    struct Stats {
+        int drawCalls;          // GPU draws issued for resident meshes by the last draw()
+        int verticesResident;   // vertices drawn from GPU buffers by the last draw()
+        int verticesStreamed;   // vertices pushed through the rlgl batch by the last draw()
+    };
+
+private:
+    enum class PrimitiveType { Cube, CubeWires, Plane, Grid };
+
+    struct Primitive {
+        PrimitiveType type;
+        Vector3 position;
+        Vector3 size;
+        Color color;
+        int slices;
+    };
+
+    std::vector<Primitive> primitives;
+    std::vector<Vector3> linePositions;
+    std::vector<Color> lineColors;
+
+    Mesh mesh;
+    Material material;
+    bool meshLoaded;
+    bool materialLoaded;
+    bool dirty;
+    Stats stats;
+
+    void rebuild();
+    void addLine(Vector3 start, Vector3 end, Color color);
+
+public:
+    StaticSceneCache();
+    ~StaticSceneCache();
+
+    // Same parameters as the raylib immediate-mode functions they replace
+    void addCube(Vector3 position, float width, float height, float length, Color color);
+    void addCubeWires(Vector3 position, float width, float height, float length, Color color);
+    void addPlane(Vector3 centerPos, Vector2 size, Color color);
+    void addGrid(int slices, float spacing);
+    void clear();
+
+    void markDirty() { dirty = true; }
+    bool isDirty() const { return dirty; }
+
+    // Needs a current GL context; bakes first if dirty
+    void draw();
+    // Releases GPU resources, call before CloseWindow()
+    void unload();
+
+    const Stats& getStats() const { return stats; }
+};
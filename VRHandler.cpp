@@ -1,9 +1,14 @@
 #include "VRHandler.h"
+#include "VRMath.h"
+#ifdef __EMSCRIPTEN__
 #include <emscripten/emscripten.h>
+#else
+#include "native_shim.h"
+#endif
 #include <raymath.h>
 #include <rlgl.h>
-#include <iomanip>
-#include <sstream>
+#include <algorithm>
+#include <cstdio>
 
 VRHandler* VRHandler::instance = nullptr;
 
@@ -18,75 +23,74 @@ EM_JS(void, init_webgl_context_vr, (), {
     }
 });
 
+// Module.ctx drops redundant state calls itself, see _install_gl_cache in library_webxr.js
 EM_JS(void, set_viewport_vr, (int x, int y, int width, int height), {
-    if (typeof gl === 'undefined') {
-        gl = window.gl || Module.ctx;
-    }
-    if (gl) {
-        gl.viewport(x, y, width, height);
-    } else {
-        console.error("WebGL context not available for viewport setting");
-    }
+    Module.ctx.viewport(x, y, width, height);
 });
 
-EM_JS(void, clear_viewport_vr, (int x, int y, int width, int height), {
-    if (typeof gl === 'undefined') {
-        gl = window.gl || Module.ctx;
-    }
-    if (gl) {
-        gl.enable(gl.SCISSOR_TEST);
-        gl.scissor(x, y, width, height);
-        gl.clearColor(0.4, 0.7, 1.0, 1.0);
-        gl.clear(gl.COLOR_BUFFER_BIT | gl.DEPTH_BUFFER_BIT);
-        gl.disable(gl.SCISSOR_TEST);
-    }
+EM_JS(void, clear_viewport_vr, (int x, int y, int width, int height, int r, int g, int b, int a), {
+    var gl = Module.ctx;
+    gl.enable(gl.SCISSOR_TEST);
+    gl.scissor(x, y, width, height);
+    gl.clearColor(r / 255, g / 255, b / 255, a / 255);
+    gl.clear(gl.COLOR_BUFFER_BIT | gl.DEPTH_BUFFER_BIT);
+    gl.disable(gl.SCISSOR_TEST);
+});
+
+EM_JS(void, bind_layer_framebuffer_vr, (), {
+    var session = Module['webxr_session'];
+    var layer = session && session.renderState.baseLayer;
+    Module.ctx.bindFramebuffer(Module.ctx.FRAMEBUFFER, layer ? layer.framebuffer : null);
+});
+
+EM_JS(void, download_file_vr, (const char *path), {
+    var name = UTF8ToString(path);
+    var blob = new Blob([FS.readFile(name)], { type: 'application/octet-stream' });
+    var link = document.createElement('a');
+    link.href = URL.createObjectURL(blob);
+    link.download = name.split('/').pop();
+    link.click();
+    setTimeout(function() { URL.revokeObjectURL(link.href); }, 0);
 });
 
 void frameCallbackWrapper(void* userData, int time, float modelMatrix[16], WebXRView* views, void* handData) {
     VRHandler* handler = VRHandler::getInstance();
     if (handler && handler->frameHandler) {
-        if (!handler->vrSessionActive) {
-            handler->setSessionActive(true);
-            handler->setARSession(webxr_is_ar_session());
-            handler->setHandTracking(webxr_is_hand_tracking_supported());
-            
-            if (handler->handTrackingActive) {
-                VRHandler::log("Hand tracking is active!");
-            } else {
-                VRHandler::log("Hand tracking not available, will show controllers");
-            }
-            
-            if (handler->isARSession) {
-                VRHandler::log("AR session started");
-            } else {
-                VRHandler::log("VR session started");
+        handler->beginFrame(time);
+        if (handler->inputEventHandler) {
+            for (int i = 0; i < handler->inputEventCount; i++) {
+                handler->inputEventHandler(handler->inputEvents[i]);
             }
-            
-            WebXRInputSource inputSources[16];
-            int inputCount = 0;
-            webxr_get_input_sources(inputSources, 16, &inputCount);
-            
-            std::ostringstream oss;
-            oss << "Detected " << inputCount << " input sources";
-            VRHandler::log(oss.str());
-            
-            for (int i = 0; i < inputCount; i++) {
-                std::ostringstream inputOss;
-                inputOss << "Input " << i << ": Handedness=" << inputSources[i].handedness 
-                        << ", HasController=" << inputSources[i].hasController 
-                        << ", HasHand=" << inputSources[i].hasHand;
-                VRHandler::log(inputOss.str());
+        }
+        if (handler->gestureHandler) {
+            const HandGestures& gestures = handler->gestures;
+            for (int i = 0; i < gestures.getEventCount(); i++) {
+                handler->gestureHandler(gestures.getEvent(i));
             }
         }
-        handler->frameHandler(time, modelMatrix, views, handData);
+        {
+            FrameProfiler::Scope scope(handler->profiler, FrameProfiler::FrameCallback);
+            handler->frameHandler(time, modelMatrix, views, handData);
+        }
+        handler->endFrame();
+    }
+}
+
+void desktopLoopWrapper() {
+    VRHandler* handler = VRHandler::getInstance();
+    if (handler && handler->desktopHandler && !handler->vrSessionActive) {
+        handler->desktopHandler();
     }
 }
 
 void sessionStartCallbackWrapper(void* userData) {
     VRHandler* handler = VRHandler::getInstance();
     if (handler) {
-        VRHandler::log("WebXR session started");
+        VRLOG_INFO("WebXR session started");
+        VRLog::flush();
         handler->setSessionActive(true);
+        // The session's requestAnimationFrame drives frames from here on
+        emscripten_pause_main_loop();
         if (handler->sessionStartHandler) {
             handler->sessionStartHandler();
         }
@@ -96,8 +100,20 @@ void sessionStartCallbackWrapper(void* userData) {
 void sessionEndCallbackWrapper(void* userData) {
     VRHandler* handler = VRHandler::getInstance();
     if (handler) {
-        VRHandler::log("WebXR session ended");
+        VRLOG_INFO("WebXR session ended");
+        VRLog::flush();
         handler->setSessionActive(false);
+        handler->inputSnapshot.count = 0;
+        // Events still queued belong to the ended session
+        handler->inputQueue.tail = handler->inputQueue.head;
+        handler->inputEventCount = 0;
+        handler->handViews[0] = handler->handViews[1] = nullptr;
+        handler->posePredictor.reset();
+        handler->gestures.reset();
+        handler->resolution.reset();
+        handler->runtimeFoveation = false;
+        handler->sessionQueried = false;
+        emscripten_resume_main_loop();
         if (handler->sessionEndHandler) {
             handler->sessionEndHandler();
         }
@@ -107,15 +123,19 @@ void sessionEndCallbackWrapper(void* userData) {
 void errorCallbackWrapper(void* userData, int error) {
     VRHandler* handler = VRHandler::getInstance();
     if (handler) {
-        VRHandler::log("WebXR error occurred");
+        VRLOG_ERROR("WebXR error %d occurred", error);
+        VRLog::flush();
         if (handler->errorHandler) {
             handler->errorHandler(error);
         }
     }
 }
 
-VRHandler::VRHandler() : vrSessionActive(false), handTrackingActive(false), isARSession(false) {
+VRHandler::VRHandler() : vrSessionActive(false), sessionQueried(false), handTrackingActive(false), isARSession(false), frameData(), inputSnapshot(), frameStats(), inputQueue(), inputEvents(), inputEventCount(0), inputEventStats(), handViews(), handJoints(), handJointsValid(false),
+    posePrediction(false), frameStartTime(0.0), callbackLatency(0.0f), gestureRecognition(false), dynamicResolution(false), glCallCounting(false),
+    stereoMode(StereoMode::MultiPass), stereoStats(), runtimeFoveation(false), softwareFoveation(false), clearColor{ 102, 178, 255, 255 }, instancedHandJoints(true) {
     instance = this;
+    VRLog::setSink(console_log_vr);
 }
 
 VRHandler::~VRHandler() {
@@ -125,20 +145,131 @@ VRHandler::~VRHandler() {
 }
 
 void VRHandler::initialize() {
+    initializeBackend(frameCallbackWrapper, nullptr);
+}
+
+void VRHandler::initializeBackend(webxr_frame_callback_func frameCallback, void* userData) {
     init_webgl_context_vr();
     
+    webxr_set_frame_buffers(frameData.views, frameData.modelMatrix, frameData.hands);
+    webxr_set_input_snapshot_buffer(&inputSnapshot);
+    webxr_set_frame_stats_buffer(&frameStats);
+    // The library clears both eyes with one full-layer clear before each frame
+    setClearColor(clearColor);
+
     webxr_init(
         WEBXR_SESSION_MODE_IMMERSIVE_VR,
-        frameCallbackWrapper,
+        frameCallback,
         sessionStartCallbackWrapper,
         sessionEndCallbackWrapper,
         errorCallbackWrapper,
-        nullptr
+        userData
     );
     
-    webxr_set_select_callback(onControllerSelect, nullptr);
-    webxr_set_select_start_callback(onControllerSelectStart, nullptr);
-    webxr_set_select_end_callback(onControllerSelectEnd, nullptr);
+    // Select events are queued by the library and drained at the start of each frame
+    webxr_set_input_event_queue(&inputQueue);
+}
+
+void VRHandler::beginFrame(int time) {
+    frameStartTime = FrameProfiler::now();
+    frameArena.beginFrame();
+
+    if (!vrSessionActive) {
+        setSessionActive(true);
+        emscripten_pause_main_loop();
+        setHandTracking(webxr_is_hand_tracking_supported());
+        
+        if (handTrackingActive) {
+            VRLOG_INFO("Hand tracking is active!");
+        } else {
+            VRLOG_INFO("Hand tracking not available, will show controllers");
+        }
+        
+        if (isARSession) {
+            VRLOG_INFO("AR session started");
+        } else {
+            VRLOG_INFO("VR session started");
+        }
+        
+        const WebXRInputSnapshot& snapshot = inputSnapshot;
+        VRLOG_INFO("Detected %d input sources", snapshot.count);
+        
+        for (int i = 0; i < snapshot.count; i++) {
+            const WebXRInputSource& source = snapshot.inputs[i].source;
+            VRLOG_DEBUG("Input %d: Handedness=%d, HasController=%d, HasHand=%d",
+                        i, source.handedness, source.hasController, source.hasHand);
+        }
+    }
+    // The session start callback runs before the layer exists, so what the
+    // session and its layer support is read on the first frame
+    if (!sessionQueried) {
+        sessionQueried = true;
+        setARSession(webxr_is_ar_session());
+        runtimeFoveation = webxr_is_fixed_foveation_supported() != 0;
+    }
+    // Hands come and go during a session (controllers put down), so follow the snapshot
+    // rather than the first frame; the session start callback also skips that block
+    bool hasHand = false;
+    for (int i = 0; i < inputSnapshot.count; i++) {
+        if (inputSnapshot.inputs[i].source.hasHand) hasHand = true;
+    }
+    setHandTracking(hasHand);
+
+    for (int hand = 0; hand < 2; hand++) {
+        handViews[hand] = handTrackingActive ? webxr_get_hand_view(frameData.hands, hand) : nullptr;
+    }
+    handJointsValid = false;
+
+    drainInputEvents(time);
+
+    if (recorder.isRecording()) {
+        recorder.recordFrame(time, frameData, inputSnapshot, frameStats);
+    }
+    if (posePrediction) {
+        float horizon = frameStats.predictedDisplayDelta + callbackLatency;
+        posePredictor.predict(time, horizon, inputSnapshot, frameData.hands, frameData.handDetected);
+    }
+    if (gestureRecognition) {
+        FrameProfiler::Scope scope(profiler, FrameProfiler::Gestures);
+        const float headPosition[3] = { frameData.modelMatrix[12], frameData.modelMatrix[13], frameData.modelMatrix[14] };
+        gestures.update(getHandJointsSoA(), headPosition);
+    }
+    profiler.record(FrameProfiler::JsMarshal, frameStats.marshalTime);
+}
+
+void VRHandler::joinFrameJobs() {
+    if (frameJobs.isDone()) return;
+    FrameProfiler::Scope scope(profiler, FrameProfiler::JobWait);
+    jobs.wait(frameJobs);
+}
+
+void VRHandler::endFrame() {
+    // Jobs the frame handler did not join through renderStereo
+    joinFrameJobs();
+
+    float duration = (float)(FrameProfiler::now() - frameStartTime);
+    callbackLatency += 0.1f * (duration - callbackLatency);
+    profiler.recordCounter(FrameProfiler::FrameArenaBytes, (float)frameArena.getStats().used);
+
+    if (dynamicResolution) {
+        float previous = resolution.getScale();
+        float scale = resolution.update(frameStats.marshalTime + duration, frameStats.frameInterval, frameStats.targetFrameRate);
+        if (scale != previous) webxr_request_viewport_scale(scale);
+    }
+
+    // Everything logged since the last frame, select events included, goes out in one call
+    VRLog::flush();
+}
+
+void VRHandler::runDesktopLoop(DesktopCallback drawDesktop) {
+    desktopHandler = drawDesktop;
+    // fps 0: paced by the browser's requestAnimationFrame, natively by SetTargetFPS
+    emscripten_set_main_loop(desktopLoopWrapper, 0, 1);
+}
+
+void VRHandler::stopDesktopLoop() {
+    emscripten_cancel_main_loop();
+    desktopHandler = nullptr;
 }
 
 void VRHandler::requestVRSession() {
@@ -175,14 +306,17 @@ void VRHandler::setFrameHandler(FrameCallback handler) {
     frameHandler = handler;
 }
 
+void VRHandler::setGestureHandler(GestureCallback handler) {
+    gestureHandler = handler;
+}
+
+void VRHandler::setInputEventHandler(InputEventCallback handler) {
+    inputEventHandler = handler;
+}
+
 void VRHandler::processControllers() {
-    WebXRInputSource inputSources[16];
-    int inputCount = 0;
-    
-    webxr_get_input_sources(inputSources, 16, &inputCount);
-    
-    for (int i = 0; i < inputCount; i++) {
-        WebXRInputSource* source = &inputSources[i];
+    for (int i = 0; i < inputSnapshot.count; i++) {
+        WebXRInputSource* source = &inputSnapshot.inputs[i].source;
         if (controllerHandler && source->hasController) {
             controllerHandler(source, i);
         }
@@ -191,34 +325,31 @@ void VRHandler::processControllers() {
 
 void VRHandler::processHands(void* handData) {
     if (handHandler && handTrackingActive && handData) {
-        WebXRHandData leftHand, rightHand;
-        WebXRHandData* leftHandPtr = nullptr;
-        WebXRHandData* rightHandPtr = nullptr;
-        
-        if (webxr_get_hand_data(handData, 0, &leftHand)) {
-            leftHandPtr = &leftHand;
-        }
-        
-        if (webxr_get_hand_data(handData, 1, &rightHand)) {
-            rightHandPtr = &rightHand;
-        }
-        
-        handHandler(leftHandPtr, rightHandPtr);
+        handHandler(handView(handData, 0), handView(handData, 1));
     }
 }
 
+const WebXRHandData* VRHandler::handView(void* handData, int handedness) const {
+    // The frame block was validated in beginFrame; anything else is checked here
+    if (handData == frameData.hands) return handViews[handedness];
+    return webxr_get_hand_view(handData, handedness);
+}
+
+const WebXRHandJointsSoA& VRHandler::getHandJointsSoA() {
+    if (!handJointsValid) {
+        webxr_get_hand_joints_soa(handTrackingActive ? frameData.hands : nullptr, &handJoints);
+        handJointsValid = true;
+    }
+    return handJoints;
+}
+
 void VRHandler::drawControllers() {
-    WebXRInputSource inputSources[16];
-    int inputCount = 0;
-    
-    webxr_get_input_sources(inputSources, 16, &inputCount);
-    
-    for (int i = 0; i < inputCount; i++) {
-        WebXRInputSource* source = &inputSources[i];
+    for (int i = 0; i < inputSnapshot.count; i++) {
+        const WebXRInputState& input = inputSnapshot.inputs[i];
+        const WebXRInputSource* source = &input.source;
         
-        if (source->hasController) {
-            float poseMatrix[16];
-            webxr_get_input_pose(source, poseMatrix);
+        if (source->hasController && input.hasGripPose) {
+            const float* poseMatrix = input.gripMatrix;
             
             Vector3 controllerPos = {
                 poseMatrix[12],
@@ -248,50 +379,178 @@ void VRHandler::drawControllers() {
 
 void VRHandler::drawHands(void* handData) {
     if (handTrackingActive && handData) {
-        WebXRHandData leftHand, rightHand;
+        const WebXRHandData* leftHand = handView(handData, 0);
+        const WebXRHandData* rightHand = handView(handData, 1);
         
-        if (webxr_get_hand_data(handData, 0, &leftHand)) {
-            drawHand(&leftHand, BLUE);
+        if (!instancedHandJoints) {
+            if (leftHand) drawHand(leftHand, BLUE);
+            if (rightHand) drawHand(rightHand, RED);
+            return;
         }
         
-        if (webxr_get_hand_data(handData, 1, &rightHand)) {
-            drawHand(&rightHand, RED);
+        // Joints of both hands go out as a single instanced draw
+        if (leftHand) {
+            jointRenderer.addHand(leftHand, BLUE);
+            drawHandBones(leftHand, BLUE);
         }
+        if (rightHand) {
+            jointRenderer.addHand(rightHand, RED);
+            drawHandBones(rightHand, RED);
+        }
+        jointRenderer.draw();
     }
 }
 
-Matrix VRHandler::webXRToRaylibMatrix(float webxrMatrix[16]) {
-    Matrix result;
-    result.m0 = webxrMatrix[0];   result.m4 = webxrMatrix[4];   result.m8 = webxrMatrix[8];    result.m12 = webxrMatrix[12];
-    result.m1 = webxrMatrix[1];   result.m5 = webxrMatrix[5];   result.m9 = webxrMatrix[9];    result.m13 = webxrMatrix[13];
-    result.m2 = webxrMatrix[2];   result.m6 = webxrMatrix[6];   result.m10 = webxrMatrix[10];  result.m14 = webxrMatrix[14];
-    result.m3 = webxrMatrix[3];   result.m7 = webxrMatrix[7];   result.m11 = webxrMatrix[11];  result.m15 = webxrMatrix[15];
-    return result;
+Matrix VRHandler::webXRToRaylibMatrix(const float webxrMatrix[16]) {
+    return VRMath::fromWebXR(webxrMatrix);
 }
 
 Matrix VRHandler::invertWebXRViewMatrix(Matrix webxrViewMatrix) {
-    return MatrixInvert(webxrViewMatrix);
+    // WebXR view transforms are rigid, so the transpose-based inverse is exact
+    return VRMath::rigidInverse(webxrViewMatrix);
+}
+
+bool VRHandler::canRenderSinglePass(const WebXRView* views) const {
+    // rlgl stereo rendering splits the framebuffer into two equal halves, left eye first
+    const int* left = views[0].viewport;
+    const int* right = views[1].viewport;
+    return left[0] == 0 && left[1] == 0 &&
+           right[0] == left[2] && right[1] == 0 &&
+           right[2] == left[2] && right[3] == left[3];
+}
+
+void VRHandler::renderStereo(WebXRView* views, EyeDrawFunction drawScene, void* userData) {
+    // Simulation and culling jobs finish before anything is drawn from their results
+    joinFrameJobs();
+    stereoStats = {};
+
+    Matrix projection[2];
+    Matrix view[2];
+    VRMath::convertViews(views, projection, view);
+
+    bool foveatedPasses = softwareFoveation && foveation.isActive() && !runtimeFoveation;
+    if (stereoMode == StereoMode::SinglePass && !foveatedPasses && canRenderSinglePass(views)) {
+        int prevWidth = rlGetFramebufferWidth();
+        int prevHeight = rlGetFramebufferHeight();
+        rlSetFramebufferWidth(views[0].viewport[2] * 2);
+        rlSetFramebufferHeight(views[0].viewport[3]);
+
+        // Vertices are recorded in world space; the batch is uploaded once and
+        // drawn per eye with modelview = viewOffset[eye], projection = projection[eye].
+        // Index 0 is the left half despite rlgl's (right, left) parameter names.
+        rlSetMatrixProjectionStereo(projection[0], projection[1]);
+        rlSetMatrixViewOffsetStereo(view[0], view[1]);
+        rlSetMatrixModelview(MatrixIdentity());
+        rlEnableStereoRender();
+
+        {
+            FrameProfiler::Scope scope(profiler, FrameProfiler::StereoDraw);
+            drawScene(userData, -1);
+            stereoStats.scenePasses++;
+        }
+        {
+            FrameProfiler::Scope scope(profiler, FrameProfiler::BatchFlush);
+            rlDrawRenderBatchActive();
+            stereoStats.batchFlushes++;
+        }
+
+        rlDisableStereoRender();
+        stereoStats.pixelsShaded = 2 * views[0].viewport[2] * views[0].viewport[3];
+        rlSetFramebufferWidth(prevWidth);
+        rlSetFramebufferHeight(prevHeight);
+        return;
+    }
+
+    // The periphery mask works through the depth test
+    if (foveatedPasses) rlEnableDepthTest();
+    for (int eye = 0; eye < 2; eye++) {
+        if (foveatedPasses) {
+            renderFoveatedEye(eye, views[eye], projection[eye], view[eye], drawScene, userData);
+            continue;
+        }
+
+        auto& viewport = views[eye].viewport;
+        setViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+        drawEyePass(eye, projection[eye], view[eye], drawScene, userData);
+        stereoStats.pixelsShaded += viewport[2] * viewport[3];
+    }
+    if (foveatedPasses) rlDisableDepthTest();
+}
+
+void VRHandler::drawEyePass(int eye, const Matrix& projection, const Matrix& view, EyeDrawFunction drawScene, void* userData) {
+    rlSetMatrixProjection(projection);
+    rlSetMatrixModelview(view);
+
+    {
+        FrameProfiler::Scope scope(profiler, eye == 0 ? FrameProfiler::LeftEyeDraw : FrameProfiler::RightEyeDraw);
+        drawScene(userData, eye);
+        stereoStats.scenePasses++;
+    }
+    {
+        FrameProfiler::Scope scope(profiler, FrameProfiler::BatchFlush);
+        rlDrawRenderBatchActive();
+        stereoStats.batchFlushes++;
+    }
+}
+
+void VRHandler::renderFoveatedEye(int eye, const WebXRView& eyeView, const Matrix& projection, const Matrix& view,
+                                  EyeDrawFunction drawScene, void* userData) {
+    const int* viewport = eyeView.viewport;
+
+    // Periphery at reduced resolution, offscreen
+    FoveatedRenderer::Rect center = foveation.centerRect(viewport, eyeView.projectionMatrix);
+    stereoStats.pixelsShaded += foveation.beginPeriphery(eye, viewport, center);
+    drawEyePass(eye, projection, view, drawScene, userData);
+
+    bind_layer_framebuffer_vr();
+    setViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    {
+        FrameProfiler::Scope scope(profiler, FrameProfiler::FoveationComposite);
+        foveation.composite(eye, viewport[2], viewport[3]);
+    }
+
+    // Center again at full resolution on top
+    stereoStats.pixelsShaded += foveation.beginCenter(center);
+    drawEyePass(eye, projection, view, drawScene, userData);
+    foveation.endCenter();
+}
+
+void VRHandler::setFoveation(float level) {
+    webxr_set_fixed_foveation(level);
+    foveation.setLevel(level);
+    if (sessionQueried) runtimeFoveation = webxr_is_fixed_foveation_supported() != 0;
 }
 
 void VRHandler::drawHandJoint(Vector3 position, float radius, Color color) {
     DrawSphere(position, radius, color);
 }
 
-void VRHandler::drawHand(WebXRHandData* handData, Color color) {
+void VRHandler::drawHand(const WebXRHandData* handData, Color color) {
     if (!handData) return;
     
-    for (int i = 0; i < WEBXR_HAND_JOINT_COUNT; i++) {
-        Vector3 pos = {
-            handData->joints[i].position[0],
-            handData->joints[i].position[1],
-            handData->joints[i].position[2]
-        };
-        float radius = handData->joints[i].radius;
-        if (radius > 0.0f) {
-            drawHandJoint(pos, radius, color);
+    if (instancedHandJoints) {
+        jointRenderer.addHand(handData, color);
+        jointRenderer.draw();
+    } else {
+        for (int i = 0; i < WEBXR_HAND_JOINT_COUNT; i++) {
+            Vector3 pos = {
+                handData->joints[i].position[0],
+                handData->joints[i].position[1],
+                handData->joints[i].position[2]
+            };
+            float radius = handData->joints[i].radius;
+            if (radius > 0.0f) {
+                drawHandJoint(pos, radius, color);
+            }
         }
     }
     
+    drawHandBones(handData, color);
+}
+
+void VRHandler::drawHandBones(const WebXRHandData* handData, Color color) {
+    if (!handData) return;
+    
     static const int fingerStarts[5] = {1, 5, 10, 15, 20};
     static const int fingerLengths[5] = {4, 5, 5, 5, 5};
     
@@ -335,49 +594,32 @@ void VRHandler::drawHand(WebXRHandData* handData, Color color) {
     }
 }
 
-void VRHandler::onControllerSelect(WebXRInputSource* inputSource, void* userData) {
-    VRHandler* handler = VRHandler::getInstance();
-    if (handler && handler->controllerHandler) {
-        log("Controller SELECT pressed!");
-        
-        std::string handedness = (inputSource->handedness == WEBXR_HANDEDNESS_LEFT) ? "Left" : 
-                                (inputSource->handedness == WEBXR_HANDEDNESS_RIGHT) ? "Right" : "None";
-        
-        std::ostringstream oss;
-        oss << "SELECT - Controller ID: " << inputSource->id << ", Handedness: " << handedness;
-        log(oss.str());
-    }
+const char* VRHandler::handednessName(int handedness) {
+    return handedness == WEBXR_HANDEDNESS_LEFT ? "Left" :
+           handedness == WEBXR_HANDEDNESS_RIGHT ? "Right" : "None";
 }
 
-void VRHandler::onControllerSelectStart(WebXRInputSource* inputSource, void* userData) {
-    VRHandler* handler = VRHandler::getInstance();
-    if (handler && handler->controllerHandler) {
-        log("Controller SELECT START!");
-        
-        std::string handedness = (inputSource->handedness == WEBXR_HANDEDNESS_LEFT) ? "Left" : 
-                                (inputSource->handedness == WEBXR_HANDEDNESS_RIGHT) ? "Right" : "None";
-        
-        std::ostringstream oss;
-        oss << "SELECT START - Controller ID: " << inputSource->id 
-            << ", Handedness: " << handedness
-            << ", HasController: " << inputSource->hasController 
-            << ", HasHand: " << inputSource->hasHand;
-        log(oss.str());
-    }
-}
+void VRHandler::drainInputEvents(int time) {
+    static const char* typeNames[] = { "SELECT", "SELECT START", "SELECT END" };
 
-void VRHandler::onControllerSelectEnd(WebXRInputSource* inputSource, void* userData) {
-    VRHandler* handler = VRHandler::getInstance();
-    if (handler && handler->controllerHandler) {
-        log("Controller SELECT END!");
-        
-        std::string handedness = (inputSource->handedness == WEBXR_HANDEDNESS_LEFT) ? "Left" : 
-                                (inputSource->handedness == WEBXR_HANDEDNESS_RIGHT) ? "Right" : "None";
-        
-        std::ostringstream oss;
-        oss << "SELECT END - Controller ID: " << inputSource->id << ", Handedness: " << handedness;
-        log(oss.str());
+    unsigned int head = __atomic_load_n(&inputQueue.head, __ATOMIC_ACQUIRE);
+    unsigned int tail = inputQueue.tail;
+    inputEventCount = std::min((int)(head - tail), WEBXR_INPUT_EVENT_CAPACITY);
+
+    for (int i = 0; i < inputEventCount; i++) {
+        const WebXRInputEvent& event = inputQueue.events[(tail + i) % WEBXR_INPUT_EVENT_CAPACITY];
+        inputEvents[i] = event;
+        inputEventStats.maxAge = std::max(inputEventStats.maxAge, (float)(time - event.timestamp));
+        VRLOG_DEBUG("%s - Controller ID: %d, Handedness: %s, HasController: %d, HasHand: %d",
+                    typeNames[event.type], event.source.id, handednessName(event.source.handedness),
+                    event.source.hasController, event.source.hasHand);
     }
+    // Slots are free for the library again once copied out
+    __atomic_store_n(&inputQueue.tail, head, __ATOMIC_RELEASE);
+
+    inputEventStats.received += inputEventCount;
+    inputEventStats.dropped = (int)__atomic_load_n(&inputQueue.dropped, __ATOMIC_RELAXED);
+    inputEventStats.maxPerFrame = std::max(inputEventStats.maxPerFrame, inputEventCount);
 }
 
 void VRHandler::setViewport(int x, int y, int width, int height) {
@@ -385,9 +627,69 @@ void VRHandler::setViewport(int x, int y, int width, int height) {
 }
 
 void VRHandler::clearViewport(int x, int y, int width, int height) {
-    clear_viewport_vr(x, y, width, height);
+    clear_viewport_vr(x, y, width, height, clearColor.r, clearColor.g, clearColor.b, clearColor.a);
+}
+
+void VRHandler::setClearColor(Color color) {
+    clearColor = color;
+    foveation.setClearColor(color);
+    webxr_set_clear_color(color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f);
 }
 
-void VRHandler::log(const std::string& message) {
-    console_log_vr(message.c_str());
+bool VRHandler::startRecording(const char* path) {
+    int mode = isARSession ? WEBXR_SESSION_MODE_IMMERSIVE_AR : WEBXR_SESSION_MODE_IMMERSIVE_VR;
+    if (!recorder.start(path, mode)) {
+        VRLOG_ERROR("Could not open session trace %s for writing", path);
+        VRLog::flush();
+        return false;
+    }
+    recordingPath = path;
+    VRLOG_INFO("Recording WebXR session to %s", path);
+    VRLog::flush();
+    return true;
+}
+
+void VRHandler::stopRecording() {
+    if (!recorder.isRecording()) return;
+
+    int frames = recorder.getFrameCount();
+    recorder.stop();
+
+    VRLOG_INFO("Recorded %d frames to %s", frames, recordingPath.c_str());
+    VRLog::flush();
+    download_file_vr(recordingPath.c_str());
+}
+
+void VRHandler::setGestureRecognition(bool enabled) {
+    // The frame callbacks dispatch whatever events the last update() left
+    if (!enabled) gestures.reset();
+    gestureRecognition = enabled;
+}
+
+void VRHandler::setDynamicResolution(bool enabled) {
+    dynamicResolution = enabled;
+    resolution.reset();
+    webxr_request_viewport_scale(resolution.getScale());
+}
+
+void VRHandler::dumpProfile() const {
+    // Longer than a log line, so it skips the ring
+    VRLog::flush();
+    console_log_vr(profiler.toJson().c_str());
+    if (posePrediction) {
+        console_log_vr(("{\"prediction\":" + posePredictor.toJson() + "}").c_str());
+    }
+    if (dynamicResolution) {
+        console_log_vr(("{\"resolution\":" + resolution.toJson() + "}").c_str());
+    }
+    if (glCallCounting) {
+        char gl[96];
+        snprintf(gl, sizeof(gl), "{\"gl\":{\"calls\":%d,\"skipped\":%d}}", frameStats.glCalls, frameStats.glCallsSkipped);
+        console_log_vr(gl);
+    }
+    JobSystem::Stats jobStats = jobs.getStats();
+    char jobLine[128];
+    snprintf(jobLine, sizeof(jobLine), "{\"jobs\":{\"workers\":%d,\"executed\":%lld,\"stolen\":%lld,\"inlined\":%lld}}",
+             jobStats.workers, jobStats.jobs, jobStats.stolen, jobStats.inlined);
+    console_log_vr(jobLine);
 }
\ No newline at end of file
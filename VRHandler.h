@@ -1,23 +1,94 @@
 #pragma once
 
 #include "raylib.h"
+#include "HandJointRenderer.h"
+#include "FoveatedRenderer.h"
+#include "FrameArena.h"
+#include "FrameProfiler.h"
+#include "JobSystem.h"
+#include "SessionTrace.h"
+#include "PosePredictor.h"
+#include "HandGestures.h"
+#include "ResolutionController.h"
+#include "VRLog.h"
 #include <webxr.h>
 #include <functional>
 #include <string>
-#include <sstream>
 
 class VRHandler {
 public:
     using ControllerCallback = std::function<void(WebXRInputSource* source, int sourceId)>;
-    using HandCallback = std::function<void(WebXRHandData* leftHand, WebXRHandData* rightHand)>;
+    using HandCallback = std::function<void(const WebXRHandData* leftHand, const WebXRHandData* rightHand)>;
     using SessionCallback = std::function<void()>;
     using ErrorCallback = std::function<void(int error)>;
     using FrameCallback = std::function<void(int time, float modelMatrix[16], WebXRView* views, void* handData)>;
+    // Called once per scene pass from renderStereo; no std::function on the draw path
+    typedef void (*EyeDrawFunction)(void* userData, int eye);
+    using GestureCallback = std::function<void(const HandGestures::Event& event)>;
+    using InputEventCallback = std::function<void(const WebXRInputEvent& event)>;
+    using DesktopCallback = std::function<void()>;
+
+    /** MultiPass draws the scene once per eye, SinglePass records it once and lets rlgl replay the batch for both eyes */
+    enum class StereoMode { MultiPass, SinglePass };
+
+    struct InputEventStats {
+        int received;       // events drained over the session
+        int dropped;        // events the library could not queue because the ring was full
+        int maxPerFrame;    // most events drained by one frame
+        float maxAge;       // ms, longest wait from dispatch to the frame that drained it
+    };
+
+    struct StereoStats {
+        int scenePasses;    // calls into the scene draw function
+        int batchFlushes;   // rlDrawRenderBatchActive calls issued by renderStereo
+        int pixelsShaded;   // render target area covered by scene passes (no overdraw, runtime foveation not seen)
+    };
 
 private:
     bool vrSessionActive;
+    bool sessionQueried;     // AR mode and runtime foveation read on this session's first frame
     bool handTrackingActive;
     bool isARSession;
+
+    WebXRFrameData frameData;
+    WebXRInputSnapshot inputSnapshot;
+    WebXRFrameStats frameStats;
+    WebXRInputEventQueue inputQueue;     // filled by the library between frames
+    WebXRInputEvent inputEvents[WEBXR_INPUT_EVENT_CAPACITY];   // drained in beginFrame
+    int inputEventCount;
+    InputEventStats inputEventStats;
+    const WebXRHandData* handViews[2];   // into frameData.hands, validated in beginFrame
+    WebXRHandJointsSoA handJoints;       // filled on first request each frame
+    bool handJointsValid;
+    FrameProfiler profiler;
+    FrameArena frameArena;
+    JobSystem jobs;
+    JobSystem::Group frameJobs;
+    SessionRecorder recorder;
+    std::string recordingPath;
+
+    PosePredictor posePredictor;
+    bool posePrediction;
+    double frameStartTime;
+    float callbackLatency;   // smoothed frame callback duration, ms
+
+    HandGestures gestures;
+    bool gestureRecognition;
+
+    ResolutionController resolution;
+    bool dynamicResolution;
+    bool glCallCounting;
+
+    StereoMode stereoMode;
+    StereoStats stereoStats;
+
+    FoveatedRenderer foveation;
+    bool runtimeFoveation;   // the layer applies fixedFoveation itself
+    bool softwareFoveation;  // FoveatedRenderer where the runtime has no fixedFoveation
+    Color clearColor;
+
+    HandJointRenderer jointRenderer;
+    bool instancedHandJoints;
     
     ControllerCallback controllerHandler;
     HandCallback handHandler;
@@ -25,16 +96,24 @@ private:
     SessionCallback sessionEndHandler;
     ErrorCallback errorHandler;
     FrameCallback frameHandler;
+    GestureCallback gestureHandler;
+    InputEventCallback inputEventHandler;
+    DesktopCallback desktopHandler;
 
-    static void onControllerSelect(WebXRInputSource* inputSource, void* userData);
-    static void onControllerSelectStart(WebXRInputSource* inputSource, void* userData);
-    static void onControllerSelectEnd(WebXRInputSource* inputSource, void* userData);
+    void drainInputEvents(int time);
+    void joinFrameJobs();
+    static const char* handednessName(int handedness);
+    const WebXRHandData* handView(void* handData, int handedness) const;
+    void drawEyePass(int eye, const Matrix& projection, const Matrix& view, EyeDrawFunction drawScene, void* userData);
+    void renderFoveatedEye(int eye, const WebXRView& eyeView, const Matrix& projection, const Matrix& view,
+                           EyeDrawFunction drawScene, void* userData);
 
 public:
     VRHandler();
-    ~VRHandler();
+    virtual ~VRHandler();
 
-    void initialize();
+    // Registers with the WebXR backend; VRHandlerT overrides it with its own frame callback
+    virtual void initialize();
     void requestVRSession();
     void requestARSession();
     
@@ -44,32 +123,144 @@ public:
     void setSessionEndHandler(SessionCallback handler);
     void setErrorHandler(ErrorCallback handler);
     void setFrameHandler(FrameCallback handler);
+    void setGestureHandler(GestureCallback handler);
+    void setInputEventHandler(InputEventCallback handler);
     
+    // Calls drawDesktop once per display frame outside XR sessions, through
+    // emscripten_set_main_loop: the loop pauses while a session runs, so the XR
+    // frame callback has the thread to itself. On the web this never returns
+    // (main unwinds and the loop lives on); natively it returns once the window closes.
+    void runDesktopLoop(DesktopCallback drawDesktop);
+    void stopDesktopLoop();
+
     void processControllers();
     void processHands(void* handData);
     
     bool isVRSessionActive() const { return vrSessionActive; }
     bool isHandTrackingActive() const { return handTrackingActive; }
     bool isARSessionActive() const { return isARSession; }
+    const WebXRFrameData& getFrameData() const { return frameData; }
+    const WebXRInputSnapshot& getInputSnapshot() const { return inputSnapshot; }
+    // Select events dispatched since the previous frame, oldest first, each with
+    // the poses at dispatch time; also passed to the input event handler
+    int getInputEventCount() const { return inputEventCount; }
+    const WebXRInputEvent& getInputEvent(int index) const { return inputEvents[index]; }
+    const InputEventStats& getInputEventStats() const { return inputEventStats; }
+    // This frame's tracked hand (0 left, 1 right) or nullptr; points into the frame block, no copy
+    const WebXRHandData* getHand(int handedness) const { return handViews[handedness]; }
+    // Joints of both hands as structure of arrays, gathered at most once per frame
+    const WebXRHandJointsSoA& getHandJointsSoA();
+    FrameProfiler& getProfiler() { return profiler; }
+    // Scratch memory for the frame handler, reset at the start of every frame callback;
+    // allocations stay valid through the next frame. Use per frame shows up as the
+    // frameArenaBytes profiler counter.
+    FrameArena& getFrameArena() { return frameArena; }
+    // Worker threads for the frame handler to fan out culling, animation, gesture
+    // evaluation or physics. Jobs run in getFrameJobs() are joined before renderStereo
+    // draws and again at the end of the frame; the wait shows up as the jobWait phase.
+    JobSystem& getJobSystem() { return jobs; }
+    JobSystem::Group& getFrameJobs() { return frameJobs; }
+    // Threads including the frame thread; 0 for one per hardware thread. Not during a frame.
+    void setJobWorkers(int workers) { jobs.setWorkerCount(workers); }
+    // Logs the per-phase timing histograms as JSON
+    void dumpProfile() const;
+    // Counts WebGL calls per frame (WebXRFrameStats::glCalls, logged by dumpProfile); wraps every context method
+    void setGLCallCounting(bool enabled) { glCallCounting = enabled; webxr_set_gl_call_counting(enabled ? 1 : 0); }
+
+    // Records every frame payload into a binary trace for webxr_replay.cpp.
+    // On the web the file is offered as a download when recording stops.
+    bool startRecording(const char* path);
+    void stopRecording();
+    bool isRecording() const { return recorder.isRecording(); }
+
+    // Extrapolates grip and joint poses to the predicted display time plus the
+    // smoothed callback duration before the frame handler runs (traces keep raw poses)
+    void setPosePrediction(bool enabled) { posePrediction = enabled; }
+    bool isPosePredictionEnabled() const { return posePrediction; }
+    PosePredictor& getPosePredictor() { return posePredictor; }
+
+    // Classifies both hands (after prediction) before the frame handler runs;
+    // transitions go to the gesture handler, or App::onGesture with VRHandlerT.
+    // Turning it off drops the last frame's events and ends active gestures unreported.
+    void setGestureRecognition(bool enabled);
+    bool isGestureRecognitionEnabled() const { return gestureRecognition; }
+    const HandGestures& getGestures() const { return gestures; }
+
+    // Requests a per-eye viewport scale each frame from missed frames and CPU
+    // time (see ResolutionController.h). Scaled viewports no longer split the
+    // framebuffer in equal halves, so SinglePass falls back to MultiPass.
+    void setDynamicResolution(bool enabled);
+    bool isDynamicResolutionEnabled() const { return dynamicResolution; }
+    ResolutionController& getResolutionController() { return resolution; }
+    // Framebuffer size relative to the recommended one, for layers created after this call
+    void setFramebufferScale(float scale) { webxr_set_framebuffer_scale_factor(scale); }
     
     void drawControllers();
     void drawHands(void* handData);
     
-    Matrix webXRToRaylibMatrix(float webxrMatrix[16]);
+    Matrix webXRToRaylibMatrix(const float webxrMatrix[16]);
     Matrix invertWebXRViewMatrix(Matrix webxrViewMatrix);
     
     void drawHandJoint(Vector3 position, float radius, Color color);
-    void drawHand(WebXRHandData* handData, Color color);
+    void drawHand(const WebXRHandData* handData, Color color);
+    void drawHandBones(const WebXRHandData* handData, Color color);
+
+    // Instanced joints draw both hands with one call; off falls back to DrawSphere per joint
+    void setInstancedHandJoints(bool enabled) { instancedHandJoints = enabled; }
+    const HandJointRenderer::Stats& getHandJointStats() const { return jointRenderer.getStats(); }
+
+    // Shades the periphery of each eye at lower resolution, level 0 (off) to 1,
+    // with XRWebGLLayer.fixedFoveation where the runtime has it.
+    void setFoveation(float level);
+    float getFoveation() const { return foveation.getLevel(); }
+    bool isRuntimeFoveation() const { return runtimeFoveation; }
+    // Off by default: elsewhere FoveatedRenderer draws each eye twice and never
+    // single-pass, which costs more than it saves unless the scene is fill-bound
+    void setSoftwareFoveation(bool enabled) { softwareFoveation = enabled; }
+    bool isSoftwareFoveation() const { return softwareFoveation && foveation.isActive() && !runtimeFoveation; }
+
+    // Clears the layer before each frame, clearViewport and the software foveation passes
+    void setClearColor(Color color);
+    Color getClearColor() const { return clearColor; }
     
+    void setStereoMode(StereoMode mode) { stereoMode = mode; }
+    StereoMode getStereoMode() const { return stereoMode; }
+    const StereoStats& getStereoStats() const { return stereoStats; }
+    bool canRenderSinglePass(const WebXRView* views) const;
+
+    // Draws the scene for both eyes; the library has cleared the whole layer before the frame callback.
+    // drawScene receives the eye index, or -1 when one call covers both eyes.
+    void renderStereo(WebXRView* views, EyeDrawFunction drawScene, void* userData);
+    // Same for any callable taking the eye index, e.g. a lambda; it is called
+    // through a function pointer, never copied or allocated
+    template<typename DrawScene>
+    void renderStereo(WebXRView* views, const DrawScene& drawScene) {
+        renderStereo(views, [](void* userData, int eye) { (*static_cast<const DrawScene*>(userData))(eye); },
+                     const_cast<DrawScene*>(&drawScene));
+    }
+
     void setViewport(int x, int y, int width, int height);
     void clearViewport(int x, int y, int width, int height);
 
     static VRHandler* getInstance() { return instance; }
 
-    // Modern C++ logging methods
-    static void log(const std::string& message);
+    // Queued into VRLog and flushed once per frame; see VRLog.h for the level macros
+    static void log(const char* message) { VRLog::write(VRLOG_LEVEL_INFO, "%s", message); }
     template<typename... Args>
-    static void logf(const std::string& format, Args... args);
+    static void logf(const char* format, Args... args) {
+        static_assert(sizeof...(Args) > 0, "use log() for messages without arguments");
+        VRLog::write(VRLOG_LEVEL_INFO, format, args...);
+    }
+
+protected:
+    // Registers the frame buffers and callbacks with the WebXR backend.
+    // VRHandlerT passes its own trampoline here instead of frameCallbackWrapper.
+    void initializeBackend(webxr_frame_callback_func frameCallback, void* userData);
+
+    // Per-frame bookkeeping around the app's frame handler: session state on the
+    // first frame, trace recording and the JsMarshal sample; endFrame flushes the log
+    void beginFrame(int time);
+    void endFrame();
 
 private:
     static VRHandler* instance;
@@ -78,6 +269,7 @@ private:
     void setHandTracking(bool active) { handTrackingActive = active; }
     
     friend void frameCallbackWrapper(void* userData, int time, float modelMatrix[16], WebXRView* views, void* handData);
+    friend void desktopLoopWrapper();
     friend void sessionStartCallbackWrapper(void* userData);
     friend void sessionEndCallbackWrapper(void* userData);
     friend void errorCallbackWrapper(void* userData, int error);
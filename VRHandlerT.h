@@ -0,0 +1,76 @@
+#pragma once
+
+#include "VRHandler.h"
+
+// Statically bound alternative to the std::function handlers on VRHandler.
+//
+// The app derives from VRHandlerT<App> and defines the handlers as ordinary
+// member functions; the WebXR frame callback goes through a per-App
+// trampoline, so the frame, controller and hand handlers are direct calls
+// the compiler can inline.
+//
+//   class MyApp : public VRHandlerT<MyApp> {
+//   public:
+//       void onFrame(int time, float modelMatrix[16], WebXRView* views, void* handData);
+//       void onController(const WebXRInputSource* source, int sourceId);           // optional
+//       void onHands(const WebXRHandData* leftHand, const WebXRHandData* rightHand); // optional
+//       void onGesture(const HandGestures::Event& event);                          // optional
+//       void onInputEvent(const WebXRInputEvent& event);                           // optional
+//   };
+//
+// Session start/end and error notifications are rare and still use the
+// std::function setters inherited from VRHandler.
+template<typename App>
+class VRHandlerT : public VRHandler {
+public:
+    void initialize() override {
+        initializeBackend(frameTrampoline, this);
+    }
+
+    // Calls App::onController for every input source with a controller
+    void processControllers() {
+        const WebXRInputSnapshot& snapshot = getInputSnapshot();
+        for (int i = 0; i < snapshot.count; i++) {
+            const WebXRInputSource* source = &snapshot.inputs[i].source;
+            if (source->hasController) {
+                app().onController(source, i);
+            }
+        }
+    }
+
+    // Calls App::onHands with the tracked hands (nullptr for a missing hand)
+    void processHands(void* handData) {
+        if (!isHandTrackingActive() || !handData) return;
+
+        const WebXRHandData* leftHand = webxr_get_hand_view(handData, 0);
+        const WebXRHandData* rightHand = webxr_get_hand_view(handData, 1);
+        app().onHands(leftHand, rightHand);
+    }
+
+    // Defaults for apps that only care about frames
+    void onController(const WebXRInputSource* source, int sourceId) {}
+    void onHands(const WebXRHandData* leftHand, const WebXRHandData* rightHand) {}
+    void onGesture(const HandGestures::Event& event) {}
+    void onInputEvent(const WebXRInputEvent& event) {}
+
+private:
+    App& app() { return static_cast<App&>(*this); }
+
+    static void frameTrampoline(void* userData, int time, float modelMatrix[16], WebXRView* views, void* handData) {
+        VRHandlerT* self = static_cast<VRHandlerT*>(userData);
+        self->beginFrame(time);
+
+        for (int i = 0; i < self->getInputEventCount(); i++) {
+            self->app().onInputEvent(self->getInputEvent(i));
+        }
+        const HandGestures& gestures = self->getGestures();
+        for (int i = 0; i < gestures.getEventCount(); i++) {
+            self->app().onGesture(gestures.getEvent(i));
+        }
+        {
+            FrameProfiler::Scope scope(self->getProfiler(), FrameProfiler::FrameCallback);
+            self->app().onFrame(time, modelMatrix, views, handData);
+        }
+        self->endFrame();
+    }
+};
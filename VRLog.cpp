@@ -0,0 +1,69 @@
+#include "VRLog.h"
+#include <cstdarg>
+#include <cstdio>
+
+namespace {
+    struct Line {
+        char text[VRLog::LINE_SIZE];
+    };
+
+    Line lines[VRLog::LINE_COUNT];
+    uint32_t head = 0;      // next line to write
+    uint32_t tail = 0;      // oldest pending line
+    uint32_t dropped = 0;
+
+    // Every pending line plus its '\n', and the terminator
+    char batch[VRLog::LINE_COUNT * VRLog::LINE_SIZE + 1];
+
+    void stdoutSink(const char* text) {
+        fputs(text, stdout);
+        fputc('\n', stdout);
+        fflush(stdout);
+    }
+
+    VRLog::Sink sink = stdoutSink;
+}
+
+void VRLog::write(int level, const char* format, ...) {
+    if (head - tail == (uint32_t)LINE_COUNT) {
+        tail++;
+        dropped++;
+    }
+
+    Line& line = lines[head % LINE_COUNT];
+    int prefix = 0;
+    if (level >= VRLOG_LEVEL_ERROR) prefix = snprintf(line.text, sizeof(line.text), "ERROR: ");
+    else if (level >= VRLOG_LEVEL_WARN) prefix = snprintf(line.text, sizeof(line.text), "WARN: ");
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line.text + prefix, sizeof(line.text) - prefix, format, args);
+    va_end(args);
+    head++;
+}
+
+void VRLog::flush() {
+    if (head == tail) return;
+
+    size_t length = 0;
+    for (; tail != head; tail++) {
+        const char* text = lines[tail % LINE_COUNT].text;
+        if (length > 0) batch[length++] = '\n';
+        while (*text) batch[length++] = *text++;
+    }
+    batch[length] = '\0';
+
+    if (sink) sink(batch);
+}
+
+void VRLog::setSink(Sink newSink) {
+    sink = newSink;
+}
+
+int VRLog::getPendingCount() {
+    return (int)(head - tail);
+}
+
+uint32_t VRLog::getDroppedCount() {
+    return dropped;
+}
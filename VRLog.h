@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+
+// Allocation-free logging for the frame and input callbacks.
+//
+// Messages are formatted with vsnprintf into a fixed ring of lines and handed
+// to the sink in one batch by flush(), so a frame crosses into JS at most once
+// no matter how many events it logged. Levels below VRLOG_MIN_LEVEL compile
+// away entirely, arguments included.
+
+#define VRLOG_LEVEL_DEBUG 0
+#define VRLOG_LEVEL_INFO  1
+#define VRLOG_LEVEL_WARN  2
+#define VRLOG_LEVEL_ERROR 3
+#define VRLOG_LEVEL_NONE  4
+
+#ifndef VRLOG_MIN_LEVEL
+    #ifdef NDEBUG
+        #define VRLOG_MIN_LEVEL VRLOG_LEVEL_INFO
+    #else
+        #define VRLOG_MIN_LEVEL VRLOG_LEVEL_DEBUG
+    #endif
+#endif
+
+#define VRLOG_AT(level, ...) \
+    do { if ((level) >= VRLOG_MIN_LEVEL) VRLog::write((level), __VA_ARGS__); } while (0)
+
+#define VRLOG_DEBUG(...) VRLOG_AT(VRLOG_LEVEL_DEBUG, __VA_ARGS__)
+#define VRLOG_INFO(...)  VRLOG_AT(VRLOG_LEVEL_INFO, __VA_ARGS__)
+#define VRLOG_WARN(...)  VRLOG_AT(VRLOG_LEVEL_WARN, __VA_ARGS__)
+#define VRLOG_ERROR(...) VRLOG_AT(VRLOG_LEVEL_ERROR, __VA_ARGS__)
+
+class VRLog {
+public:
+    using Sink = void (*)(const char* text);
+
+    static const int LINE_SIZE = 160;   // longer messages are truncated
+    static const int LINE_COUNT = 64;   // pending lines; the oldest are dropped past this
+
+    // Formats one line into the ring. Not thread-safe: call from the main thread.
+    static void write(int level, const char* format, ...)
+#if defined(__GNUC__) || defined(__clang__)
+        __attribute__((format(printf, 2, 3)))
+#endif
+        ;
+
+    // Joins pending lines with '\n' and passes them to the sink in one call
+    static void flush();
+
+    // Defaults to stdout; VRHandler routes it to console.log
+    static void setSink(Sink sink);
+
+    static int getPendingCount();
+    static uint32_t getDroppedCount();
+};
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "raylib.h"
+#include <webxr.h>
+#include <math.h>
+
+// Vectorized matrix helpers for the per-frame WebXR -> raylib conversions.
+//
+// raylib's Matrix stores its fields row by row (m0 m4 m8 m12, m1 m5 ...), while
+// WebXR hands out column-major float[16], so a conversion is a 4x4 transpose.
+// View transforms are rigid (rotation + translation), so their inverse is the
+// transposed rotation and -R^T * t instead of a general cofactor inverse.
+//
+// Uses wasm SIMD128 when built with -msimd128, SSE on x86 native builds and
+// plain floats otherwise (or when VRMATH_NO_SIMD is defined).
+
+#if !defined(VRMATH_NO_SIMD) && defined(__wasm_simd128__)
+    #include <wasm_simd128.h>
+    #define VRMATH_WASM_SIMD
+#elif !defined(VRMATH_NO_SIMD) && (defined(__SSE__) || defined(_M_X64))
+    #include <xmmintrin.h>
+    #define VRMATH_SSE
+#endif
+
+namespace VRMath {
+
+#if defined(VRMATH_WASM_SIMD)
+
+    typedef v128_t Vec4;
+
+    static inline Vec4 load(const float* p) { return wasm_v128_load(p); }
+    static inline void store(float* p, Vec4 v) { wasm_v128_store(p, v); }
+    static inline Vec4 mul(Vec4 a, Vec4 b) { return wasm_f32x4_mul(a, b); }
+    static inline Vec4 add(Vec4 a, Vec4 b) { return wasm_f32x4_add(a, b); }
+    static inline Vec4 sub(Vec4 a, Vec4 b) { return wasm_f32x4_sub(a, b); }
+    static inline Vec4 div(Vec4 a, Vec4 b) { return wasm_f32x4_div(a, b); }
+    static inline Vec4 sqrt(Vec4 v) { return wasm_f32x4_sqrt(v); }
+    static inline Vec4 set(float x, float y, float z, float w) { return wasm_f32x4_make(x, y, z, w); }
+    static inline Vec4 splat(float x) { return wasm_f32x4_splat(x); }
+    static inline int signMask(Vec4 v) { return wasm_i32x4_bitmask(v); }
+    static inline Vec4 splatW(Vec4 v) { return wasm_i32x4_shuffle(v, v, 3, 3, 3, 3); }
+    static inline Vec4 withW(Vec4 v, float w) { return wasm_f32x4_replace_lane(v, 3, w); }
+    static inline Vec4 negate(Vec4 v) { return wasm_f32x4_neg(v); }
+
+    static inline void transpose(Vec4& r0, Vec4& r1, Vec4& r2, Vec4& r3) {
+        Vec4 t0 = wasm_i32x4_shuffle(r0, r1, 0, 4, 1, 5);
+        Vec4 t1 = wasm_i32x4_shuffle(r0, r1, 2, 6, 3, 7);
+        Vec4 t2 = wasm_i32x4_shuffle(r2, r3, 0, 4, 1, 5);
+        Vec4 t3 = wasm_i32x4_shuffle(r2, r3, 2, 6, 3, 7);
+        r0 = wasm_i32x4_shuffle(t0, t2, 0, 1, 4, 5);
+        r1 = wasm_i32x4_shuffle(t0, t2, 2, 3, 6, 7);
+        r2 = wasm_i32x4_shuffle(t1, t3, 0, 1, 4, 5);
+        r3 = wasm_i32x4_shuffle(t1, t3, 2, 3, 6, 7);
+    }
+
+#elif defined(VRMATH_SSE)
+
+    typedef __m128 Vec4;
+
+    static inline Vec4 load(const float* p) { return _mm_loadu_ps(p); }
+    static inline void store(float* p, Vec4 v) { _mm_storeu_ps(p, v); }
+    static inline Vec4 mul(Vec4 a, Vec4 b) { return _mm_mul_ps(a, b); }
+    static inline Vec4 add(Vec4 a, Vec4 b) { return _mm_add_ps(a, b); }
+    static inline Vec4 sub(Vec4 a, Vec4 b) { return _mm_sub_ps(a, b); }
+    static inline Vec4 div(Vec4 a, Vec4 b) { return _mm_div_ps(a, b); }
+    static inline Vec4 sqrt(Vec4 v) { return _mm_sqrt_ps(v); }
+    static inline Vec4 set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+    static inline Vec4 splat(float x) { return _mm_set1_ps(x); }
+    static inline int signMask(Vec4 v) { return _mm_movemask_ps(v); }
+    static inline Vec4 splatW(Vec4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)); }
+    static inline Vec4 negate(Vec4 v) { return _mm_xor_ps(v, _mm_set1_ps(-0.0f)); }
+
+    static inline Vec4 withW(Vec4 v, float w) {
+        // unpackhi gives [z w . w]; keep x y from v and take z w from it
+        Vec4 zw = _mm_unpackhi_ps(v, _mm_set1_ps(w));
+        return _mm_shuffle_ps(v, zw, _MM_SHUFFLE(3, 0, 1, 0));
+    }
+
+    static inline void transpose(Vec4& r0, Vec4& r1, Vec4& r2, Vec4& r3) {
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    }
+
+#else
+
+    struct Vec4 { float v[4]; };
+
+    static inline Vec4 load(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+    static inline void store(float* p, Vec4 a) { p[0] = a.v[0]; p[1] = a.v[1]; p[2] = a.v[2]; p[3] = a.v[3]; }
+    static inline Vec4 mul(Vec4 a, Vec4 b) { return { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+    static inline Vec4 add(Vec4 a, Vec4 b) { return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+    static inline Vec4 sub(Vec4 a, Vec4 b) { return { { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } }; }
+    static inline Vec4 div(Vec4 a, Vec4 b) { return { { a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3] } }; }
+    static inline Vec4 sqrt(Vec4 a) { return { { sqrtf(a.v[0]), sqrtf(a.v[1]), sqrtf(a.v[2]), sqrtf(a.v[3]) } }; }
+    static inline Vec4 set(float x, float y, float z, float w) { return { { x, y, z, w } }; }
+    static inline Vec4 splat(float x) { return { { x, x, x, x } }; }
+    static inline int signMask(Vec4 a) {
+        return (signbit(a.v[0]) ? 1 : 0) | (signbit(a.v[1]) ? 2 : 0) | (signbit(a.v[2]) ? 4 : 0) | (signbit(a.v[3]) ? 8 : 0);
+    }
+    static inline Vec4 splatW(Vec4 a) { return { { a.v[3], a.v[3], a.v[3], a.v[3] } }; }
+    static inline Vec4 withW(Vec4 a, float w) { a.v[3] = w; return a; }
+    static inline Vec4 negate(Vec4 a) { return { { -a.v[0], -a.v[1], -a.v[2], -a.v[3] } }; }
+
+    static inline void transpose(Vec4& r0, Vec4& r1, Vec4& r2, Vec4& r3) {
+        Vec4 c0 = { { r0.v[0], r1.v[0], r2.v[0], r3.v[0] } };
+        Vec4 c1 = { { r0.v[1], r1.v[1], r2.v[1], r3.v[1] } };
+        Vec4 c2 = { { r0.v[2], r1.v[2], r2.v[2], r3.v[2] } };
+        Vec4 c3 = { { r0.v[3], r1.v[3], r2.v[3], r3.v[3] } };
+        r0 = c0; r1 = c1; r2 = c2; r3 = c3;
+    }
+
+#endif
+
+    // Euclidean lengths of four 3D vectors held as x, y and z lanes
+    static inline Vec4 length3(Vec4 x, Vec4 y, Vec4 z) {
+        return sqrt(add(add(mul(x, x), mul(y, y)), mul(z, z)));
+    }
+
+    // Matrix fields are 16 consecutive floats in row order
+    static inline float* rows(Matrix* m) { return &m->m0; }
+    static inline const float* rows(const Matrix* m) { return &m->m0; }
+
+    // Rigid inverse from the rows of [R t; 0 1]; writes [R^T  -R^T*t; 0 1]
+    static inline void rigidInverseRows(Vec4 r0, Vec4 r1, Vec4 r2, Matrix* out) {
+        // Lane j of d is column_j(R) . t, with t_k sitting in lane 3 of row k
+        Vec4 d = add(add(mul(r0, splatW(r0)), mul(r1, splatW(r1))), mul(r2, splatW(r2)));
+
+        Vec4 c0 = withW(r0, 0.0f);
+        Vec4 c1 = withW(r1, 0.0f);
+        Vec4 c2 = withW(r2, 0.0f);
+        Vec4 c3 = withW(negate(d), 1.0f);
+        transpose(c0, c1, c2, c3);
+
+        float* o = rows(out);
+        store(o + 0, c0);
+        store(o + 4, c1);
+        store(o + 8, c2);
+        store(o + 12, c3);
+    }
+
+    // Column-major WebXR matrix to raylib Matrix
+    static inline Matrix fromWebXR(const float m[16]) {
+        Vec4 r0 = load(m + 0), r1 = load(m + 4), r2 = load(m + 8), r3 = load(m + 12);
+        transpose(r0, r1, r2, r3);
+
+        Matrix result;
+        float* o = rows(&result);
+        store(o + 0, r0);
+        store(o + 4, r1);
+        store(o + 8, r2);
+        store(o + 12, r3);
+        return result;
+    }
+
+    // Inverse of a rigid raylib Matrix (no scale or shear)
+    static inline Matrix rigidInverse(const Matrix& m) {
+        const float* r = rows(&m);
+        Matrix result;
+        rigidInverseRows(load(r + 0), load(r + 4), load(r + 8), &result);
+        return result;
+    }
+
+    // Same as rigidInverse(fromWebXR(m)) without the intermediate Matrix round trip
+    static inline Matrix rigidInverseFromWebXR(const float m[16]) {
+        Vec4 r0 = load(m + 0), r1 = load(m + 4), r2 = load(m + 8), r3 = load(m + 12);
+        transpose(r0, r1, r2, r3);
+
+        Matrix result;
+        rigidInverseRows(r0, r1, r2, &result);
+        return result;
+    }
+
+    // Both eyes at once: projection[eye] and the inverted view (raylib modelview)
+    static inline void convertViews(const WebXRView views[2], Matrix projection[2], Matrix view[2]) {
+        projection[0] = fromWebXR(views[0].projectionMatrix);
+        projection[1] = fromWebXR(views[1].projectionMatrix);
+        view[0] = rigidInverseFromWebXR(views[0].viewMatrix);
+        view[1] = rigidInverseFromWebXR(views[1].viewMatrix);
+    }
+
+}
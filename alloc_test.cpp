@@ -0,0 +1,191 @@
+// Native check that the frame path never reaches the heap.
+//
+//   alloc_test [frames]    frames measured after the warm-up, default 10000
+//
+// Replaces operator new/delete and, through the linker's --wrap (see the
+// alloc_test target in the Makefile), malloc/calloc/realloc/free, then runs a
+// session on the stub backend with a frame handler that uses what the demo
+// does: controllers, hands, gestures, pose prediction, dynamic resolution,
+// single-pass stereo and the frame arena. Links raylib_mock.cpp instead of
+// raylib, so it runs headless. Exits 1 if any frame after the warm-up allocates.
+//
+// The select-event path is loaded on purpose: WEBXR_STUB_SELECT_BURST defaults
+// to SELECT_BURST extra events a second, and VRLog's sink is replaced by one that
+// counts and drops the lines, so every event is formatted and flushed through
+// VRLog without the console in the measurement. Also exits 1 if the events were
+// not logged.
+#include "VRHandler.h"
+#include "VRLog.h"
+#include "raylib_mock.h"
+#include "webxr_stub.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    // One stub cycle of controllers then hands (5 s each): resources loaded on
+    // first use, like the joint renderer's sphere mesh, are allowed here
+    const int WARMUP_FRAMES = 900;
+    const char* SELECT_BURST = "32";
+
+    struct Counters {
+        long long allocations;
+        long long bytes;
+    };
+
+    // Counted only while enabled, so the harness itself can allocate freely
+    Counters counters;
+    bool counting = false;
+
+    void count(size_t size) {
+        if (!counting) return;
+        counters.allocations++;
+        counters.bytes += size;
+    }
+
+    long long logLines = 0;
+
+    void countLines(const char* text) {
+        logLines++;
+        for (const char* c = text; *c; c++) {
+            if (*c == '\n') logLines++;
+        }
+    }
+
+    int framesRun = 0;
+    int framesAllocating = 0;
+    int firstAllocatingFrame = -1;
+    Counters frameStart;
+}
+
+extern "C" {
+    void* __real_malloc(size_t size);
+    void* __real_calloc(size_t count, size_t size);
+    void* __real_realloc(void* ptr, size_t size);
+    void __real_free(void* ptr);
+
+    void* __wrap_malloc(size_t size) {
+        count(size);
+        return __real_malloc(size);
+    }
+
+    void* __wrap_calloc(size_t count, size_t size) {
+        ::count(count * size);
+        return __real_calloc(count, size);
+    }
+
+    void* __wrap_realloc(void* ptr, size_t size) {
+        count(size);
+        return __real_realloc(ptr, size);
+    }
+
+    void __wrap_free(void* ptr) {
+        __real_free(ptr);
+    }
+}
+
+void* operator new(size_t size) {
+    count(size);
+    void* ptr = __real_malloc(size ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    __real_free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    __real_free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    __real_free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    __real_free(ptr);
+}
+
+int main(int argc, char** argv) {
+    int measuredFrames = argc > 1 ? std::max(atoi(argv[1]), 1) : 10000;
+    int frames = WARMUP_FRAMES + measuredFrames + 1;
+
+    setenv("WEBXR_STUB_SELECT_BURST", SELECT_BURST, 0);
+
+    VRHandler vr;
+    vr.initialize();
+    VRLog::setSink(countLines);
+    vr.setStereoMode(VRHandler::StereoMode::SinglePass);
+    vr.setPosePrediction(true);
+    vr.setGestureRecognition(true);
+    vr.setDynamicResolution(true);
+
+    int controllers = 0, gestures = 0, inputEvents = 0;
+    vr.setControllerHandler([&](WebXRInputSource* source, int sourceId) { controllers++; });
+    vr.setHandHandler([&](const WebXRHandData* leftHand, const WebXRHandData* rightHand) {});
+    vr.setGestureHandler([&](const HandGestures::Event& event) { gestures++; });
+    vr.setInputEventHandler([&](const WebXRInputEvent& event) { inputEvents++; });
+
+    vr.setFrameHandler([&](int time, float modelMatrix[16], WebXRView* views, void* handData) {
+        // Allocations since the previous frame handler belong to the previous frame
+        if (framesRun > WARMUP_FRAMES && counters.allocations != frameStart.allocations) {
+            framesAllocating++;
+            if (firstAllocatingFrame < 0) firstAllocatingFrame = framesRun - 1;
+        }
+        // The last frame runs into session end, which may allocate
+        if (framesRun == WARMUP_FRAMES) {
+            counting = true;
+            inputEvents = 0;
+            logLines = 0;
+        }
+        if (framesRun == frames - 1) counting = false;
+        frameStart = counters;
+        framesRun++;
+
+        vr.processControllers();
+        vr.processHands(handData);
+
+        FrameArena& arena = vr.getFrameArena();
+        int* order = arena.allocate<int>(64);
+        for (int i = 0; i < 64; i++) order[i] = 63 - i;
+        std::sort(order, order + 64);
+
+        vr.renderStereo(views, [&](int eye) {
+            for (int i = 0; i < 64; i++) {
+                DrawCube({ (float)(order[i] % 8), 0.5f, (float)(order[i] / 8) }, 0.5f, 0.5f, 0.5f, RED);
+            }
+            vr.drawControllers();
+            vr.drawHands(handData);
+        });
+    });
+
+    webxr_stub_run(frames);
+    int measured = framesRun - 1 - WARMUP_FRAMES;
+    printf("%d frames measured (%d warm-up): %lld allocations, %lld bytes, %d frames allocating\n",
+           measured, WARMUP_FRAMES, counters.allocations, counters.bytes, framesAllocating);
+    printf("controller callbacks %d, gestures %d, input events %d measured, draw calls %lld\n",
+           controllers, gestures, inputEvents, RaylibMock::getStats().drawCalls);
+    printf("log lines flushed %lld, dropped %u\n", logLines, VRLog::getDroppedCount());
+
+#if VRLOG_MIN_LEVEL <= VRLOG_LEVEL_DEBUG
+    // Each select event is logged at debug level when it is drained
+    if (inputEvents == 0 || logLines < inputEvents - (long long)VRLog::getDroppedCount()) {
+        printf("FAIL: select events were not logged through VRLog\n");
+        return 1;
+    }
+#endif
+
+    if (counters.allocations != 0) {
+        printf("FAIL: %.2f allocations per frame, first in frame %d\n",
+               (double)counters.allocations / measured, firstAllocatingFrame);
+        return 1;
+    }
+    printf("PASS: no heap allocations per frame\n");
+    return 0;
+}
@@ -0,0 +1,166 @@
+// Native benchmark of FrustumCuller's BVH against brute force over a large
+// synthetic scene.
+//
+//   cull_bench [objects] [frames]    default 50000 objects, 900 frames
+//
+// Scatters boxes of 0.4 to 6 m over a 200 x 200 m area around the origin and
+// culls them with the eye views of a stub session, whose head looks around.
+// Brute force tests every box against both eye frusta, plane by plane. The BVH
+// cull is serial, once with the stub's parallel eyes (one combined frustum)
+// and once with the right eye canted 10 degrees outwards, which falls back to
+// both eye frusta. Exits 1 if the BVH misses a box brute force keeps by more
+// than TOUCH_TOLERANCE; the two compute a box's plane distance in a different
+// order, so a box that just touches a plane can round either way.
+#include "FrustumCuller.h"
+#include "VRHandler.h"
+#include "FrameProfiler.h"
+#include "webxr_stub.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+    struct ViewPair {
+        WebXRView eyes[2];
+    };
+
+    const float TOUCH_TOLERANCE = 1e-4f;   // meters, planes are normalized
+
+    unsigned seed = 7;
+
+    float randomFloat(float low, float high) {
+        seed = seed * 1664525u + 1013904223u;
+        return low + (high - low) * ((seed >> 8) * (1.0f / 16777216.0f));
+    }
+
+    bool outside(const Frustum& frustum, const BoundingBox& box, float tolerance) {
+        for (int p = 0; p < 6; p++) {
+            float x = frustum.nx[p] > 0.0f ? box.max.x : box.min.x;
+            float y = frustum.ny[p] > 0.0f ? box.max.y : box.min.y;
+            float z = frustum.nz[p] > 0.0f ? box.max.z : box.min.z;
+            if (frustum.nx[p] * x + frustum.ny[p] * y + frustum.nz[p] * z + frustum.d[p] < tolerance) return true;
+        }
+        return false;
+    }
+
+    // Rotates the eye's view matrix (column-major) about its y axis
+    void cant(WebXRView& view, float radians) {
+        float c = cosf(radians), s = sinf(radians);
+        float* m = view.viewMatrix;
+        for (int row = 0; row < 3; row++) {
+            float x = m[row], z = m[8 + row];
+            m[row] = c * x - s * z;
+            m[8 + row] = s * x + c * z;
+        }
+    }
+
+    struct Result {
+        double bruteForceUs;
+        double bvhUs;
+        long long visible;          // by brute force
+        long long bvhVisible;
+        long long nodesTested;
+        long long objectsTested;
+        long long missing;
+        int combinedFrames;
+    };
+
+    Result run(FrustumCuller& culler, const std::vector<BoundingBox>& boxes, const std::vector<ViewPair>& views) {
+        Result result = {};
+        std::vector<unsigned char> keep(boxes.size());
+        culler.cull(views[0].eyes);   // builds the hierarchy outside the timed frames
+
+        for (const ViewPair& pair : views) {
+            Frustum left = Frustum::fromView(pair.eyes[0]);
+            Frustum right = Frustum::fromView(pair.eyes[1]);
+
+            double start = FrameProfiler::now();
+            for (size_t i = 0; i < boxes.size(); i++) {
+                keep[i] = !(outside(left, boxes[i], 0.0f) && outside(right, boxes[i], 0.0f));
+            }
+            double bruteForceEnd = FrameProfiler::now();
+            culler.cull(pair.eyes);
+            double bvhEnd = FrameProfiler::now();
+
+            result.bruteForceUs += (bruteForceEnd - start) * 1000.0;
+            result.bvhUs += (bvhEnd - bruteForceEnd) * 1000.0;
+            for (size_t i = 0; i < boxes.size(); i++) {
+                result.visible += keep[i];
+                if (keep[i] && !culler.isVisible((int)i)) {
+                    if (!outside(left, boxes[i], TOUCH_TOLERANCE) || !outside(right, boxes[i], TOUCH_TOLERANCE)) result.missing++;
+                }
+            }
+
+            const FrustumCuller::Stats& stats = culler.getStats();
+            result.bvhVisible += stats.objectsVisible;
+            result.nodesTested += stats.nodesTested;
+            result.objectsTested += stats.objectsTested;
+            result.combinedFrames += stats.combined ? 1 : 0;
+        }
+        return result;
+    }
+
+    void report(const char* name, const Result& result, int frames) {
+        printf("%-22s %12.1f %12.1f %8.2fx %10lld %10lld %10lld %10lld\n", name,
+               result.bruteForceUs / frames, result.bvhUs / frames, result.bruteForceUs / result.bvhUs,
+               result.visible / frames, result.bvhVisible / frames,
+               (result.nodesTested + result.objectsTested) / frames, result.missing);
+    }
+}
+
+int main(int argc, char** argv) {
+    int objectCount = argc > 1 ? std::max(atoi(argv[1]), 1) : 50000;
+    int frames = argc > 2 ? std::max(atoi(argv[2]), 1) : 900;
+
+    std::vector<ViewPair> views;
+    views.reserve(frames);
+    {
+        VRHandler vr;
+        vr.initialize();
+        vr.setFrameHandler([&views](int time, float modelMatrix[16], WebXRView* eyes, void* handData) {
+            views.push_back({ { eyes[0], eyes[1] } });
+        });
+        webxr_stub_run(frames);
+    }
+    if (views.empty()) {
+        printf("the stub session produced no frames\n");
+        return 1;
+    }
+
+    FrustumCuller culler;
+    std::vector<BoundingBox> boxes;
+    boxes.reserve(objectCount);
+    for (int i = 0; i < objectCount; i++) {
+        Vector3 center = { randomFloat(-100.0f, 100.0f), randomFloat(0.0f, 10.0f), randomFloat(-100.0f, 100.0f) };
+        float half = randomFloat(0.2f, 3.0f);
+        BoundingBox box = { { center.x - half, center.y - half, center.z - half },
+                            { center.x + half, center.y + half, center.z + half } };
+        boxes.push_back(box);
+        culler.add(box);
+    }
+
+    printf("%d objects, %zu frames of stub views\n", objectCount, views.size());
+    printf("%-22s %12s %12s %9s %10s %10s %10s %10s\n", "eyes", "brute us", "bvh us", "speedup",
+           "visible", "bvh kept", "bvh tests", "missing");
+
+    Result parallel = run(culler, boxes, views);
+    report("parallel (combined)", parallel, (int)views.size());
+
+    for (ViewPair& pair : views) cant(pair.eyes[1], 10.0f * DEG2RAD);
+    Result canted = run(culler, boxes, views);
+    report("canted (both frusta)", canted, (int)views.size());
+
+    if (parallel.combinedFrames != (int)views.size() || canted.combinedFrames != 0) {
+        printf("FAIL: combined frustum used on %d of %zu parallel and %d canted frames\n",
+               parallel.combinedFrames, views.size(), canted.combinedFrames);
+        return 1;
+    }
+    if (parallel.missing || canted.missing) {
+        printf("FAIL: the BVH culled boxes brute force keeps\n");
+        return 1;
+    }
+    printf("PASS: the BVH keeps every box brute force keeps\n");
+    return 0;
+}
@@ -0,0 +1,115 @@
+// Headless benchmark of per-frame handler dispatch: VRHandlerT<App> member
+// functions against the std::function handlers of VRHandler.
+//
+//   dispatch_bench [frames] [runs]    default 20000 frames, 15 runs
+//
+// Both variants run stub sessions with the same frame, controller and hand
+// handlers: the frame handler processes controllers and hands, and every
+// handler folds a few floats of what it gets into a checksum. Runs alternate
+// between the variants so drift hits both alike; the median run of each is
+// printed as ns per frame, including the stub backend and VRHandler's own
+// per-frame work, which is the same for both. Exits 1 if the checksums differ.
+#include "VRHandlerT.h"
+#include "FrameProfiler.h"
+#include "webxr_stub.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+    // Keeps the compiler from dropping the handlers' work
+    struct Checksum {
+        double value;
+        long long controllers;
+        long long hands;
+    };
+
+    void frameWork(Checksum& sum, const float modelMatrix[16], const WebXRView* views) {
+        sum.value += modelMatrix[12] + views[0].viewMatrix[12] + views[1].viewMatrix[12];
+    }
+
+    void controllerWork(Checksum& sum, const WebXRInputSource* source, int sourceId) {
+        sum.value += source->handedness + sourceId;
+        sum.controllers++;
+    }
+
+    void handWork(Checksum& sum, const WebXRHandData* leftHand, const WebXRHandData* rightHand) {
+        if (leftHand) sum.value += leftHand->joints[0].position[0];
+        if (rightHand) sum.value += rightHand->joints[0].position[0];
+        sum.hands++;
+    }
+
+    class StaticApp : public VRHandlerT<StaticApp> {
+    public:
+        Checksum sum = {};
+
+        void onFrame(int time, float modelMatrix[16], WebXRView* views, void* handData) {
+            frameWork(sum, modelMatrix, views);
+            processControllers();
+            processHands(handData);
+        }
+        void onController(const WebXRInputSource* source, int sourceId) { controllerWork(sum, source, sourceId); }
+        void onHands(const WebXRHandData* leftHand, const WebXRHandData* rightHand) { handWork(sum, leftHand, rightHand); }
+    };
+
+    // Returns ns per frame of one stub session
+    double runStatic(int frames, Checksum& sum) {
+        StaticApp app;
+        app.initialize();
+        VRLog::setSink([](const char* text) {});
+        double start = FrameProfiler::now();
+        webxr_stub_run(frames);
+        double ns = (FrameProfiler::now() - start) * 1e6 / frames;
+        sum = app.sum;
+        return ns;
+    }
+
+    double runFunction(int frames, Checksum& sum) {
+        VRHandler vr;
+        vr.initialize();
+        VRLog::setSink([](const char* text) {});
+        Checksum local = {};
+        vr.setControllerHandler([&local](WebXRInputSource* source, int sourceId) { controllerWork(local, source, sourceId); });
+        vr.setHandHandler([&local](const WebXRHandData* leftHand, const WebXRHandData* rightHand) { handWork(local, leftHand, rightHand); });
+        vr.setFrameHandler([&vr, &local](int time, float modelMatrix[16], WebXRView* views, void* handData) {
+            frameWork(local, modelMatrix, views);
+            vr.processControllers();
+            vr.processHands(handData);
+        });
+        double start = FrameProfiler::now();
+        webxr_stub_run(frames);
+        double ns = (FrameProfiler::now() - start) * 1e6 / frames;
+        sum = local;
+        return ns;
+    }
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::max(atoi(argv[1]), 1) : 20000;
+    int runs = argc > 2 ? std::max(atoi(argv[2]), 1) : 15;
+
+    std::vector<double> staticTimes, functionTimes;
+    Checksum staticSum = {}, functionSum = {};
+    for (int r = 0; r < runs; r++) {
+        staticTimes.push_back(runStatic(frames, staticSum));
+        functionTimes.push_back(runFunction(frames, functionSum));
+    }
+    std::sort(staticTimes.begin(), staticTimes.end());
+    std::sort(functionTimes.begin(), functionTimes.end());
+    double staticNs = staticTimes[runs / 2];
+    double functionNs = functionTimes[runs / 2];
+
+    printf("%d frames of stub sessions, median of %d runs\n", frames, runs);
+    printf("%-22s %12s %14s %12s\n", "dispatch", "ns/frame", "controllers", "hands");
+    printf("%-22s %12.1f %14lld %12lld\n", "VRHandlerT<App>", staticNs, staticSum.controllers, staticSum.hands);
+    printf("%-22s %12.1f %14lld %12lld\n", "std::function", functionNs, functionSum.controllers, functionSum.hands);
+    printf("difference: %.1f ns per frame\n", functionNs - staticNs);
+
+    if (staticSum.value != functionSum.value || staticSum.controllers != functionSum.controllers ||
+        staticSum.hands != functionSum.hands) {
+        printf("FAIL: the two dispatch paths saw different frames\n");
+        return 1;
+    }
+    return 0;
+}
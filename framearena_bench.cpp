@@ -0,0 +1,190 @@
+// Native benchmark of FrameArena against new/delete and malloc/free for the
+// temporaries a frame handler typically makes.
+//
+//   framearena_bench [frames]    default 20000
+//
+// Each frame builds a visible list by push_back (512 ids, no reserve), 128
+// matrices, 256 small per-object records of 16 to 256 bytes, and a 512-entry
+// depth sort with its key array. The heap variants free everything at the end
+// of the frame; the arena variant resets at the start of the next one.
+#include "FrameArena.h"
+#include "FrameProfiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+    const int VISIBLE = 512;
+    const int MATRICES = 128;
+    const int RECORDS = 256;
+    const int SORTED = 512;
+
+    enum Strategy { New, Malloc, Arena, StrategyCount };
+    const char* strategyNames[StrategyCount] = { "new", "malloc", "arena" };
+
+    struct Matrix16 {
+        float m[16];
+    };
+
+    // Sizes and keys fixed up front, so every strategy does the same work
+    int recordSizes[RECORDS];
+    float sortKeys[SORTED];
+
+    // Keeps the compiler from dropping the work
+    volatile float sink;
+
+    float fill(float* values, int count, float seed) {
+        float sum = 0.0f;
+        for (int i = 0; i < count; i++) {
+            values[i] = seed + i;
+            sum += values[i];
+        }
+        return sum;
+    }
+
+    float frameNew(int frame) {
+        float sum = 0.0f;
+
+        std::vector<int> visible;
+        for (int i = 0; i < VISIBLE; i++) visible.push_back(i * 3 + frame);
+        sum += visible.back();
+
+        Matrix16* matrices = new Matrix16[MATRICES];
+        for (int i = 0; i < MATRICES; i++) sum += fill(matrices[i].m, 16, (float)i);
+
+        unsigned char* records[RECORDS];
+        for (int i = 0; i < RECORDS; i++) {
+            records[i] = new unsigned char[recordSizes[i]];
+            memset(records[i], i, recordSizes[i]);
+        }
+        for (int i = 0; i < RECORDS; i++) sum += records[i][recordSizes[i] - 1];
+
+        float* keys = new float[SORTED];
+        int* order = new int[SORTED];
+        for (int i = 0; i < SORTED; i++) {
+            keys[i] = sortKeys[i];
+            order[i] = i;
+        }
+        std::sort(order, order + SORTED, [keys](int a, int b) { return keys[a] < keys[b]; });
+        sum += order[0];
+
+        delete[] order;
+        delete[] keys;
+        for (int i = 0; i < RECORDS; i++) delete[] records[i];
+        delete[] matrices;
+        return sum;
+    }
+
+    float frameMalloc(int frame) {
+        float sum = 0.0f;
+
+        // push_back growth by doubling, as std::vector does
+        int capacity = 0, count = 0;
+        int* visible = nullptr;
+        for (int i = 0; i < VISIBLE; i++) {
+            if (count == capacity) {
+                capacity = capacity ? capacity * 2 : 1;
+                visible = (int*)realloc(visible, capacity * sizeof(int));
+            }
+            visible[count++] = i * 3 + frame;
+        }
+        sum += visible[count - 1];
+
+        Matrix16* matrices = (Matrix16*)malloc(MATRICES * sizeof(Matrix16));
+        for (int i = 0; i < MATRICES; i++) sum += fill(matrices[i].m, 16, (float)i);
+
+        unsigned char* records[RECORDS];
+        for (int i = 0; i < RECORDS; i++) {
+            records[i] = (unsigned char*)malloc(recordSizes[i]);
+            memset(records[i], i, recordSizes[i]);
+        }
+        for (int i = 0; i < RECORDS; i++) sum += records[i][recordSizes[i] - 1];
+
+        float* keys = (float*)malloc(SORTED * sizeof(float));
+        int* order = (int*)malloc(SORTED * sizeof(int));
+        for (int i = 0; i < SORTED; i++) {
+            keys[i] = sortKeys[i];
+            order[i] = i;
+        }
+        std::sort(order, order + SORTED, [keys](int a, int b) { return keys[a] < keys[b]; });
+        sum += order[0];
+
+        free(order);
+        free(keys);
+        for (int i = 0; i < RECORDS; i++) free(records[i]);
+        free(matrices);
+        free(visible);
+        return sum;
+    }
+
+    float frameArena(FrameArena& arena, int frame) {
+        float sum = 0.0f;
+        arena.beginFrame();
+
+        FrameArena::Vector<int> visible(arena.allocator<int>());
+        for (int i = 0; i < VISIBLE; i++) visible.push_back(i * 3 + frame);
+        sum += visible.back();
+
+        Matrix16* matrices = arena.allocate<Matrix16>(MATRICES);
+        for (int i = 0; i < MATRICES; i++) sum += fill(matrices[i].m, 16, (float)i);
+
+        unsigned char* records[RECORDS];
+        for (int i = 0; i < RECORDS; i++) {
+            records[i] = arena.allocate<unsigned char>(recordSizes[i]);
+            memset(records[i], i, recordSizes[i]);
+        }
+        for (int i = 0; i < RECORDS; i++) sum += records[i][recordSizes[i] - 1];
+
+        float* keys = arena.allocate<float>(SORTED);
+        int* order = arena.allocate<int>(SORTED);
+        for (int i = 0; i < SORTED; i++) {
+            keys[i] = sortKeys[i];
+            order[i] = i;
+        }
+        std::sort(order, order + SORTED, [keys](int a, int b) { return keys[a] < keys[b]; });
+        sum += order[0];
+        return sum;
+    }
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::max(atoi(argv[1]), 1) : 20000;
+
+    unsigned seed = 1;
+    for (int i = 0; i < RECORDS; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        recordSizes[i] = 16 + (int)((seed >> 8) % 241);
+    }
+    for (int i = 0; i < SORTED; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        sortKeys[i] = (seed >> 8) * (1.0f / 16777216.0f);
+    }
+
+    FrameArena arena;
+    printf("%d frames of %d visible ids, %d matrices, %d records, %d-entry sort\n",
+           frames, VISIBLE, MATRICES, RECORDS, SORTED);
+    printf("%-8s %12s %12s\n", "strategy", "median us", "p99 us");
+
+    for (int strategy = 0; strategy < StrategyCount; strategy++) {
+        std::vector<float> times;
+        times.reserve(frames);
+        for (int frame = 0; frame < frames; frame++) {
+            double start = FrameProfiler::now();
+            switch (strategy) {
+                case New: sink = frameNew(frame); break;
+                case Malloc: sink = frameMalloc(frame); break;
+                default: sink = frameArena(arena, frame); break;
+            }
+            times.push_back((float)((FrameProfiler::now() - start) * 1000.0));
+        }
+        std::sort(times.begin(), times.end());
+        printf("%-8s %12.2f %12.2f\n", strategyNames[strategy], times[frames / 2], times[frames * 99 / 100]);
+    }
+
+    const FrameArena::Stats& stats = arena.getStats();
+    printf("arena: %zu bytes per frame, high-water %zu, capacity %zu, %d overflows, %d grows\n",
+           stats.used, stats.highWater, stats.capacity, stats.overflows, stats.grows);
+    return 0;
+}
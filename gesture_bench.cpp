@@ -0,0 +1,126 @@
+// Native benchmark of HandGestures::update on recorded hand tracking, against
+// the 10 us per frame budget.
+//
+//   gesture_bench [trace.wxrt] [repeats]    default: a fresh stub session, 200 repeats
+//
+// Without a trace it first records one from the stub backend (two cycles of
+// controllers and hands, 1800 frames). The frames with a tracked hand are
+// gathered into WebXRHandJointsSoA once, as VRHandler does, and update() is
+// timed over all of them `repeats` times; the gather is timed separately.
+// Prints the transitions seen per gesture so a broken classifier shows, and
+// exits 1 if the median update is over budget.
+#include "HandGestures.h"
+#include "SessionTrace.h"
+#include "VRHandler.h"
+#include "FrameProfiler.h"
+#include "webxr_stub.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+    const int RECORDED_FRAMES = 1800;
+    const char* RECORDED_TRACE = "gesture_bench.wxrt";
+    const float BUDGET_US = 10.0f;
+
+    struct HandFrame {
+        WebXRHandJointsSoA joints;
+        float head[3];
+    };
+
+    bool recordStubSession(const char* path) {
+        VRHandler vr;
+        vr.initialize();
+        vr.setFrameHandler([](int time, float modelMatrix[16], WebXRView* views, void* handData) {});
+        if (!vr.startRecording(path)) return false;
+        webxr_stub_run(RECORDED_FRAMES);
+        vr.stopRecording();
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : RECORDED_TRACE;
+    int repeats = argc > 2 ? std::max(atoi(argv[2]), 1) : 200;
+
+    if (argc <= 1 && !recordStubSession(path)) {
+        printf("could not record %s\n", path);
+        return 1;
+    }
+
+    SessionTraceReader trace;
+    if (!trace.open(path)) {
+        printf("could not read trace %s\n", path);
+        return 1;
+    }
+    if (argc <= 1) remove(path);
+
+    std::vector<HandFrame> frames;
+    std::vector<float> gatherTimes;
+    WebXRFrameData frame;
+    WebXRInputSnapshot input;
+    WebXRFrameStats stats;
+    for (int i = 0; i < trace.getFrameCount(); i++) {
+        int time;
+        if (!trace.readFrame(i, &time, &frame, &input, &stats)) break;
+
+        HandFrame hand;
+        double start = FrameProfiler::now();
+        webxr_get_hand_joints_soa(frame.hands, &hand.joints);
+        gatherTimes.push_back((float)((FrameProfiler::now() - start) * 1000.0));
+        if (!hand.joints.detected[0] && !hand.joints.detected[1]) continue;
+
+        hand.head[0] = frame.modelMatrix[12];
+        hand.head[1] = frame.modelMatrix[13];
+        hand.head[2] = frame.modelMatrix[14];
+        frames.push_back(hand);
+    }
+    if (frames.empty()) {
+        printf("no tracked hands in %s\n", argc > 1 ? path : "the stub session");
+        return 1;
+    }
+
+    HandGestures gestures;
+    int transitions[2][HandGestures::GestureCount][2] = {};
+    for (const HandFrame& hand : frames) {
+        gestures.update(hand.joints, hand.head);
+        for (int i = 0; i < gestures.getEventCount(); i++) {
+            const HandGestures::Event& event = gestures.getEvent(i);
+            transitions[event.hand][event.gesture][event.active ? 1 : 0]++;
+        }
+    }
+
+    // Median over the repeats of the mean update time per frame
+    std::vector<float> times;
+    int eventCount = 0;
+    for (int r = 0; r < repeats; r++) {
+        gestures.reset();
+        double start = FrameProfiler::now();
+        for (const HandFrame& hand : frames) {
+            gestures.update(hand.joints, hand.head);
+            eventCount += gestures.getEventCount();
+        }
+        times.push_back((float)((FrameProfiler::now() - start) * 1000.0 / frames.size()));
+    }
+    std::sort(times.begin(), times.end());
+    std::sort(gatherTimes.begin(), gatherTimes.end());
+
+    printf("%s: %zu frames with tracked hands of %d, %d repeats\n", argc > 1 ? path : "stub session",
+           frames.size(), trace.getFrameCount(), repeats);
+    printf("%-12s %12s %12s\n", "gesture", "left start", "right start");
+    for (int g = 0; g < HandGestures::GestureCount; g++) {
+        printf("%-12s %12d %12d\n", HandGestures::gestureName((HandGestures::Gesture)g),
+               transitions[0][g][1], transitions[1][g][1]);
+    }
+    printf("update: median %.3f us/frame, p99 %.3f us (%d events)\n",
+           times[repeats / 2], times[repeats * 99 / 100], eventCount);
+    printf("gather: median %.3f us/frame\n", gatherTimes[gatherTimes.size() / 2]);
+
+    if (times[repeats / 2] > BUDGET_US) {
+        printf("FAIL: over the %.0f us budget\n", BUDGET_US);
+        return 1;
+    }
+    printf("PASS: within the %.0f us budget\n", BUDGET_US);
+    return 0;
+}
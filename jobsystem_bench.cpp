@@ -0,0 +1,310 @@
+// Scaling benchmark for JobSystem on synthetic per-frame workloads.
+//
+//   jobsystem_bench [max workers] [frames]    defaults: 8 workers, 200 frames
+//
+// Every frame runs four fork-join stages the way a frame handler would before
+// draw submission: a stereo frustum cull of 65536 boxes (FrustumCuller's
+// subtree jobs), 512 skeletons of 32 bones, gesture classification of 2048
+// hands and 131072 particles. Each worker count from 1 up gets the same
+// frames from the same start state; the median stage times are printed with
+// the speedup over one worker, and the final state is checked against the
+// one-worker run.
+#include "raylib.h"
+#include "FrameProfiler.h"
+#include "FrustumCuller.h"
+#include "HandGestures.h"
+#include "JobSystem.h"
+#include <webxr.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+    const int CULL_OBJECTS = 65536;
+    const int SKELETONS = 512;
+    const int BONES = 32;
+    const int HANDS = 2048;
+    const int PARTICLES = 131072;
+    const int SPHERES = 8;
+
+    enum Stage { Cull, Animate, Gestures, Physics, StageCount };
+    const char* stageNames[StageCount] = { "cull", "animate", "gestures", "physics" };
+
+    // Deterministic so every worker count starts from the same scene
+    unsigned seed = 1;
+    float random01() {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // Column-major 4x4, WebXR layout
+    void multiply(const float* a, const float* b, float* out) {
+        for (int column = 0; column < 4; column++) {
+            for (int row = 0; row < 4; row++) {
+                out[column * 4 + row] = a[row] * b[column * 4] + a[4 + row] * b[column * 4 + 1] +
+                                        a[8 + row] * b[column * 4 + 2] + a[12 + row] * b[column * 4 + 3];
+            }
+        }
+    }
+
+    // Rotation about y by angle and about x by pitch, then a translation
+    void rigid(float yaw, float pitch, float x, float y, float z, float* out) {
+        float cy = cosf(yaw), sy = sinf(yaw), cp = cosf(pitch), sp = sinf(pitch);
+        const float m[16] = {
+            cy, 0.0f, -sy, 0.0f,
+            sy * sp, cp, cy * sp, 0.0f,
+            sy * cp, -sp, cy * cp, 0.0f,
+            x, y, z, 1.0f
+        };
+        memcpy(out, m, sizeof(m));
+    }
+
+    struct World {
+        FrustumCuller culler;
+        WebXRView views[2];
+
+        std::vector<float> boneLocal;    // per bone: yaw rate, pitch rate, offset
+        std::vector<float> boneWorld;    // 16 per bone
+
+        std::vector<HandGestures> gestures;
+        std::vector<WebXRHandJointsSoA> hands;   // two hands each, so HANDS / 2 entries
+        std::vector<float> curl;                 // per hand: phase of the curl animation
+
+        std::vector<float> px, py, pz, vx, vy, vz;
+        float spheres[SPHERES][4];
+
+        World() {
+            seed = 1;
+            for (int i = 0; i < CULL_OBJECTS; i++) {
+                float x = (random01() - 0.5f) * 400.0f, y = random01() * 20.0f, z = (random01() - 0.5f) * 400.0f;
+                float size = 0.2f + random01() * 2.0f;
+                culler.add({ { x, y, z }, { x + size, y + size, z + size } });
+            }
+
+            for (int i = 0; i < SKELETONS * BONES; i++) {
+                boneLocal.push_back(random01() * 2.0f - 1.0f);
+                boneLocal.push_back(random01() * 2.0f - 1.0f);
+                boneLocal.push_back(0.05f + random01() * 0.1f);
+            }
+            boneWorld.resize(SKELETONS * BONES * 16);
+
+            gestures.resize(HANDS / 2);
+            hands.resize(HANDS / 2);
+            for (int i = 0; i < HANDS; i++) curl.push_back(random01() * 6.28f);
+
+            for (int i = 0; i < PARTICLES; i++) {
+                px.push_back((random01() - 0.5f) * 20.0f);
+                py.push_back(random01() * 10.0f);
+                pz.push_back((random01() - 0.5f) * 20.0f);
+                vx.push_back(random01() - 0.5f);
+                vy.push_back(random01() * 2.0f);
+                vz.push_back(random01() - 0.5f);
+            }
+            for (int i = 0; i < SPHERES; i++) {
+                spheres[i][0] = (random01() - 0.5f) * 16.0f;
+                spheres[i][1] = random01() * 2.0f;
+                spheres[i][2] = (random01() - 0.5f) * 16.0f;
+                spheres[i][3] = 0.5f + random01() * 1.5f;
+            }
+        }
+
+        // Eyes 64 mm apart, 100 degree symmetric field of view, head turning with time
+        void updateViews(float time) {
+            const float n = 0.1f, f = 500.0f, t = n * tanf(50.0f * DEG2RAD);
+            for (int eye = 0; eye < 2; eye++) {
+                WebXRView& view = views[eye];
+                memset(view.projectionMatrix, 0, sizeof(view.projectionMatrix));
+                view.projectionMatrix[0] = n / t;
+                view.projectionMatrix[5] = n / t;
+                view.projectionMatrix[10] = -(f + n) / (f - n);
+                view.projectionMatrix[11] = -1.0f;
+                view.projectionMatrix[14] = -2.0f * f * n / (f - n);
+
+                float yaw = time * 0.5f, offset = eye == 0 ? -0.032f : 0.032f;
+                rigid(yaw, 0.0f, cosf(yaw) * offset, 1.6f, -sinf(yaw) * offset, view.viewMatrix);
+                view.viewport[0] = eye * 1920;
+                view.viewport[1] = 0;
+                view.viewport[2] = 1920;
+                view.viewport[3] = 1920;
+            }
+        }
+
+        void animate(int skeleton, float time) {
+            float parent[16];
+            rigid(skeleton * 0.7f, 0.0f, (float)(skeleton % 32), 0.0f, (float)(skeleton / 32), parent);
+            for (int bone = 0; bone < BONES; bone++) {
+                int index = skeleton * BONES + bone;
+                const float* local = &boneLocal[index * 3];
+                float transform[16];
+                rigid(sinf(time * local[0]) * 0.5f, cosf(time * local[1]) * 0.3f, 0.0f, local[2], 0.0f, transform);
+                multiply(parent, transform, &boneWorld[index * 16]);
+                memcpy(parent, &boneWorld[index * 16], sizeof(parent));
+            }
+        }
+
+        // Fingers fanned out from the wrist and curled by a per-hand phase
+        void classify(int pair, float time) {
+            WebXRHandJointsSoA& joints = hands[pair];
+            for (int side = 0; side < 2; side++) {
+                int hand = pair * 2 + side;
+                float amount = 0.5f + 0.5f * sinf(time * 2.0f + curl[hand]);
+                int base = side * WEBXR_HAND_JOINT_COUNT;
+                joints.x[base] = joints.y[base] = joints.z[base] = 0.0f;
+                joints.radius[base] = 0.02f;
+                for (int finger = 0; finger < 5; finger++) {
+                    float spread = (finger - 2) * 0.3f, bend = 0.0f;
+                    float x = 0.0f, y = 0.0f, z = 0.0f;
+                    // WebXR order: wrist, thumb (4 joints), then 5 per finger
+                    int first = finger == 0 ? 1 : finger * 5, count = finger == 0 ? 4 : 5;
+                    for (int segment = 0; segment < count; segment++) {
+                        bend += amount * 0.6f;
+                        x += sinf(spread) * 0.025f;
+                        y += sinf(bend) * 0.025f;
+                        z -= cosf(bend) * cosf(spread) * 0.025f;
+                        int joint = base + first + segment;
+                        joints.x[joint] = x + side * 0.2f;
+                        joints.y[joint] = y;
+                        joints.z[joint] = z;
+                        joints.radius[joint] = 0.01f;
+                    }
+                }
+                joints.detected[side] = 1;
+            }
+            const float head[3] = { 0.1f, 0.3f, 0.4f };
+            gestures[pair].update(joints, head);
+        }
+
+        void integrate(int begin, int end, float dt) {
+            for (int i = begin; i < end; i++) {
+                vy[i] -= 9.81f * dt;
+                px[i] += vx[i] * dt;
+                py[i] += vy[i] * dt;
+                pz[i] += vz[i] * dt;
+                if (py[i] < 0.0f) {
+                    py[i] = -py[i];
+                    vy[i] = -vy[i] * 0.8f;
+                }
+                for (const float* s : spheres) {
+                    float dx = px[i] - s[0], dy = py[i] - s[1], dz = pz[i] - s[2];
+                    float d2 = dx * dx + dy * dy + dz * dz;
+                    if (d2 >= s[3] * s[3] || d2 == 0.0f) continue;
+                    // Push out to the surface and reflect the inward velocity
+                    float d = sqrtf(d2), k = s[3] / d;
+                    px[i] = s[0] + dx * k;
+                    py[i] = s[1] + dy * k;
+                    pz[i] = s[2] + dz * k;
+                    float vn = (vx[i] * dx + vy[i] * dy + vz[i] * dz) / d;
+                    if (vn < 0.0f) {
+                        vx[i] -= 1.8f * vn * dx / d;
+                        vy[i] -= 1.8f * vn * dy / d;
+                        vz[i] -= 1.8f * vn * dz / d;
+                    }
+                }
+            }
+        }
+
+        // Sum over the final state in a fixed order; equal across worker counts
+        double checksum() const {
+            double sum = 0.0;
+            for (int id : culler.getVisible()) sum += id;
+            for (float v : boneWorld) sum += v;
+            for (const HandGestures& g : gestures) {
+                for (int hand = 0; hand < 2; hand++) {
+                    for (int gesture = 0; gesture < HandGestures::GestureCount; gesture++) {
+                        sum += g.getStrength(hand, (HandGestures::Gesture)gesture) + g.isActive(hand, (HandGestures::Gesture)gesture);
+                    }
+                }
+            }
+            for (int i = 0; i < PARTICLES; i++) sum += px[i] + py[i] + pz[i];
+            return sum;
+        }
+    };
+
+    struct Result {
+        float median[StageCount];
+        float frame;
+        double checksum;
+        JobSystem::Stats stats;
+    };
+
+    Result run(int workers, int frames) {
+        JobSystem jobs(workers);
+        World* world = new World();
+        world->culler.setJobSystem(&jobs);
+
+        std::vector<float> times[StageCount + 1];
+        const float dt = 1.0f / 90.0f;
+        for (int frame = 0; frame < frames; frame++) {
+            float time = frame * dt;
+            double start = FrameProfiler::now(), stageStart = start;
+            float stage[StageCount];
+
+            world->updateViews(time);
+            world->culler.cull(world->views);
+            stage[Cull] = (float)(FrameProfiler::now() - stageStart);
+
+            stageStart = FrameProfiler::now();
+            jobs.parallelFor(SKELETONS, 8, [world, time](int begin, int end) {
+                for (int i = begin; i < end; i++) world->animate(i, time);
+            });
+            stage[Animate] = (float)(FrameProfiler::now() - stageStart);
+
+            stageStart = FrameProfiler::now();
+            jobs.parallelFor(HANDS / 2, 16, [world, time](int begin, int end) {
+                for (int i = begin; i < end; i++) world->classify(i, time);
+            });
+            stage[Gestures] = (float)(FrameProfiler::now() - stageStart);
+
+            stageStart = FrameProfiler::now();
+            jobs.parallelFor(PARTICLES, 4096, [world, dt](int begin, int end) {
+                world->integrate(begin, end, dt);
+            });
+            stage[Physics] = (float)(FrameProfiler::now() - stageStart);
+
+            for (int i = 0; i < StageCount; i++) times[i].push_back(stage[i]);
+            times[StageCount].push_back((float)(FrameProfiler::now() - start));
+        }
+
+        Result result;
+        for (int i = 0; i <= StageCount; i++) {
+            std::sort(times[i].begin(), times[i].end());
+            float median = times[i][times[i].size() / 2];
+            if (i < StageCount) result.median[i] = median; else result.frame = median;
+        }
+        result.checksum = world->checksum();
+        result.stats = jobs.getStats();
+        delete world;
+        return result;
+    }
+}
+
+int main(int argc, char** argv) {
+    int maxWorkers = argc > 1 ? atoi(argv[1]) : 8;
+    int frames = argc > 2 ? atoi(argv[2]) : 200;
+    maxWorkers = std::min(std::max(maxWorkers, 1), (int)JobSystem::MAX_WORKERS);
+    frames = std::max(frames, 1);
+
+    printf("%d frames; median ms per stage\n", frames);
+    printf("%-8s", "workers");
+    for (const char* name : stageNames) printf(" %9s", name);
+    printf(" %9s %8s %8s %8s %s\n", "frame", "speedup", "jobs", "stolen", "state");
+
+    double reference = 0.0;
+    float serialFrame = 0.0f;
+    for (int workers = 1; workers <= maxWorkers; workers++) {
+        Result result = run(workers, frames);
+        if (workers == 1) {
+            reference = result.checksum;
+            serialFrame = result.frame;
+        }
+
+        printf("%-8d", workers);
+        for (float median : result.median) printf(" %9.3f", median);
+        printf(" %9.3f %7.2fx %8lld %8lld %s\n", result.frame, serialFrame / result.frame,
+               result.stats.jobs, result.stats.stolen, result.checksum == reference ? "ok" : "MISMATCH");
+    }
+    return 0;
+}
@@ -0,0 +1,85 @@
+// Headless benchmark of hand drawing: one DrawSphere per joint against
+// HandJointRenderer's single instanced draw, in vertices per frame.
+//
+//   joint_bench [frames]    stub frames to run, default 1800 (two cycles)
+//
+// Runs a session on the stub backend and, in every frame with two tracked
+// hands, draws the same hands through renderStereo four times: both joint
+// paths, in MultiPass and SinglePass. raylib_mock counts the vertices the
+// CPU streams through the rlgl batch (DrawSphere's tessellation and the bone
+// lines) and those the GPU draws from the resident sphere mesh. The times are
+// the CPU cost of submission against the mock, not of a real GL driver.
+#include "VRHandler.h"
+#include "FrameProfiler.h"
+#include "raylib_mock.h"
+#include "webxr_stub.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+    struct Variant {
+        const char* name;
+        VRHandler::StereoMode mode;
+        bool instanced;
+
+        long long streamed;
+        long long resident;
+        long long drawCalls;
+        std::vector<float> times;
+    };
+
+    Variant variants[4] = {
+        { "DrawSphere, multi-pass", VRHandler::StereoMode::MultiPass, false },
+        { "instanced, multi-pass", VRHandler::StereoMode::MultiPass, true },
+        { "DrawSphere, single-pass", VRHandler::StereoMode::SinglePass, false },
+        { "instanced, single-pass", VRHandler::StereoMode::SinglePass, true },
+    };
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::max(atoi(argv[1]), 1) : 1800;
+
+    VRHandler vr;
+    vr.initialize();
+
+    int handFrames = 0;
+    for (Variant& variant : variants) variant.times.reserve(frames);
+
+    vr.setFrameHandler([&](int time, float modelMatrix[16], WebXRView* views, void* handData) {
+        vr.processHands(handData);
+        if (!vr.isHandTrackingActive() || !vr.getHand(0) || !vr.getHand(1)) return;
+        handFrames++;
+
+        for (Variant& variant : variants) {
+            vr.setStereoMode(variant.mode);
+            vr.setInstancedHandJoints(variant.instanced);
+            RaylibMock::reset();
+
+            double start = FrameProfiler::now();
+            vr.renderStereo(views, [&](int eye) { vr.drawHands(handData); });
+            variant.times.push_back((float)((FrameProfiler::now() - start) * 1000.0));
+
+            const RaylibMock::Stats& stats = RaylibMock::getStats();
+            variant.streamed += stats.vertices;
+            variant.resident += stats.meshVertices;
+            variant.drawCalls += stats.drawCalls;
+        }
+    });
+
+    webxr_stub_run(frames);
+    if (handFrames == 0) {
+        printf("no frames with two tracked hands in %d stub frames\n", frames);
+        return 1;
+    }
+
+    printf("%d frames with two tracked hands of %d joints, both eyes\n", handFrames, WEBXR_HAND_JOINT_COUNT);
+    printf("%-24s %10s %10s %8s %10s\n", "variant", "streamed", "resident", "draws", "median us");
+    for (Variant& variant : variants) {
+        std::sort(variant.times.begin(), variant.times.end());
+        printf("%-24s %10lld %10lld %8.1f %10.2f\n", variant.name, variant.streamed / handFrames,
+               variant.resident / handFrames, (double)variant.drawCalls / handFrames, variant.times[handFrames / 2]);
+    }
+    return 0;
+}
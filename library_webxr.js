@@ -10,6 +10,19 @@ $WebXR: {
     _selectUserData: null,
     _selectStartUserData: null,
     _selectEndUserData: null,
+    _frameViews: 0,
+    _frameModelMatrix: 0,
+    _frameHandData: 0,
+    _inputSnapshot: 0,
+    _frameStats: 0,
+    _framebufferScaleFactor: 1.0,
+    _viewportScale: 1.0,
+    _lastFrameTime: 0,
+    _pendingLayerScale: 1.0,
+    _fixedFoveation: 0.0,
+    _clearColor: null,
+    _inputEventQueue: 0,
+    _inputSourceScratch: 0,
     
     // WebXR Hand Joint indices (25 joints per hand)
     _HAND_JOINTS: [
@@ -22,81 +35,282 @@ $WebXR: {
     ],
 
     _nativize_vec3: function(offset, vec) {
-        setValue(offset    , vec[0], 'float');
-        setValue(offset + 4, vec[1], 'float');
-        setValue(offset + 8, vec[2], 'float');
+        const p = offset >> 2;
+        HEAPF32[p    ] = vec[0];
+        HEAPF32[p + 1] = vec[1];
+        HEAPF32[p + 2] = vec[2];
 
         return offset + 12;
     },
 
     _nativize_matrix: function(offset, mat) {
-        for (var i = 0; i < 16; ++i) {
-            setValue(offset + i*4, mat[i], 'float');
-        }
+        HEAPF32.set(mat, offset >> 2);
 
         return offset + 16*4;
     },
+
+    /* Writes one 8-float joint pose (pos[3], rot[4], radius) at float index p */
+    _nativize_joint_pose: function(p, jointPose) {
+        const pos = jointPose.transform.position;
+        const rot = jointPose.transform.orientation;
+        const heap = HEAPF32;
+
+        heap[p    ] = pos.x;
+        heap[p + 1] = pos.y;
+        heap[p + 2] = pos.z;
+        heap[p + 3] = rot.x;
+        heap[p + 4] = rot.y;
+        heap[p + 5] = rot.z;
+        heap[p + 6] = rot.w;
+        heap[p + 7] = jointPose.radius || 0.01;
+    },
+
+    /* Zero pose with identity rotation for joints that could not be tracked */
+    _clear_joint_pose: function(p) {
+        HEAPF32.fill(0.0, p, p + 8);
+        HEAPF32[p + 6] = 1.0;
+    },
+
+    /* XRJointSpace objects in _HAND_JOINTS order, cached on the XRHand */
+    _joint_spaces: function(hand) {
+        if (!hand._webxrJointSpaces) {
+            hand._webxrJointSpaces = WebXR._HAND_JOINTS.map(function(name) { return hand.get(name); });
+        }
+        return hand._webxrJointSpaces;
+    },
+
+    /* Converts the rotation part of the column-major matrix m at o to a quaternion written to heap[p..p+3] */
+    _nativize_matrix_rotation: function(heap, p, m, o) {
+        const m00 = m[o], m10 = m[o + 1], m20 = m[o + 2];
+        const m01 = m[o + 4], m11 = m[o + 5], m21 = m[o + 6];
+        const m02 = m[o + 8], m12 = m[o + 9], m22 = m[o + 10];
+        const trace = m00 + m11 + m22;
+        let s;
+
+        if (trace > 0) {
+            s = 0.5 / Math.sqrt(trace + 1.0);
+            heap[p    ] = (m21 - m12) * s;
+            heap[p + 1] = (m02 - m20) * s;
+            heap[p + 2] = (m10 - m01) * s;
+            heap[p + 3] = 0.25 / s;
+        } else if (m00 > m11 && m00 > m22) {
+            s = 2.0 * Math.sqrt(1.0 + m00 - m11 - m22);
+            heap[p    ] = 0.25 * s;
+            heap[p + 1] = (m01 + m10) / s;
+            heap[p + 2] = (m02 + m20) / s;
+            heap[p + 3] = (m21 - m12) / s;
+        } else if (m11 > m22) {
+            s = 2.0 * Math.sqrt(1.0 + m11 - m00 - m22);
+            heap[p    ] = (m01 + m10) / s;
+            heap[p + 1] = 0.25 * s;
+            heap[p + 2] = (m12 + m21) / s;
+            heap[p + 3] = (m02 - m20) / s;
+        } else {
+            s = 2.0 * Math.sqrt(1.0 + m22 - m00 - m11);
+            heap[p    ] = (m02 + m20) / s;
+            heap[p + 1] = (m12 + m21) / s;
+            heap[p + 2] = 0.25 * s;
+            heap[p + 3] = (m10 - m01) / s;
+        }
+    },
+
+    /* Fills all 25 joints with XRFrame.fillPoses/fillJointRadii. Returns false if any joint is untracked. */
+    _fill_hand_joints: function(p, spaces, frame, coordinateSystem) {
+        if (!WebXR._jointTransforms) {
+            WebXR._jointTransforms = new Float32Array(25 * 16);
+            WebXR._jointRadii = new Float32Array(25);
+        }
+        const transforms = WebXR._jointTransforms;
+        const radii = WebXR._jointRadii;
+
+        try {
+            if (!frame.fillPoses(spaces, coordinateSystem, transforms)) return false;
+            if (!frame.fillJointRadii(spaces, radii)) return false;
+        } catch (e) {
+            return false;
+        }
+
+        const heap = HEAPF32;
+        for (let i = 0; i < 25; i++, p += 8) {
+            const o = i * 16;
+            heap[p    ] = transforms[o + 12];
+            heap[p + 1] = transforms[o + 13];
+            heap[p + 2] = transforms[o + 14];
+            WebXR._nativize_matrix_rotation(heap, p + 3, transforms, o);
+            heap[p + 7] = radii[i] || 0.01;
+        }
+        return true;
+    },
     
     _nativize_hand_joints: function(offset, hand, frame, coordinateSystem) {
+        let p = offset >> 2;
+
         if (!hand || !frame || !coordinateSystem) {
             // Fill with zeros if no hand data
             for (let i = 0; i < 25; i++) {
-                // Position (3 floats)
-                setValue(offset + i * 32, 0.0, 'float');
-                setValue(offset + i * 32 + 4, 0.0, 'float');
-                setValue(offset + i * 32 + 8, 0.0, 'float');
-                // Rotation (4 floats)
-                setValue(offset + i * 32 + 12, 0.0, 'float');
-                setValue(offset + i * 32 + 16, 0.0, 'float');
-                setValue(offset + i * 32 + 20, 0.0, 'float');
-                setValue(offset + i * 32 + 24, 1.0, 'float');
-                // Radius (1 float)
-                setValue(offset + i * 32 + 28, 0.0, 'float');
+                WebXR._clear_joint_pose(p + i * 8);
             }
             return offset + 25 * 32;
         }
-        
-        for (let i = 0; i < WebXR._HAND_JOINTS.length && i < 25; i++) {
-            const jointName = WebXR._HAND_JOINTS[i];
+
+        const spaces = WebXR._joint_spaces(hand);
+        if (frame.fillPoses && frame.fillJointRadii &&
+            WebXR._fill_hand_joints(p, spaces, frame, coordinateSystem)) {
+            return offset + 25 * 32;
+        }
+
+        // Per-joint fallback: older runtimes, or some joints not tracked this frame
+        for (let i = 0; i < 25; i++, p += 8) {
             try {
-                const jointPose = frame.getJointPose(hand.get(jointName), coordinateSystem);
+                const jointPose = frame.getJointPose(spaces[i], coordinateSystem);
                 
                 if (jointPose) {
-                    const pos = jointPose.transform.position;
-                    const rot = jointPose.transform.orientation;
-                    
-                    // Position (3 floats)
-                    setValue(offset + i * 32, pos.x, 'float');
-                    setValue(offset + i * 32 + 4, pos.y, 'float');
-                    setValue(offset + i * 32 + 8, pos.z, 'float');
-                    
-                    // Rotation (4 floats - quaternion)
-                    setValue(offset + i * 32 + 12, rot.x, 'float');
-                    setValue(offset + i * 32 + 16, rot.y, 'float');
-                    setValue(offset + i * 32 + 20, rot.z, 'float');
-                    setValue(offset + i * 32 + 24, rot.w, 'float');
-                    
-                    // Radius (1 float)
-                    setValue(offset + i * 32 + 28, jointPose.radius || 0.01, 'float');
+                    WebXR._nativize_joint_pose(p, jointPose);
                 } else {
                     // Fill with zeros if joint pose is not available
-                    for (let j = 0; j < 8; j++) {
-                        setValue(offset + i * 32 + j * 4, 0.0, 'float');
-                    }
-                    setValue(offset + i * 32 + 24, 1.0, 'float'); // w component of quaternion
+                    WebXR._clear_joint_pose(p);
                 }
             } catch (e) {
-                console.warn(`Failed to get pose for joint ${jointName}:`, e);
+                console.warn(`Failed to get pose for joint ${WebXR._HAND_JOINTS[i]}:`, e);
                 // Fill with zeros on error
-                for (let j = 0; j < 8; j++) {
-                    setValue(offset + i * 32 + j * 4, 0.0, 'float');
-                }
-                setValue(offset + i * 32 + 24, 1.0, 'float'); // w component of quaternion
+                WebXR._clear_joint_pose(p);
             }
         }
         
         return offset + 25 * 32;
     },
+
+    /* Makes the context skip viewport, scissor, clearColor, enable/disable and
+     * bindFramebuffer calls that would not change its state. The methods are
+     * replaced on the context object itself, so raylib's calls go through the
+     * same cache as the library's and the cached state never goes stale. */
+    _install_gl_cache: function(gl) {
+        if (!gl || gl._webxrState) return;
+        const state = gl._webxrState = {
+            viewport: new Int32Array(4), viewportKnown: false,
+            scissor: new Int32Array(4), scissorKnown: false,
+            clearColor: new Float32Array(4), clearColorKnown: false,
+            caps: new Map(),
+            framebuffer: undefined,
+            counting: false,
+            calls: 0,
+            skipped: 0
+        };
+        const raw = {};
+        ['viewport', 'scissor', 'clearColor', 'enable', 'disable', 'bindFramebuffer'].forEach(function(name) {
+            raw[name] = gl[name];
+        });
+        function pass(name, args) {
+            if (state.counting) state.calls++;
+            return raw[name].apply(gl, args);
+        }
+        function same4(cache, a, b, c, d) {
+            if (cache[0] === a && cache[1] === b && cache[2] === c && cache[3] === d) return true;
+            cache[0] = a; cache[1] = b; cache[2] = c; cache[3] = d;
+            return false;
+        }
+
+        gl.viewport = function(x, y, width, height) {
+            if (same4(state.viewport, x, y, width, height) && state.viewportKnown) { state.skipped++; return; }
+            state.viewportKnown = true;
+            pass('viewport', arguments);
+        };
+        gl.scissor = function(x, y, width, height) {
+            if (same4(state.scissor, x, y, width, height) && state.scissorKnown) { state.skipped++; return; }
+            state.scissorKnown = true;
+            pass('scissor', arguments);
+        };
+        gl.clearColor = function(r, g, b, a) {
+            /* Compared after rounding to float, as the context stores them */
+            const c = state.clearColor;
+            if (state.clearColorKnown && c[0] === Math.fround(r) && c[1] === Math.fround(g) &&
+                c[2] === Math.fround(b) && c[3] === Math.fround(a)) { state.skipped++; return; }
+            c[0] = r; c[1] = g; c[2] = b; c[3] = a;
+            state.clearColorKnown = true;
+            pass('clearColor', arguments);
+        };
+        gl.enable = function(cap) {
+            if (state.caps.get(cap) === true) { state.skipped++; return; }
+            state.caps.set(cap, true);
+            pass('enable', arguments);
+        };
+        gl.disable = function(cap) {
+            if (state.caps.get(cap) === false) { state.skipped++; return; }
+            state.caps.set(cap, false);
+            pass('disable', arguments);
+        };
+        gl.bindFramebuffer = function(target, framebuffer) {
+            /* Only the combined target is tracked; WebGL2 draw/read bindings reset it */
+            if (target !== gl.FRAMEBUFFER) {
+                state.framebuffer = undefined;
+            } else if (state.framebuffer === framebuffer) {
+                state.skipped++;
+                return;
+            } else {
+                state.framebuffer = framebuffer;
+            }
+            pass('bindFramebuffer', arguments);
+        };
+
+        if (gl.canvas && gl.canvas.addEventListener) {
+            gl.canvas.addEventListener('webglcontextrestored', function() {
+                state.viewportKnown = state.scissorKnown = state.clearColorKnown = false;
+                state.caps.clear();
+                state.framebuffer = undefined;
+            });
+        }
+    },
+
+    /* Counts every call that reaches the context, for WebXRFrameStats.glCalls */
+    _count_gl_calls: function(gl, enabled) {
+        const state = gl && gl._webxrState;
+        if (!state || state.counting === !!enabled) return;
+        state.counting = !!enabled;
+        state.calls = 0;
+
+        const proto = Object.getPrototypeOf(gl);
+        Object.getOwnPropertyNames(proto).forEach(function(name) {
+            const desc = Object.getOwnPropertyDescriptor(proto, name);
+            if (!desc || typeof desc.value !== 'function' || name === 'constructor') return;
+            /* The cache wrappers count their own pass-through calls */
+            if (Object.prototype.hasOwnProperty.call(gl, name) && !gl[name]._webxrCounted) return;
+
+            if (enabled) {
+                const fn = desc.value;
+                const counted = function() {
+                    state.calls++;
+                    return fn.apply(gl, arguments);
+                };
+                counted._webxrCounted = true;
+                gl[name] = counted;
+            } else {
+                delete gl[name];
+            }
+        });
+    },
+
+    /* Makes a base layer at _framebufferScaleFactor * scale the session's, from its next frame */
+    _create_layer: function(session, scale) {
+        const layer = new XRWebGLLayer(session, Module.ctx, {
+            framebufferScaleFactor: WebXR._framebufferScaleFactor * scale
+        });
+        layer._webxrScale = scale;
+        if ('fixedFoveation' in layer) layer.fixedFoveation = WebXR._fixedFoveation;
+        session.updateRenderState({ baseLayer: layer });
+        WebXR._pendingLayerScale = scale;
+    },
+
+    /* Allocates the frame block once if the application did not register one */
+    _ensure_frame_buffers: function() {
+        if (WebXR._frameViews) return;
+
+        const SIZE_OF_WEBXR_VIEW = (16 + 16 + 4+7)*4;
+        const block = Module._malloc(SIZE_OF_WEBXR_VIEW*2 + 16*4 + 2*25*32 + 8);
+        WebXR._frameViews = block;
+        WebXR._frameModelMatrix = block + SIZE_OF_WEBXR_VIEW*2;
+        WebXR._frameHandData = WebXR._frameModelMatrix + 16*4;
+    },
+
     /* Sets input source values to offset and returns pointer after struct */
     _nativize_input_source: function(offset, inputSource, id) {
         var handedness = -1;
@@ -110,18 +324,67 @@ $WebXR: {
         var hasHand = inputSource.hand ? 1 : 0;
         var hasController = (inputSource.gamepad || inputSource.targetRaySpace) ? 1 : 0;
 
-        setValue(offset, id, 'i32');
-        offset +=4;
-        setValue(offset, handedness, 'i32');
-        offset +=4;
-        setValue(offset, targetRayMode, 'i32');
-        offset +=4;
-        setValue(offset, hasHand, 'i32');
-        offset +=4;
-        setValue(offset, hasController, 'i32');
-        offset +=4;
-
-        return offset;
+        const p = offset >> 2;
+        HEAP32[p    ] = id;
+        HEAP32[p + 1] = handedness;
+        HEAP32[p + 2] = targetRayMode;
+        HEAP32[p + 3] = hasHand;
+        HEAP32[p + 4] = hasController;
+
+        return offset + 5*4;
+    },
+
+    /* Fills the registered WebXRInputSnapshot: sources, grip/target ray poses and gamepad state */
+    _nativize_input_snapshot: function(ptr, session, frame, coordinateSystem) {
+        const SIZE_OF_WEBXR_INPUT_STATE = (5 + 2 + 16 + 16 + 3 + 8 + 1 + 4 + 1 + 3 + 3)*4;
+        let count = 0;
+
+        for (const inputSource of session.inputSources) {
+            if (count >= 16) break;
+
+            const offset = WebXR._nativize_input_source(ptr + 4 + count*SIZE_OF_WEBXR_INPUT_STATE, inputSource, count);
+            const p = offset >> 2;
+
+            const grip = inputSource.gripSpace ? frame.getPose(inputSource.gripSpace, coordinateSystem) : null;
+            const ray = frame.getPose(inputSource.targetRaySpace, coordinateSystem);
+            HEAP32[p    ] = grip ? 1 : 0;
+            HEAP32[p + 1] = ray ? 1 : 0;
+            if (grip) HEAPF32.set(grip.transform.matrix, p + 2);
+            if (ray) HEAPF32.set(ray.transform.matrix, p + 18);
+
+            let buttonCount = 0, pressed = 0, touched = 0, axisCount = 0;
+            const gamepad = inputSource.gamepad;
+            if (gamepad) {
+                buttonCount = Math.min(gamepad.buttons.length, 8);
+                for (let i = 0; i < buttonCount; i++) {
+                    const button = gamepad.buttons[i];
+                    if (button.pressed) pressed |= 1 << i;
+                    if (button.touched) touched |= 1 << i;
+                    HEAPF32[p + 37 + i] = button.value;
+                }
+                axisCount = Math.min(gamepad.axes.length, 4);
+                for (let i = 0; i < axisCount; i++) {
+                    HEAPF32[p + 46 + i] = gamepad.axes[i];
+                }
+            }
+            HEAP32[p + 34] = buttonCount;
+            HEAP32[p + 35] = pressed;
+            HEAP32[p + 36] = touched;
+            HEAP32[p + 45] = axisCount;
+
+            const linear = grip ? grip.linearVelocity : null;
+            const angular = grip ? grip.angularVelocity : null;
+            HEAP32[p + 50] = linear ? 1 : 0;
+            HEAPF32[p + 51] = linear ? linear.x : 0;
+            HEAPF32[p + 52] = linear ? linear.y : 0;
+            HEAPF32[p + 53] = linear ? linear.z : 0;
+            HEAPF32[p + 54] = angular ? angular.x : 0;
+            HEAPF32[p + 55] = angular ? angular.y : 0;
+            HEAPF32[p + 56] = angular ? angular.z : 0;
+
+            ++count;
+        }
+        HEAP32[ptr >> 2] = count;
     },
 
     _set_input_callback: function(event, callback, userData) {
@@ -129,12 +392,12 @@ $WebXR: {
         if(!s) return;
         if(!callback) return;
 
+        /* One WebXRInputSource struct (5 int32s) reused by every event */
+        if (!WebXR._inputSourceScratch) WebXR._inputSourceScratch = Module._malloc(20);
+
         s.addEventListener(event, function(e) {
-            console.log(`WebXR input event: ${event}`);
-            
-            /* Allocate memory for WebXRInputSource struct (5 int32s) */
-            var inputSourceStruct = Module._malloc(20); // 5*sizeof(int32)
-            
+            var inputSourceStruct = WebXR._inputSourceScratch;
+
             /* Find the input source index */
             var inputSourceIndex = -1;
             for (let i = 0; i < s.inputSources.length; i++) {
@@ -152,8 +415,44 @@ $WebXR: {
             } else {
                 console.warn('Could not find input source index for event');
             }
+        });
+    },
+
+    /* Writes select events into the registered WebXRInputEventQueue; no call into native code */
+    _queue_input_events: function(session) {
+        const types = { 'select': 0, 'selectstart': 1, 'selectend': 2 };
+        const SIZE_OF_EVENT = 8 + 4 + 20 + 8 + 2*64;
+        const CAPACITY = 64;
+
+        Object.keys(types).forEach(function(name) {
+            session.addEventListener(name, function(e) {
+                const queue = WebXR._inputEventQueue;
+                if (!queue) return;
+
+                const head = HEAPU32[queue >> 2];
+                const tail = HEAPU32[(queue + 4) >> 2];
+                if (((head - tail) >>> 0) >= CAPACITY) {
+                    HEAPU32[(queue + 8) >> 2]++;
+                    return;
+                }
 
-            Module._free(inputSourceStruct);
+                const index = session.inputSources ? Array.prototype.indexOf.call(session.inputSources, e.inputSource) : -1;
+                const event = queue + 16 + (head % CAPACITY) * SIZE_OF_EVENT;
+                HEAPF64[event >> 3] = e.timeStamp;
+                HEAP32[(event + 8) >> 2] = types[name];
+                WebXR._nativize_input_source(event + 12, e.inputSource, index);
+
+                /* The event's frame is only valid during dispatch, so the poses are read now */
+                let offset = event + 32;
+                const spaces = [e.inputSource.gripSpace, e.inputSource.targetRaySpace];
+                for (let i = 0; i < 2; i++) {
+                    const pose = spaces[i] && e.frame ? e.frame.getPose(spaces[i], WebXR._coordinateSystem) : null;
+                    HEAP32[(offset + 4 * i) >> 2] = pose ? 1 : 0;
+                    if (pose) WebXR._nativize_matrix(event + 40 + 64 * i, pose.transform.matrix);
+                }
+
+                HEAPU32[queue >> 2] = (head + 1) >>> 0;
+            });
         });
     },
 
@@ -186,6 +485,7 @@ webxr_init: function(mode, frameCallback, startSessionCallback, endSessionCallba
     
     // Store session mode for later use
     Module['webxr_session_mode'] = mode;
+    WebXR._install_gl_cache(Module.ctx);
 
     function onFrame(time, frame) {
         if(!frameCallback) return;
@@ -194,15 +494,30 @@ webxr_init: function(mode, frameCallback, startSessionCallback, endSessionCallba
         /* RAF is set to null on session end to avoid rendering */
         if(Module['webxr_session'] != null) session.requestAnimationFrame(onFrame);
 
+        const marshalStart = performance.now();
         const pose = frame.getViewerPose(WebXR._coordinateSystem);
         if(!pose) return;
 
         const SIZE_OF_WEBXR_VIEW = (16 + 16 + 4+7)*4;
-        const views = Module._malloc(SIZE_OF_WEBXR_VIEW*2 + 16*4);
+        WebXR._ensure_frame_buffers();
+        const views = WebXR._frameViews;
 
         const glLayer = session.renderState.baseLayer;
         window.glLayer = glLayer;
+
+        /* Dynamic resolution: per-view scaling where supported, otherwise a new
+         * layer once the requested scale is far enough from the current one */
+        const perViewScale = pose.views.length > 0 && typeof pose.views[0].requestViewportScale === 'function';
+        const requestedScale = WebXR._viewportScale;
+        let viewportScale = glLayer._webxrScale || 1.0;
+        if (perViewScale) {
+            viewportScale = requestedScale;
+        } else if (Math.abs(requestedScale - WebXR._pendingLayerScale) >= 0.1) {
+            WebXR._create_layer(session, requestedScale);
+        }
+
         pose.views.forEach(function(view) {
+            if (perViewScale) view.requestViewportScale(requestedScale);
             const viewport = glLayer.getViewport(view);
             const viewMatrix = view.transform.matrix;//inverse.matrix;
             let offset = views + SIZE_OF_WEBXR_VIEW*(view.eye == 'left' ? 0 : 1);
@@ -210,27 +525,31 @@ webxr_init: function(mode, frameCallback, startSessionCallback, endSessionCallba
             offset = WebXR._nativize_matrix(offset, viewMatrix);
             offset = WebXR._nativize_matrix(offset, view.projectionMatrix);
 
-            setValue(offset    , viewport.x, 'i32');
-            setValue(offset + 4, viewport.y, 'i32');
-            setValue(offset + 8, viewport.width, 'i32');
-            setValue(offset + 12, viewport.height, 'i32');
+            const vp = offset >> 2;
+            HEAP32[vp    ] = viewport.x;
+            HEAP32[vp + 1] = viewport.y;
+            HEAP32[vp + 2] = viewport.width;
+            HEAP32[vp + 3] = viewport.height;
             offset += 16;
             const p=view.transform.position;
-            offset = WebXR._nativize_vec3(offset,[p.x,p.y,p.z]);
             const r=view.transform.orientation;
-            setValue(offset,    r.x,'float');
-            setValue(offset+4,  r.y,'float');
-            setValue(offset+8,  r.z,'float');
-            setValue(offset+12, r.w,'float');
+            const tp = offset >> 2;
+            HEAPF32[tp    ] = p.x;
+            HEAPF32[tp + 1] = p.y;
+            HEAPF32[tp + 2] = p.z;
+            HEAPF32[tp + 3] = r.x;
+            HEAPF32[tp + 4] = r.y;
+            HEAPF32[tp + 5] = r.z;
+            HEAPF32[tp + 6] = r.w;
         });
 
         /* Model matrix */
-        const modelMatrix = views + SIZE_OF_WEBXR_VIEW*2;
+        const modelMatrix = WebXR._frameModelMatrix;
         WebXR._nativize_matrix(modelMatrix, pose.transform.matrix);
         
-        // Allocate memory for hand tracking data (2 hands * 25 joints * 32 bytes per joint)
+        // Hand tracking data (2 hands * 25 joints * 32 bytes per joint) + detection flags
         const handDataSize = 2 * 25 * 32;
-        const handData = Module._malloc(handDataSize + 8); // +8 for hand detection flags
+        const handData = WebXR._frameHandData;
         
         // Check for hand tracking support and collect hand data
         let leftHandDetected = 0;
@@ -249,28 +568,54 @@ webxr_init: function(mode, frameCallback, startSessionCallback, endSessionCallba
         }
         
         // Set hand detection flags at the end of hand data
-        setValue(handData + handDataSize, leftHandDetected, 'i32');
-        setValue(handData + handDataSize + 4, rightHandDetected, 'i32');
+        HEAP32[(handData + handDataSize) >> 2] = leftHandDetected;
+        HEAP32[(handData + handDataSize + 4) >> 2] = rightHandDetected;
         
-        Module.ctx.bindFramebuffer(Module.ctx.FRAMEBUFFER,
-            glLayer.framebuffer);
-        /* HACK: This is not generally necessary, but chrome seems to detect whether the
-         * page is sending frames by waiting for depth buffer clear or something */
-        // TODO still necessary?
-        Module.ctx.clear(Module.ctx.DEPTH_BUFFER_BIT);
+        const gl = Module.ctx;
+        gl.bindFramebuffer(gl.FRAMEBUFFER, glLayer.framebuffer);
+        if (WebXR._clearColor) {
+            /* One clear of the whole layer, both eyes at once, instead of one scissored clear per eye */
+            const c = WebXR._clearColor;
+            gl.disable(gl.SCISSOR_TEST);
+            gl.clearColor(c[0], c[1], c[2], c[3]);
+            gl.clear(gl.COLOR_BUFFER_BIT | gl.DEPTH_BUFFER_BIT);
+        } else {
+            /* HACK: This is not generally necessary, but chrome seems to detect whether the
+             * page is sending frames by waiting for depth buffer clear or something */
+            // TODO still necessary?
+            gl.clear(gl.DEPTH_BUFFER_BIT);
+        }
+
+        if (WebXR._inputSnapshot) {
+            WebXR._nativize_input_snapshot(WebXR._inputSnapshot, session, frame, WebXR._coordinateSystem);
+        }
+
+        if (WebXR._frameStats) {
+            const stats = WebXR._frameStats >> 2;
+            HEAPF32[stats] = performance.now() - marshalStart;
+            HEAPF32[stats + 1] = frame.predictedDisplayTime !== undefined ? frame.predictedDisplayTime - time : 0;
+            HEAPF32[stats + 2] = WebXR._lastFrameTime ? time - WebXR._lastFrameTime : 0;
+            HEAPF32[stats + 3] = session.frameRate || 0;
+            HEAPF32[stats + 4] = viewportScale;
+            /* GL calls since the previous frame started, this frame's clear included */
+            const glState = gl._webxrState;
+            HEAP32[stats + 5] = glState && glState.counting ? glState.calls : 0;
+            HEAP32[stats + 6] = glState ? glState.skipped : 0;
+            if (glState) glState.calls = glState.skipped = 0;
+        }
+        WebXR._lastFrameTime = time;
 
         /* Set and reset environment for webxr_get_input_pose calls */
         Module['webxr_frame'] = frame;
         dynCall('viiiii', frameCallback, [userData, time, modelMatrix, views, handData]);
         Module['webxr_frame'] = null;
-
-        _free(views);
-        _free(handData);
     };
 
     function onSessionStarted(session) {
         Module['webxr_session'] = session;
         Module['webxr_on_session_started'] = onSessionStarted;
+        WebXR._viewportScale = 1.0;
+        WebXR._lastFrameTime = 0;
 
         // React to session ending
         session.addEventListener('end', function() {
@@ -284,6 +629,8 @@ webxr_init: function(mode, frameCallback, startSessionCallback, endSessionCallba
         // e.g. finish current desktop frame.
         onSessionStart();
         
+        WebXR._queue_input_events(session);
+
         // Register input callbacks if they were set before session started
         if (WebXR._selectCallback) {
             WebXR._set_input_callback('select', WebXR._selectCallback, WebXR._selectUserData);
@@ -298,9 +645,7 @@ webxr_init: function(mode, frameCallback, startSessionCallback, endSessionCallba
         // Ensure our context can handle WebXR rendering
         Module.ctx.makeXRCompatible().then(function() {
             // Create the base layer
-            session.updateRenderState({
-                baseLayer: new XRWebGLLayer(session, Module.ctx)
-            });
+            WebXR._create_layer(session, 1.0);
 
             session.requestReferenceSpace('local').then(refSpace => {
                 WebXR._coordinateSystem = refSpace;
@@ -368,6 +713,50 @@ webxr_set_projection_params: function(near, far) {
     s.depthFar = far;
 },
 
+webxr_set_framebuffer_scale_factor: function(scale) {
+    WebXR._framebufferScaleFactor = scale;
+},
+
+webxr_request_viewport_scale: function(scale) {
+    WebXR._viewportScale = Math.min(1.0, Math.max(0.05, scale));
+},
+
+webxr_set_fixed_foveation: function(level) {
+    WebXR._fixedFoveation = Math.min(1.0, Math.max(0.0, level));
+    var s = Module['webxr_session'];
+    var layer = s && s.renderState.baseLayer;
+    if (layer && 'fixedFoveation' in layer) layer.fixedFoveation = WebXR._fixedFoveation;
+},
+
+webxr_is_fixed_foveation_supported: function() {
+    var s = Module['webxr_session'];
+    var layer = s && s.renderState.baseLayer;
+    return layer && 'fixedFoveation' in layer ? 1 : 0;
+},
+
+webxr_set_clear_color: function(r, g, b, a) {
+    WebXR._clearColor = [r, g, b, a];
+},
+
+webxr_set_gl_call_counting: function(enabled) {
+    WebXR._install_gl_cache(Module.ctx);
+    WebXR._count_gl_calls(Module.ctx, enabled);
+},
+
+webxr_set_frame_buffers: function(views, modelMatrix, handData) {
+    WebXR._frameViews = views;
+    WebXR._frameModelMatrix = modelMatrix;
+    WebXR._frameHandData = handData;
+},
+
+webxr_set_frame_stats_buffer: function(stats) {
+    WebXR._frameStats = stats;
+},
+
+webxr_set_input_snapshot_buffer: function(snapshot) {
+    WebXR._inputSnapshot = snapshot;
+},
+
 webxr_set_session_blur_callback: function(callback, userData) {
     WebXR._set_session_callback("blur", callback, userData);
 },
@@ -401,6 +790,10 @@ webxr_set_select_end_callback: function(callback, userData) {
     }
 },
 
+webxr_set_input_event_queue: function(queue) {
+    WebXR._inputEventQueue = queue;
+},
+
 webxr_get_input_sources: function(outArrayPtr, max, outCountPtr) {
     var s = Module['webxr_session'];
     if(!s) return; // TODO(squareys) warning or return error
@@ -462,24 +855,9 @@ webxr_get_hand_joint_pose: function(handedness, jointIndex, outPosePtr) {
             if (jointIndex >= 0 && jointIndex < WebXR._HAND_JOINTS.length) {
                 const jointName = WebXR._HAND_JOINTS[jointIndex];
                 try {
-                    const jointPose = f.getJointPose(inputSource.hand.get(jointName), WebXR._coordinateSystem);
+                    const jointPose = f.getJointPose(WebXR._joint_spaces(inputSource.hand)[jointIndex], WebXR._coordinateSystem);
                     if (jointPose) {
-                        const pos = jointPose.transform.position;
-                        const rot = jointPose.transform.orientation;
-                        
-                        // Position (3 floats)
-                        setValue(outPosePtr, pos.x, 'float');
-                        setValue(outPosePtr + 4, pos.y, 'float');
-                        setValue(outPosePtr + 8, pos.z, 'float');
-                        
-                        // Rotation (4 floats - quaternion)
-                        setValue(outPosePtr + 12, rot.x, 'float');
-                        setValue(outPosePtr + 16, rot.y, 'float');
-                        setValue(outPosePtr + 20, rot.z, 'float');
-                        setValue(outPosePtr + 24, rot.w, 'float');
-                        
-                        // Radius (1 float)
-                        setValue(outPosePtr + 28, jointPose.radius || 0.01, 'float');
+                        WebXR._nativize_joint_pose(outPosePtr >> 2, jointPose);
                         
                         return 1; // Success
                     }
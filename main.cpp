@@ -1,14 +1,58 @@
 #include "raylib.h"
-#include "VRHandler.h"
+#include "VRHandlerT.h"
+#include "StaticSceneCache.h"
+#include "FrustumCuller.h"
+#include "AssetStreamer.h"
 #include <webxr.h>
+#ifdef __EMSCRIPTEN__
 #include <emscripten/emscripten.h>
+#else
+#include "native_shim.h"
+#endif
 #include <raymath.h>
 #include <rlgl.h>
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Frame handling is bound at compile time through VRHandlerT
+class DemoApp : public VRHandlerT<DemoApp> {
+public:
+    void onFrame(int time, float modelMatrix[16], WebXRView* views, void* handData);
+    void onGesture(const HandGestures::Event& event);
+};
 
 int screenWidth = 800;
 int screenHeight = 600;
-VRHandler* vrHandler = nullptr;
+DemoApp* vrHandler = nullptr;
+StaticSceneCache* staticScene = nullptr;
+FrustumCuller* sceneCuller = nullptr;
+
+AssetStreamer* assets = nullptr;
+
+// Upload time allowed per frame; fetching and parsing happen off the frame
+const float ASSET_BUDGET_MS = 2.0f;
+
+// OBJ props placed around the player, streamed in after startup and culled
+// once per frame for both eyes
+struct PropModel {
+    AssetStreamer::Handle model;
+    AssetStreamer::Handle texture;
+    bool placed;
+};
+
+struct Prop {
+    int model;
+    Vector3 position;
+    float yaw;     // degrees
+    float scale;
+};
+
+std::vector<PropModel> propModels;
+std::vector<Prop> placements;     // every prop, added to props once its model is ready
+std::vector<Prop> props;          // indexed by culler object id
 
 extern "C" EMSCRIPTEN_KEEPALIVE void launchit(){
     if (vrHandler) {
@@ -22,25 +66,127 @@ extern "C" EMSCRIPTEN_KEEPALIVE void launch_ar(){
     }
 }
 
+extern "C" EMSCRIPTEN_KEEPALIVE void dump_profile(){
+    if (vrHandler) {
+        vrHandler->dumpProfile();
+    }
+}
+
+extern "C" EMSCRIPTEN_KEEPALIVE void start_recording(){
+    if (vrHandler) {
+        vrHandler->startRecording("/session.wxrt");
+    }
+}
+
+extern "C" EMSCRIPTEN_KEEPALIVE void stop_recording(){
+    if (vrHandler) {
+        vrHandler->stopRecording();
+    }
+}
+
+
+void BuildStaticScene(StaticSceneCache& cache) {
+    // Ground plane for VR
+    cache.addPlane((Vector3){ 0.0f, 0.0f, 0.0f }, (Vector2){ 20.0f, 20.0f }, GREEN);
+    
+    // Some cubes at different positions
+    cache.addCube((Vector3){ 0.0f, 0.5f, -3.0f }, 1.0f, 1.0f, 1.0f, RED);
+    cache.addCube((Vector3){ 2.0f, 0.5f, -5.0f }, 1.0f, 1.0f, 1.0f, BLUE);
+    cache.addCube((Vector3){ -2.0f, 0.5f, -4.0f }, 1.0f, 1.0f, 1.0f, YELLOW);
+    
+    // Cube wireframes for better visibility
+    cache.addCubeWires((Vector3){ 0.0f, 0.5f, -3.0f }, 1.0f, 1.0f, 1.0f, MAROON);
+    cache.addCubeWires((Vector3){ 2.0f, 0.5f, -5.0f }, 1.0f, 1.0f, 1.0f, DARKBLUE);
+    cache.addCubeWires((Vector3){ -2.0f, 0.5f, -4.0f }, 1.0f, 1.0f, 1.0f, ORANGE);
+    
+    // Reference grid
+    cache.addGrid(20, 1.0f);
+}
+
+void RequestProps(AssetStreamer& streamer) {
+    // The inner ring uses the first three, so they load first
+    const char* names[] = { "castle", "house", "market", "turret", "well", "bridge" };
+    for (int i = 0; i < 6; i++) {
+        int priority = i < 3 ? AssetStreamer::High : AssetStreamer::Normal;
+        PropModel prop = {};
+        prop.model = streamer.requestModel(TextFormat("resources/models/obj/%s.rmc", names[i]), priority);
+        prop.texture = streamer.requestTexture(TextFormat("resources/models/obj/%s_diffuse.png", names[i]), priority);
+        propModels.push_back(prop);
+    }
+
+    // Two rings around the player, so about half the props are behind any view
+    for (int i = 0; i < 24; i++) {
+        float angle = i * (2.0f * PI / 12.0f) + (i >= 12 ? PI / 12.0f : 0.0f);
+        float radius = i >= 12 ? 22.0f : 12.0f;
+        int model = i >= 12 ? 3 + i % 3 : i % 3;
+        placements.push_back({ model, { sinf(angle) * radius, 0.0f, -cosf(angle) * radius }, -angle * RAD2DEG, 0.1f });
+    }
+}
+
+// Places the props whose model (and texture, unless it failed) finished loading
+void PlaceReadyProps(AssetStreamer& streamer, FrustumCuller& culler) {
+    for (PropModel& propModel : propModels) {
+        if (propModel.placed || !streamer.isReady(propModel.model)) continue;
+
+        AssetStreamer::State textureState = streamer.getState(propModel.texture);
+        if (textureState != AssetStreamer::State::Ready && textureState != AssetStreamer::State::Failed) continue;
+
+        Model* model = streamer.getModel(propModel.model);
+        if (textureState == AssetStreamer::State::Ready) {
+            model->materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = streamer.getTexture(propModel.texture);
+        }
+        propModel.placed = true;
+
+        int index = (int)(&propModel - propModels.data());
+        BoundingBox bounds = GetModelBoundingBox(*model);
+        for (const Prop& prop : placements) {
+            if (prop.model != index) continue;
+            Matrix transform = MatrixMultiply(MatrixMultiply(MatrixScale(prop.scale, prop.scale, prop.scale),
+                                                             MatrixRotateY(prop.yaw * DEG2RAD)),
+                                              MatrixTranslate(prop.position.x, prop.position.y, prop.position.z));
+            culler.add(FrustumCuller::transformBounds(bounds, transform));
+            props.push_back(prop);
+        }
+    }
+}
+
+void StreamAssets() {
+    FrameProfiler::Scope scope(vrHandler->getProfiler(), FrameProfiler::AssetUpload);
+    assets->update(ASSET_BUDGET_MS);
+    PlaceReadyProps(*assets, *sceneCuller);
+}
+
+// Visible props nearest first, so the props in front fill the depth buffer before
+// the ones they hide. Distances and order live in the frame arena.
+FrameArena::Vector<int> SortPropsFrontToBack(FrameArena& arena, const float viewer[3]) {
+    const std::vector<int>& visible = sceneCuller->getVisible();
+    float* distance = arena.allocate<float>(props.size());
+    for (int id : visible) {
+        float dx = props[id].position.x - viewer[0];
+        float dy = props[id].position.y - viewer[1];
+        float dz = props[id].position.z - viewer[2];
+        distance[id] = dx * dx + dy * dy + dz * dz;
+    }
+
+    FrameArena::Vector<int> order(visible.begin(), visible.end(), arena.allocator<int>());
+    std::sort(order.begin(), order.end(), [distance](int a, int b) { return distance[a] < distance[b]; });
+    return order;
+}
+
+void DrawProps(const int* ids, int count) {
+    for (int i = 0; i < count; i++) {
+        const Prop& prop = props[ids[i]];
+        DrawModelEx(*assets->getModel(propModels[prop.model].model), prop.position, (Vector3){ 0.0f, 1.0f, 0.0f }, prop.yaw,
+                    (Vector3){ prop.scale, prop.scale, prop.scale }, WHITE);
+    }
+}
 
-void DrawScene(int eyeIndex = -1, void* handData = nullptr) {
+void DrawScene(int eyeIndex, void* handData, const int* propIds, int propCount) {
     // Draw different background for AR vs VR
     if (!vrHandler || !vrHandler->isARSessionActive()) {
-        // Draw a ground plane for VR
-        DrawPlane((Vector3){ 0.0f, 0.0f, 0.0f }, (Vector2){ 20.0f, 20.0f }, GREEN);
-        
-        // Draw some cubes at different positions
-        DrawCube((Vector3){ 0.0f, 0.5f, -3.0f }, 1.0f, 1.0f, 1.0f, RED);
-        DrawCube((Vector3){ 2.0f, 0.5f, -5.0f }, 1.0f, 1.0f, 1.0f, BLUE);
-        DrawCube((Vector3){ -2.0f, 0.5f, -4.0f }, 1.0f, 1.0f, 1.0f, YELLOW);
-        
-        // Draw cube wireframes for better visibility
-        DrawCubeWires((Vector3){ 0.0f, 0.5f, -3.0f }, 1.0f, 1.0f, 1.0f, MAROON);
-        DrawCubeWires((Vector3){ 2.0f, 0.5f, -5.0f }, 1.0f, 1.0f, 1.0f, DARKBLUE);
-        DrawCubeWires((Vector3){ -2.0f, 0.5f, -4.0f }, 1.0f, 1.0f, 1.0f, ORANGE);
-        
-        // Add a reference grid
-        DrawGrid(20, 1.0f);
+        // Ground plane, cubes and grid are baked once into GPU buffers
+        staticScene->draw();
+        DrawProps(propIds, propCount);
     } else {
         // For AR, draw minimal virtual content that augments reality
         DrawCube((Vector3){ 0.0f, 0.0f, -1.0f }, 0.2f, 0.2f, 0.2f, (Color){255, 0, 0, 128});
@@ -53,86 +199,149 @@ void DrawScene(int eyeIndex = -1, void* handData = nullptr) {
     }
 }
 
-int main(void)
+void DemoApp::onGesture(const HandGestures::Event& event) {
+    VRLOG_DEBUG("%s hand %s %s (%.2f)", event.hand == 0 ? "Left" : "Right",
+                HandGestures::gestureName(event.gesture), event.active ? "started" : "ended", event.strength);
+}
+
+void DemoApp::onFrame(int time, float modelMatrix[16], WebXRView* views, void* handData) {
+    if (!isVRSessionActive()) {
+        SetWindowSize(views[0].viewport[2] * 2, views[0].viewport[3]);
+    }
+
+    StreamAssets();
+
+    // One cull covers both eyes
+    sceneCuller->cull(views);
+    FrameArena::Vector<int> propOrder = SortPropsFrontToBack(getFrameArena(), &modelMatrix[12]);
+
+    // Single pass records the scene once and rlgl replays the batch for both eyes
+    renderStereo(views, [handData, &propOrder](int eye) {
+        DrawScene(eye, handData, propOrder.data(), (int)propOrder.size());
+    });
+}
+
+Camera desktopCamera = {};
+bool showProfiler = false;
+
+// Desktop preview, one frame per main loop iteration outside XR sessions
+void DrawDesktopFrame() {
+    if (IsKeyPressed(KEY_P)) showProfiler = !showProfiler;
+
+    StreamAssets();
+
+    // Desktop fallback rendering
+    BeginDrawing();
+    ClearBackground(SKYBLUE);
+
+    float aspect = (float)GetScreenWidth() / (float)GetScreenHeight();
+    Matrix projection = MatrixPerspective(desktopCamera.fovy * DEG2RAD, aspect, RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR);
+    sceneCuller->cull(MatrixMultiply(GetCameraMatrix(desktopCamera), projection));
+
+    BeginMode3D(desktopCamera);
+    const std::vector<int>& visible = sceneCuller->getVisible();
+    DrawScene(-1, nullptr, visible.data(), (int)visible.size());
+    EndMode3D();
+
+    DrawText("Press 'Launch VR' or 'Launch AR' button to enter WebXR", 10, 10, 20, BLACK);
+    DrawText("Desktop preview - VR will use proper stereo rendering", 10, 40, 16, DARKGRAY);
+    DrawText("Features: Hand Tracking + Controller Support + AR", 10, 65, 16, DARKGRAY);
+    DrawText("Controllers: Purple=Left, Orange=Right spheres", 10, 90, 14, BLUE);
+    DrawText("Hands: Blue=Left, Red=Right joint tracking", 10, 110, 14, BLUE);
+    DrawText("P: toggle frame profiler (last XR session)", 10, 130, 14, DARKGRAY);
+
+    if (showProfiler) {
+        vrHandler->getProfiler().drawOverlay(10, 160, 14);
+
+        const FrustumCuller::Stats& culling = sceneCuller->getStats();
+        DrawText(TextFormat("culling: %d/%d visible, %d nodes tested", culling.objectsVisible,
+                            culling.objects, culling.nodesTested), 10, GetScreenHeight() - 24, 14, DARKGRAY);
+    }
+
+    EndDrawing();
+}
+
+int main(int argc, char** argv)
 {
     InitWindow(screenWidth, screenHeight, "WebXR Proper VR Rendering");
     
     // Initialize VR Handler
-    vrHandler = new VRHandler();
+    vrHandler = new DemoApp();
     vrHandler->initialize();
 
-    SetTargetFPS(90);
+    staticScene = new StaticSceneCache();
+    BuildStaticScene(*staticScene);
 
-    // Set up frame callback for VR rendering
-    vrHandler->setFrameHandler([](int time, float modelMatrix[16], WebXRView* views, void* handData) {
-        if (!vrHandler->isVRSessionActive()) {
-            SetWindowSize(views[0].viewport[2] * 2, views[0].viewport[3]);
-        }
+    sceneCuller = new FrustumCuller();
+    sceneCuller->setJobSystem(&vrHandler->getJobSystem());
+    assets = new AssetStreamer();
+    RequestProps(*assets);
 
-        // Extract projection matrices
-        Matrix leftProjectionMatrix = vrHandler->webXRToRaylibMatrix(views[0].projectionMatrix);
-        Matrix rightProjectionMatrix = vrHandler->webXRToRaylibMatrix(views[1].projectionMatrix);
-        
-        // Get the properly inverted view matrices for correct camera behavior
-        Matrix leftViewMatrix = vrHandler->invertWebXRViewMatrix(vrHandler->webXRToRaylibMatrix(views[0].viewMatrix));
-        Matrix rightViewMatrix = vrHandler->invertWebXRViewMatrix(vrHandler->webXRToRaylibMatrix(views[1].viewMatrix));
-
-        // Render to each eye's viewport within the single WebXR framebuffer
-        for (int eye = 0; eye < 2; eye++) {
-            auto& viewport = views[eye].viewport;
-            vrHandler->setViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
-            
-            if (vrHandler->isARSessionActive()) {
-                vrHandler->clearViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
-            } else {
-                vrHandler->clearViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
-            }
-
-            Matrix eyeProjection = (eye == 0) ? leftProjectionMatrix : rightProjectionMatrix;
-            Matrix eyeView = (eye == 0) ? leftViewMatrix : rightViewMatrix;
-            
-            rlSetMatrixProjection(eyeProjection);
-            rlSetMatrixModelview(eyeView);
-
-            DrawScene(eye, handData);
-            
-            rlDrawRenderBatchActive();
-        }
-    });
-    
-    // Set up controller handler
-    vrHandler->setControllerHandler([](WebXRInputSource* source, int sourceId) {
-        // Custom controller processing can be added here
-    });
+#ifndef __EMSCRIPTEN__
+    // The browser paces the desktop loop with requestAnimationFrame
+    SetTargetFPS(90);
+#endif
+    vrHandler->setStereoMode(VRHandler::StereoMode::SinglePass);
+    vrHandler->setPosePrediction(true);
+    vrHandler->setGestureRecognition(true);
+    vrHandler->setDynamicResolution(true);
+    vrHandler->setFoveation(0.5f);
 
     // Desktop fallback camera for testing
-    Camera camera = {};
-    camera.position = (Vector3){ 0.0f, 1.6f, 3.0f };
-    camera.target = (Vector3){ 0.0f, 1.0f, 0.0f };
-    camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
-    camera.fovy = 45.0f;
-    camera.projection = CAMERA_PERSPECTIVE;
-
-    while (!WindowShouldClose()) {
-        if (!vrHandler || !vrHandler->isVRSessionActive()) {
-            // Desktop fallback rendering
-            BeginDrawing();
-            ClearBackground(SKYBLUE);
-            
-            BeginMode3D(camera);
-            DrawScene(-1, nullptr);
-            EndMode3D();
-            
-            DrawText("Press 'Launch VR' or 'Launch AR' button to enter WebXR", 10, 10, 20, BLACK);
-            DrawText("Desktop preview - VR will use proper stereo rendering", 10, 40, 16, DARKGRAY);
-            DrawText("Features: Hand Tracking + Controller Support + AR", 10, 65, 16, DARKGRAY);
-            DrawText("Controllers: Purple=Left, Orange=Right spheres", 10, 90, 14, BLUE);
-            DrawText("Hands: Blue=Left, Red=Right joint tracking", 10, 110, 14, BLUE);
-            
-            EndDrawing();
+    desktopCamera.position = (Vector3){ 0.0f, 1.6f, 3.0f };
+    desktopCamera.target = (Vector3){ 0.0f, 1.0f, 0.0f };
+    desktopCamera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+    desktopCamera.fovy = 45.0f;
+    desktopCamera.projection = CAMERA_PERSPECTIVE;
+
+    bool desktopLoop = true;
+#ifndef __EMSCRIPTEN__
+    // Native builds: --xr / --ar run one session on the linked backend
+    // (webxr_stub.cpp or webxr_replay.cpp), print the profile and exit
+    for (int i = 1; i < argc && desktopLoop; i++) {
+        bool ar = strcmp(argv[i], "--ar") == 0;
+        if (ar || strcmp(argv[i], "--xr") == 0) {
+            if (ar) launch_ar(); else launchit();
+            vrHandler->dumpProfile();
+            const FrustumCuller::Stats& culling = sceneCuller->getStats();
+            VRLOG_INFO("Culling (last frame): %d of %d objects visible, %d nodes and %d objects tested",
+                       culling.objectsVisible, culling.objects, culling.nodesTested, culling.objectsTested);
+            const AssetStreamer::Stats& streaming = assets->getStats();
+            VRLOG_INFO("Assets: %d ready, %d failed, %d still loading, %lld bytes fetched",
+                       streaming.ready, streaming.failed, streaming.queued + streaming.loading + streaming.uploading,
+                       streaming.bytesFetched);
+            const VRHandler::InputEventStats& input = vrHandler->getInputEventStats();
+            VRLOG_INFO("Input events: %d drained, %d dropped, at most %d per frame, oldest %.1f ms",
+                       input.received, input.dropped, input.maxPerFrame, input.maxAge);
+            const FrameArena::Stats& arena = vrHandler->getFrameArena().getStats();
+            VRLOG_INFO("Frame arena: %zu bytes last frame, peak %zu of %zu, %d overflows",
+                       arena.lastFrame, arena.highWater, arena.capacity, arena.overflows);
+            JobSystem::Stats jobs = vrHandler->getJobSystem().getStats();
+            VRLOG_INFO("Jobs: %d workers, %lld jobs run, %lld stolen, %lld inline",
+                       jobs.workers, jobs.jobs, jobs.stolen, jobs.inlined);
+            const VRHandler::StereoStats& stereo = vrHandler->getStereoStats();
+            VRLOG_INFO("Stereo (last frame): %d scene passes, %d pixels shaded, foveation %.2f (%s)",
+                       stereo.scenePasses, stereo.pixelsShaded, vrHandler->getFoveation(),
+                       vrHandler->isRuntimeFoveation() ? "runtime" : vrHandler->isSoftwareFoveation() ? "software" : "off");
+            const ResolutionController::Stats& resolution = vrHandler->getResolutionController().getStats();
+            VRLOG_INFO("Resolution: scale %.2f, %d of %d frames missed, %d shrinks, %d grows (%d undone)",
+                       resolution.scale, resolution.missedFrames, resolution.frames,
+                       resolution.shrinks, resolution.grows, resolution.failedGrows);
+            VRLog::flush();
+            desktopLoop = false;
         }
     }
+#endif
+
+    if (desktopLoop) {
+        // Paused while an XR session runs; on the web this does not return
+        vrHandler->runDesktopLoop(DrawDesktopFrame);
+    }
 
+    assets->unloadAll();
+    delete assets;
+    delete sceneCuller;
+    delete staticScene;
     delete vrHandler;
     CloseWindow();
     return 0;
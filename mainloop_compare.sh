@@ -0,0 +1,82 @@
+#!/bin/sh
+# Wasm size and idle CPU of the desktop preview, emscripten_set_main_loop against
+# the while (!WindowShouldClose()) loop under -s ASYNCIFY it replaced.
+#
+#   ./mainloop_compare.sh [baseline rev] [seconds]    default: the commit before the change, 20 s
+#
+# Exports the baseline revision with git archive and builds both trees with
+# make (needs emsdk and RAYLIB_PATH pointing at a web build of raylib). Prints
+# game.wasm and game.js sizes, raw and gzipped. With CHROME set to a Chrome or
+# Chromium binary it then serves each build, opens game.html headless and
+# samples the CPU time of the browser's processes over `seconds` after a 5 s
+# warm-up. No XR session starts there, so this is the page idling in the
+# desktop preview; swiftshader renders, so absolute numbers run high.
+set -e
+
+BASELINE=${1:-$(git log --format=%h -1 --grep='Drive the desktop preview from emscripten_set_main_loop')^}
+SECONDS_IDLE=${2:-20}
+RAYLIB_PATH=${RAYLIB_PATH:-../raylib}
+PORT=${PORT:-8731}
+
+case $RAYLIB_PATH in
+    /*) ;;
+    *) RAYLIB_PATH=$(pwd)/$RAYLIB_PATH ;;
+esac
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+mkdir "$WORK/baseline" "$WORK/current"
+git archive "$BASELINE" | tar -x -C "$WORK/baseline"
+git archive HEAD | tar -x -C "$WORK/current"
+
+for tree in baseline current; do
+    make -s -C "$WORK/$tree" game.html RAYLIB_PATH="$RAYLIB_PATH" >/dev/null
+done
+
+size() {
+    wc -c < "$1" | tr -d ' '
+}
+
+gzsize() {
+    gzip -9 -c "$1" | wc -c | tr -d ' '
+}
+
+# utime + stime in clock ticks of the processes under $1, itself included
+cputicks() {
+    pids="$1 $(pgrep -P "$1" 2>/dev/null) $(for p in $(pgrep -P "$1" 2>/dev/null); do pgrep -P "$p"; done)"
+    total=0
+    for p in $pids; do
+        [ -r "/proc/$p/stat" ] || continue
+        ticks=$(awk '{ sub(/^.*\) /, ""); print $12 + $13 }' "/proc/$p/stat")
+        total=$((total + ticks))
+    done
+    echo "$total"
+}
+
+idlecpu() {
+    (cd "$1" && exec python3 -m http.server "$PORT" >/dev/null 2>&1) &
+    server=$!
+    sleep 1
+    "$CHROME" --headless=new --no-sandbox --use-angle=swiftshader --enable-unsafe-swiftshader \
+        --user-data-dir="$WORK/profile-$2" "http://localhost:$PORT/game.html" >/dev/null 2>&1 &
+    browser=$!
+    sleep 5
+    start=$(cputicks "$browser")
+    sleep "$SECONDS_IDLE"
+    end=$(cputicks "$browser")
+    kill "$browser" "$server" 2>/dev/null || true
+    wait "$browser" "$server" 2>/dev/null || true
+    awk -v ticks=$((end - start)) -v hz="$(getconf CLK_TCK)" -v s="$SECONDS_IDLE" \
+        'BEGIN { printf "%.1f", 100.0 * ticks / hz / s }'
+}
+
+echo "baseline $BASELINE against HEAD"
+printf "%-10s %12s %12s %12s %12s %10s\n" "build" "wasm" "wasm gz" "js" "js gz" "idle cpu%"
+for tree in baseline current; do
+    cpu="-"
+    if [ -n "$CHROME" ]; then cpu=$(idlecpu "$WORK/$tree" "$tree"); fi
+    printf "%-10s %12s %12s %12s %12s %10s\n" "$tree" \
+        "$(size "$WORK/$tree/game.wasm")" "$(gzsize "$WORK/$tree/game.wasm")" \
+        "$(size "$WORK/$tree/game.js")" "$(gzsize "$WORK/$tree/game.js")" "$cpu"
+done
@@ -0,0 +1,241 @@
+// Offline converter and native load benchmark for the binary mesh cache (.rmc).
+//
+//   meshcache_tool convert <model> [out.rmc]   writes <model>.rmc by default
+//   meshcache_tool bench <model>...            LoadModel vs runtime OBJ parse vs cache
+//
+// OBJ goes through AssetStreamer::parseOBJ, the parser the streamer uses at
+// runtime; other formats (glTF, IQM) through raylib's LoadModel, static
+// meshes only. The benchmark converts a model first when its .rmc is missing.
+#include "raylib.h"
+#include "AssetStreamer.h"
+#include "FrameProfiler.h"
+#include "MeshCache.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+    const int BENCH_RUNS = 5;
+
+    bool windowOpen = false;
+
+    // LoadModel uploads to the GPU, which needs a context
+    void ensureWindow() {
+        if (windowOpen) return;
+        SetTraceLogLevel(LOG_WARNING);
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
+        InitWindow(64, 64, "meshcache_tool");
+        windowOpen = true;
+    }
+
+    std::string cachePath(const char* model) {
+        std::string path = model;
+        size_t dot = path.find_last_of('.');
+        if (dot != std::string::npos && path.find_first_of("/\\", dot) == std::string::npos) path.resize(dot);
+        return path + ".rmc";
+    }
+
+    void freeMeshes(std::vector<Mesh>& meshes) {
+        for (Mesh& mesh : meshes) UnloadMesh(mesh);
+        meshes.clear();
+    }
+
+    // CPU-side meshes of a model file, in the caller's ownership
+    bool readMeshes(const char* path, std::vector<Mesh>& meshes) {
+        if (IsFileExtension(path, ".obj")) {
+            char* text = LoadFileText(path);
+            if (!text) return false;
+            bool ok = AssetStreamer::parseOBJ(text, meshes);
+            UnloadFileText(text);
+            return ok;
+        }
+
+        ensureWindow();
+        Model model = LoadModel(path);
+        for (int i = 0; i < model.meshCount; i++) {
+            meshes.push_back(model.meshes[i]);
+            model.meshes[i] = Mesh{};
+        }
+        UnloadModel(model);
+        return !meshes.empty();
+    }
+
+    bool convert(const char* input, const std::string& output) {
+        std::vector<Mesh> meshes;
+        if (!readMeshes(input, meshes)) {
+            fprintf(stderr, "%s: no meshes\n", input);
+            return false;
+        }
+
+        std::vector<unsigned char> image;
+        MeshCache::BuildStats stats;
+        bool ok = MeshCache::encode(meshes, image, &stats);
+        freeMeshes(meshes);
+        if (!ok || !SaveFileData(output.c_str(), image.data(), (int)image.size())) {
+            fprintf(stderr, "%s: conversion failed\n", input);
+            return false;
+        }
+
+        printf("%s -> %s: %d -> %d vertices, %d triangles, %d chunk(s), ACMR %.2f -> %.2f, %zu bytes\n",
+               input, output.c_str(), stats.inputVertices, stats.vertices, stats.triangles, stats.chunks,
+               stats.acmrBefore, stats.acmrAfter, stats.bytes);
+        return true;
+    }
+
+    enum Loader { RaylibLoadModel, RuntimeParse, Cache, LoaderCount };
+
+    const char* loaderName(int loader) {
+        static const char* names[LoaderCount] = { "LoadModel", "parseOBJ", "cache" };
+        return names[loader];
+    }
+
+    // Loads and uploads the model the way each loader would, then frees it again
+    bool loadOnce(int loader, const char* model, const std::string& cache) {
+        if (loader == RaylibLoadModel) {
+            Model loaded = LoadModel(model);
+            bool ok = loaded.meshCount > 0;
+            UnloadModel(loaded);
+            return ok;
+        }
+
+        std::vector<Mesh> meshes;
+        bool ok;
+        if (loader == RuntimeParse) {
+            char* text = LoadFileText(model);
+            ok = text && AssetStreamer::parseOBJ(text, meshes);
+            if (text) UnloadFileText(text);
+        } else {
+            // Decoded straight from a read-only mapping, no copy of the file
+            int fd = open(cache.c_str(), O_RDONLY);
+            struct stat info;
+            if (fd < 0 || fstat(fd, &info) != 0) {
+                if (fd >= 0) close(fd);
+                return false;
+            }
+            void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (mapped == MAP_FAILED) return false;
+            ok = MeshCache::decode(mapped, info.st_size, meshes);
+            munmap(mapped, info.st_size);
+        }
+
+        for (Mesh& mesh : meshes) UploadMesh(&mesh, false);
+        freeMeshes(meshes);
+        return ok;
+    }
+
+    struct Measurement {
+        bool ok;
+        double medianMs;
+        long peakKB;    // growth of the peak resident set over the first load
+    };
+
+    // Each loader runs in its own process so allocator state and peak RSS of one
+    // do not leak into the next
+    Measurement measure(int loader, const char* model, const std::string& cache) {
+        Measurement result = {};
+        int channel[2];
+        if (pipe(channel) != 0) return result;
+
+        fflush(stdout);
+        pid_t child = fork();
+        if (child == 0) {
+            close(channel[0]);
+            ensureWindow();
+
+            struct rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+            long peakBefore = usage.ru_maxrss;
+
+            double times[BENCH_RUNS];
+            bool ok = true;
+            for (int run = 0; run < BENCH_RUNS; run++) {
+                double start = FrameProfiler::now();
+                ok = loadOnce(loader, model, cache) && ok;
+                times[run] = FrameProfiler::now() - start;
+                if (run == 0) {
+                    getrusage(RUSAGE_SELF, &usage);
+                    result.peakKB = usage.ru_maxrss - peakBefore;
+                }
+            }
+            std::sort(times, times + BENCH_RUNS);
+            result.ok = ok;
+            result.medianMs = times[BENCH_RUNS / 2];
+
+            ssize_t written = write(channel[1], &result, sizeof(result));
+            _exit(written == (ssize_t)sizeof(result) ? 0 : 1);
+        }
+
+        close(channel[1]);
+        if (child > 0) {
+            if (read(channel[0], &result, sizeof(result)) != (ssize_t)sizeof(result)) result = {};
+            waitpid(child, nullptr, 0);
+        }
+        close(channel[0]);
+        return result;
+    }
+
+    int bench(int count, char** models) {
+        printf("%-40s %-10s %10s %10s\n", "model", "loader", "median ms", "peak KB");
+        for (int i = 0; i < count; i++) {
+            const char* model = models[i];
+            std::string cache = cachePath(model);
+            // Converted in a child too: the parent never opens a window it would fork with
+            if (!FileExists(cache.c_str())) {
+                fflush(stdout);
+                pid_t child = fork();
+                if (child == 0) {
+                    bool ok = convert(model, cache);
+                    fflush(stdout);
+                    _exit(ok ? 0 : 1);
+                }
+                int status = 1;
+                if (child > 0) waitpid(child, &status, 0);
+                if (status != 0) continue;
+            }
+
+            for (int loader = 0; loader < LoaderCount; loader++) {
+                // The runtime parser only reads OBJ
+                if (loader == RuntimeParse && !IsFileExtension(model, ".obj")) continue;
+
+                Measurement m = measure(loader, model, cache);
+                if (!m.ok) {
+                    printf("%-40s %-10s %10s %10s\n", model, loaderName(loader), "failed", "-");
+                    continue;
+                }
+                printf("%-40s %-10s %10.3f %10ld\n", model, loaderName(loader), m.medianMs, m.peakKB);
+            }
+        }
+        return 0;
+    }
+
+    int usage() {
+        fprintf(stderr, "usage: meshcache_tool convert <model> [out.rmc]\n"
+                        "       meshcache_tool bench <model>...\n");
+        return 1;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) return usage();
+
+    int result;
+    if (strcmp(argv[1], "convert") == 0 && argc <= 4) {
+        result = convert(argv[2], argc == 4 ? std::string(argv[3]) : cachePath(argv[2])) ? 0 : 1;
+    } else if (strcmp(argv[1], "bench") == 0) {
+        result = bench(argc - 2, argv + 2);
+    } else {
+        return usage();
+    }
+
+    if (windowOpen) CloseWindow();
+    return result;
+}
@@ -0,0 +1,66 @@
+#include "native_shim.h"
+#include "raylib.h"
+#include <rlgl.h>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+// Native versions of the EM_JS helpers in VRHandler.cpp
+
+extern "C" void console_log_vr(const char* msg) {
+    printf("%s\n", msg);
+    fflush(stdout);
+}
+
+extern "C" void init_webgl_context_vr() {
+}
+
+extern "C" void set_viewport_vr(int x, int y, int width, int height) {
+    rlViewport(x, y, width, height);
+}
+
+extern "C" void clear_viewport_vr(int x, int y, int width, int height, int r, int g, int b, int a) {
+    rlEnableScissorTest();
+    rlScissor(x, y, width, height);
+    rlClearColor(r, g, b, a);
+    rlClearScreenBuffers();
+    rlDisableScissorTest();
+}
+
+// The stub backends render straight to the window's default framebuffer
+extern "C" void bind_layer_framebuffer_vr() {
+    rlDisableFramebuffer();
+}
+
+extern "C" void download_file_vr(const char* path) {
+    printf("Session trace written to %s\n", path);
+}
+
+namespace {
+    bool mainLoopPaused = false;
+    bool mainLoopCancelled = false;
+}
+
+// fps is ignored: EndDrawing paces frames with SetTargetFPS, as on the desktop
+extern "C" void emscripten_set_main_loop(em_callback_func func, int fps, int simulate_infinite_loop) {
+    mainLoopCancelled = false;
+    while (!mainLoopCancelled && !WindowShouldClose()) {
+        if (mainLoopPaused) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        func();
+    }
+}
+
+extern "C" void emscripten_pause_main_loop(void) {
+    mainLoopPaused = true;
+}
+
+extern "C" void emscripten_resume_main_loop(void) {
+    mainLoopPaused = false;
+}
+
+extern "C" void emscripten_cancel_main_loop(void) {
+    mainLoopCancelled = true;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+// Stand-ins for the Emscripten APIs used by the app, for host (non-web) builds.
+// EM_JS helpers become plain C declarations implemented in native_shim.cpp.
+
+#ifndef EMSCRIPTEN_KEEPALIVE
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+
+#define EM_JS(ret, name, params, ...) extern "C" ret name params;
+
+// Main loop: emscripten_set_main_loop blocks, calling func until the window
+// closes or the loop is cancelled. Paused iterations sleep instead of drawing.
+typedef void (*em_callback_func)(void);
+extern "C" void emscripten_set_main_loop(em_callback_func func, int fps, int simulate_infinite_loop);
+extern "C" void emscripten_pause_main_loop(void);
+extern "C" void emscripten_resume_main_loop(void);
+extern "C" void emscripten_cancel_main_loop(void);
@@ -0,0 +1,124 @@
+// Pose prediction error over a recorded session: where PosePredictor put each
+// grip and hand joint against where the trace has it at the target time.
+//
+//   prediction_test [trace.wxrt] [latency ms]
+//
+// Without a trace it first records one from the stub backend (two cycles of
+// controllers and hands, 1800 frames) into a temporary file under $TMPDIR,
+// removed again once loaded. Every frame of the trace is fed to a
+// PosePredictor the way VRHandler does before the frame handler, with a horizon
+// of the recorded display delta plus `latency` (default 2 ms), which stands in
+// for the callback duration VRHandler adds. The predictor scores each
+// prediction against the later samples that bracket its target time.
+//
+// The trace is run twice: as recorded, with the runtime's grip velocities where
+// it reported them, and with those stripped, so grips fall back to velocities
+// from their sample history like hand joints always do. Exits 1 if prediction
+// does not lower the mean error of grips or joints in either run.
+#include "PosePredictor.h"
+#include "SessionTrace.h"
+#include "VRHandler.h"
+#include "FrameProfiler.h"
+#include "webxr_stub.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+
+namespace {
+    const int RECORDED_FRAMES = 1800;
+
+    bool recordStubSession(const char* path) {
+        VRHandler vr;
+        vr.initialize();
+        vr.setFrameHandler([](int time, float modelMatrix[16], WebXRView* views, void* handData) {});
+        if (!vr.startRecording(path)) return false;
+        webxr_stub_run(RECORDED_FRAMES);
+        vr.stopRecording();
+        return true;
+    }
+
+    bool report(const char* name, const PosePredictor::Stats& stats) {
+        bool improved = stats.samples > 0 && stats.meanError < stats.meanErrorUnpredicted;
+        printf("%-30s %8d %12.3f %12.3f %10.3f %6s\n", name, stats.samples, stats.meanErrorUnpredicted,
+               stats.meanError, stats.maxError, stats.samples == 0 ? "-" : improved ? "ok" : "WORSE");
+        return improved || stats.samples == 0;
+    }
+
+    // Returns false if prediction made the mean error worse
+    bool run(const SessionTraceReader& trace, float latency, bool runtimeVelocities, int* checked) {
+        PosePredictor predictor;
+        WebXRFrameData frame;
+        WebXRInputSnapshot input;
+        WebXRFrameStats stats;
+        double predictTime = 0.0;
+
+        for (int i = 0; i < trace.getFrameCount(); i++) {
+            int time;
+            memset(&stats, 0, sizeof(stats));
+            if (!trace.readFrame(i, &time, &frame, &input, &stats)) break;
+            if (!runtimeVelocities) {
+                for (int k = 0; k < input.count; k++) input.inputs[k].hasGripVelocity = 0;
+            }
+
+            double start = FrameProfiler::now();
+            predictor.predict(time, stats.predictedDisplayDelta + latency, input, frame.hands, frame.handDetected);
+            predictTime += FrameProfiler::now() - start;
+        }
+
+        const char* variant = runtimeVelocities ? "as recorded" : "history only";
+        char name[64];
+        snprintf(name, sizeof(name), "grips, %s", variant);
+        bool ok = report(name, predictor.getGripStats());
+        snprintf(name, sizeof(name), "joints, %s", variant);
+        ok = report(name, predictor.getJointStats()) && ok;
+        printf("%-30s %.2f us per frame\n", "", predictTime * 1000.0 / trace.getFrameCount());
+
+        *checked += predictor.getGripStats().samples + predictor.getJointStats().samples;
+        return ok;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string recorded;
+    if (argc <= 1) {
+        const char* tmp = getenv("TMPDIR");
+        recorded = std::string(tmp && *tmp ? tmp : "/tmp") + "/prediction_test_XXXXXX";
+        int fd = mkstemp(&recorded[0]);
+        if (fd >= 0) close(fd);
+        if (fd < 0 || !recordStubSession(recorded.c_str())) {
+            printf("could not record %s\n", recorded.c_str());
+            if (fd >= 0) remove(recorded.c_str());
+            return 1;
+        }
+    }
+    const char* path = argc > 1 ? argv[1] : recorded.c_str();
+    float latency = argc > 2 ? (float)atof(argv[2]) : 2.0f;
+
+    SessionTraceReader trace;
+    bool opened = trace.open(path);
+    if (argc <= 1) remove(path);
+    if (!opened) {
+        printf("could not read trace %s\n", path);
+        return 1;
+    }
+
+    printf("%s: %d frames, horizon display delta + %.1f ms\n", argc > 1 ? path : "stub session", trace.getFrameCount(), latency);
+    printf("%-30s %8s %12s %12s %10s\n", "points", "samples", "raw mm", "predicted mm", "max mm");
+
+    int checked = 0;
+    bool ok = run(trace, latency, true, &checked);
+    ok = run(trace, latency, false, &checked) && ok;
+
+    if (checked == 0) {
+        printf("FAIL: no tracked grips or joints in the trace\n");
+        return 1;
+    }
+    if (!ok) {
+        printf("FAIL: prediction raised the mean error\n");
+        return 1;
+    }
+    printf("PASS: prediction lowers the mean error\n");
+    return 0;
+}
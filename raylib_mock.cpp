@@ -0,0 +1,373 @@
+#include "raylib_mock.h"
+#include "raymath.h"
+#include <rlgl.h>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    // rlgl batch limits for GL 3.3 / ES 3.0
+    const int BATCH_VERTICES = RL_DEFAULT_BATCH_BUFFER_ELEMENTS * 4;
+    const int BATCH_DRAWCALLS = 256;
+    const int MAX_SHADER_LOCATIONS = 32;
+    const int MAX_MATERIAL_MAPS = 12;
+    const int MAX_MESH_VERTEX_BUFFERS = 9;
+
+    struct State {
+        Matrix projection, modelview;
+        Matrix projectionStereo[2], viewOffsetStereo[2];
+        Matrix uniformMatrix;           // last rlSetUniformMatrix, the MVP of custom-shader draws
+        bool stereo;
+        int viewport[4];
+        int framebufferWidth, framebufferHeight;
+
+        // Pending batch: one draw per primitive mode change, like rlgl's draws[]
+        int batchModes[BATCH_DRAWCALLS];
+        int batchCounts[BATCH_DRAWCALLS];
+        int batchDraws;
+        int batchVertices;
+
+        unsigned int nextId;
+    };
+
+    State state = {
+        MatrixIdentity(), MatrixIdentity(),
+        { MatrixIdentity(), MatrixIdentity() }, { MatrixIdentity(), MatrixIdentity() },
+        MatrixIdentity(), false, { 0, 0, 800, 600 }, 800, 600,
+        {}, {}, 0, 0, 1
+    };
+    RaylibMock::Stats stats;
+    RaylibMock::Draw draws[RaylibMock::MAX_DRAWS];
+    int defaultShaderLocs[MAX_SHADER_LOCATIONS];
+
+    // One location per distinct name, shared by all shaders
+    int locationOf(const char* name) {
+        static char names[MAX_SHADER_LOCATIONS][64];
+        static int count = 0;
+        for (int i = 0; i < count; i++) {
+            if (strcmp(names[i], name) == 0) return i;
+        }
+        if (count == MAX_SHADER_LOCATIONS) return -1;
+        snprintf(names[count], sizeof(names[0]), "%s", name);
+        return count++;
+    }
+
+    void record(const int viewport[4], const Matrix& projection, const Matrix& modelview,
+                int vertices, int instances, bool streamed) {
+        stats.drawCalls++;
+        if (!streamed) stats.meshVertices += (long long)vertices * instances;
+        if (stats.draws == RaylibMock::MAX_DRAWS) return;
+
+        RaylibMock::Draw& draw = draws[stats.draws++];
+        memcpy(draw.viewport, viewport, sizeof(draw.viewport));
+        draw.projection = projection;
+        draw.modelview = modelview;
+        draw.vertices = vertices;
+        draw.instances = instances;
+        draw.streamed = streamed;
+    }
+
+    // Calls draw(viewport, projection, modelview) once, or once per half of the
+    // framebuffer with the stereo matrices, as rlgl and rmodels do
+    template<typename DrawFunction>
+    void forEachEye(const Matrix& modelview, const DrawFunction& draw) {
+        if (!state.stereo) {
+            draw(state.viewport, state.projection, modelview);
+            return;
+        }
+        int eyeWidth = state.framebufferWidth / 2;
+        for (int eye = 0; eye < 2; eye++) {
+            int viewport[4] = { eye * eyeWidth, 0, eyeWidth, state.framebufferHeight };
+            draw(viewport, state.projectionStereo[eye], MatrixMultiply(modelview, state.viewOffsetStereo[eye]));
+        }
+    }
+
+    void flushBatch() {
+        stats.flushes++;
+        if (state.batchVertices == 0) return;
+
+        forEachEye(state.modelview, [](const int* viewport, const Matrix& projection, const Matrix& modelview) {
+            for (int i = 0; i < state.batchDraws; i++) {
+                if (state.batchCounts[i] > 0) record(viewport, projection, modelview, state.batchCounts[i], 1, true);
+            }
+        });
+        if (state.stereo) {
+            state.viewport[0] = 0;
+            state.viewport[1] = 0;
+            state.viewport[2] = state.framebufferWidth;
+            state.viewport[3] = state.framebufferHeight;
+        }
+        state.batchDraws = 0;
+        state.batchVertices = 0;
+    }
+
+    // count vertices of mode, as raylib's immediate-mode shapes emit them
+    void stream(int mode, int count) {
+        rlCheckRenderBatchLimit(count);
+        rlBegin(mode);
+        for (int i = 0; i < count; i++) rlVertex3f(0.0f, 0.0f, 0.0f);
+        rlEnd();
+    }
+
+    void drawMesh(const Mesh& mesh, const Matrix& transform, int instances) {
+        int vertices = mesh.indices ? mesh.triangleCount * 3 : mesh.vertexCount;
+        forEachEye(MatrixMultiply(transform, state.modelview),
+                   [&](const int* viewport, const Matrix& projection, const Matrix& modelview) {
+            record(viewport, projection, modelview, vertices, instances, false);
+        });
+    }
+}
+
+namespace RaylibMock {
+    void reset() {
+        stats = {};
+    }
+
+    const Stats& getStats() {
+        return stats;
+    }
+
+    const Draw& getDraw(int index) {
+        return draws[index];
+    }
+}
+
+extern "C" {
+
+// rlgl matrices and state
+
+void rlSetMatrixProjection(Matrix proj) { state.projection = proj; }
+void rlSetMatrixModelview(Matrix view) { state.modelview = view; }
+Matrix rlGetMatrixModelview(void) { return state.modelview; }
+Matrix rlGetMatrixProjection(void) { return state.projection; }
+Matrix rlGetMatrixTransform(void) { return MatrixIdentity(); }
+
+// rlgl's parameter names are swapped: the first matrix is index 0, which is
+// drawn into the left half of the framebuffer (BeginVrStereoMode passes the
+// left eye first)
+void rlSetMatrixProjectionStereo(Matrix right, Matrix left) {
+    state.projectionStereo[0] = right;
+    state.projectionStereo[1] = left;
+}
+
+void rlSetMatrixViewOffsetStereo(Matrix right, Matrix left) {
+    state.viewOffsetStereo[0] = right;
+    state.viewOffsetStereo[1] = left;
+}
+
+Matrix rlGetMatrixProjectionStereo(int eye) { return state.projectionStereo[eye]; }
+Matrix rlGetMatrixViewOffsetStereo(int eye) { return state.viewOffsetStereo[eye]; }
+
+void rlEnableStereoRender(void) { state.stereo = true; }
+void rlDisableStereoRender(void) { state.stereo = false; }
+bool rlIsStereoRenderEnabled(void) { return state.stereo; }
+
+void rlSetFramebufferWidth(int width) { state.framebufferWidth = width; }
+void rlSetFramebufferHeight(int height) { state.framebufferHeight = height; }
+int rlGetFramebufferWidth(void) { return state.framebufferWidth; }
+int rlGetFramebufferHeight(void) { return state.framebufferHeight; }
+
+void rlViewport(int x, int y, int width, int height) {
+    state.viewport[0] = x;
+    state.viewport[1] = y;
+    state.viewport[2] = width;
+    state.viewport[3] = height;
+}
+
+void rlEnableScissorTest(void) {}
+void rlDisableScissorTest(void) {}
+void rlScissor(int x, int y, int width, int height) {}
+void rlClearColor(unsigned char r, unsigned char g, unsigned char b, unsigned char a) {}
+void rlClearScreenBuffers(void) { stats.clears++; }
+void rlEnableDepthTest(void) {}
+void rlDisableDepthTest(void) {}
+void rlEnableFramebuffer(unsigned int id) {}
+void rlDisableFramebuffer(void) {}
+
+// rlgl batch
+
+void rlDrawRenderBatchActive(void) { flushBatch(); }
+
+bool rlCheckRenderBatchLimit(int vCount) {
+    if (state.batchVertices + vCount < BATCH_VERTICES) return false;
+    flushBatch();
+    return true;
+}
+
+void rlBegin(int mode) {
+    if (state.batchDraws > 0 && state.batchModes[state.batchDraws - 1] == mode) return;
+    if (state.batchDraws == BATCH_DRAWCALLS) flushBatch();
+    state.batchModes[state.batchDraws] = mode;
+    state.batchCounts[state.batchDraws] = 0;
+    state.batchDraws++;
+}
+
+void rlEnd(void) {}
+
+void rlVertex3f(float x, float y, float z) {
+    if (state.batchDraws == 0) rlBegin(RL_TRIANGLES);
+    state.batchCounts[state.batchDraws - 1]++;
+    state.batchVertices++;
+    stats.vertices++;
+}
+
+void rlColor4ub(unsigned char r, unsigned char g, unsigned char b, unsigned char a) {}
+
+// rlgl buffers and shaders
+
+void rlEnableShader(unsigned int id) {}
+void rlDisableShader(void) {}
+void rlSetUniformMatrix(int locIndex, Matrix mat) { state.uniformMatrix = mat; }
+void rlSetUniform(int locIndex, const void* value, int uniformType, int count) {}
+unsigned int rlLoadVertexArray(void) { return state.nextId++; }
+bool rlEnableVertexArray(unsigned int vaoId) { return true; }
+void rlDisableVertexArray(void) {}
+unsigned int rlLoadVertexBuffer(const void* buffer, int size, bool dynamic) { return state.nextId++; }
+void rlUpdateVertexBuffer(unsigned int bufferId, const void* data, int dataSize, int offset) {}
+void rlUnloadVertexBuffer(unsigned int vboId) {}
+void rlUnloadVertexArray(unsigned int vaoId) {}
+void rlEnableVertexBuffer(unsigned int id) {}
+void rlDisableVertexBuffer(void) {}
+void rlSetVertexAttribute(unsigned int index, int compSize, int type, bool normalized, int stride, int offset) {}
+void rlEnableVertexAttribute(unsigned int index) {}
+void rlDisableVertexAttribute(unsigned int index) {}
+void rlSetVertexAttributeDivisor(unsigned int index, int divisor) {}
+
+void rlDrawVertexArray(int offset, int count) {
+    record(state.viewport, state.uniformMatrix, MatrixIdentity(), count, 1, false);
+}
+
+void rlDrawVertexArrayInstanced(int offset, int count, int instances) {
+    record(state.viewport, state.uniformMatrix, MatrixIdentity(), count, instances, false);
+}
+
+// raylib shapes, with the vertex counts of rshapes.c and rmodels.c
+
+void DrawLine3D(Vector3 startPos, Vector3 endPos, Color color) { stream(RL_LINES, 2); }
+void DrawCube(Vector3 position, float width, float height, float length, Color color) { stream(RL_TRIANGLES, 36); }
+void DrawCubeWires(Vector3 position, float width, float height, float length, Color color) { stream(RL_LINES, 24); }
+void DrawPlane(Vector3 centerPos, Vector2 size, Color color) { stream(RL_QUADS, 4); }
+void DrawGrid(int slices, float spacing) { stream(RL_LINES, (slices / 2 * 2 + 1) * 4); }
+
+void DrawSphere(Vector3 centerPos, float radius, Color color) {
+    // DrawSphereEx(centerPos, radius, 16, 16, color)
+    stream(RL_TRIANGLES, (16 + 2) * 16 * 6);
+}
+
+void DrawSphereWires(Vector3 centerPos, float radius, int rings, int slices, Color color) {
+    stream(RL_LINES, (rings + 2) * slices * 6);
+}
+
+void DrawTexturePro(Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint) {
+    stream(RL_QUADS, 4);
+}
+
+void DrawText(const char* text, int posX, int posY, int fontSize, Color color) {
+    for (const char* c = text; *c; c++) {
+        if (*c != ' ' && *c != '\n') stream(RL_QUADS, 4);
+    }
+}
+
+// raylib meshes, materials and shaders
+
+void DrawMesh(Mesh mesh, Material material, Matrix transform) { drawMesh(mesh, transform, 1); }
+
+void DrawMeshInstanced(Mesh mesh, Material material, const Matrix* transforms, int instances) {
+    drawMesh(mesh, MatrixIdentity(), instances);
+}
+
+Mesh GenMeshSphere(float radius, int rings, int slices) {
+    // par_shapes' parametric sphere without its degenerate pole triangles, unindexed
+    Mesh mesh = {};
+    mesh.vertexCount = 6 * slices * (rings > 1 ? rings - 1 : 1);
+    mesh.triangleCount = mesh.vertexCount / 3;
+    mesh.vertices = (float*)calloc(mesh.vertexCount * 3, sizeof(float));
+    mesh.normals = (float*)calloc(mesh.vertexCount * 3, sizeof(float));
+    mesh.texcoords = (float*)calloc(mesh.vertexCount * 2, sizeof(float));
+    UploadMesh(&mesh, false);
+    return mesh;
+}
+
+void UploadMesh(Mesh* mesh, bool dynamic) {
+    if (!mesh->vboId) mesh->vboId = (unsigned int*)calloc(MAX_MESH_VERTEX_BUFFERS, sizeof(unsigned int));
+    mesh->vaoId = state.nextId++;
+}
+
+void UnloadMesh(Mesh mesh) {
+    free(mesh.vertices);
+    free(mesh.texcoords);
+    free(mesh.texcoords2);
+    free(mesh.normals);
+    free(mesh.tangents);
+    free(mesh.colors);
+    free(mesh.indices);
+    free(mesh.animVertices);
+    free(mesh.animNormals);
+    free(mesh.boneIds);
+    free(mesh.boneWeights);
+    free(mesh.vboId);
+}
+
+Material LoadMaterialDefault(void) {
+    Material material = {};
+    material.shader.id = 1;
+    material.shader.locs = defaultShaderLocs;
+    material.maps = (MaterialMap*)calloc(MAX_MATERIAL_MAPS, sizeof(MaterialMap));
+    material.maps[MATERIAL_MAP_DIFFUSE].color = WHITE;
+    return material;
+}
+
+void UnloadMaterial(Material material) {
+    if (material.shader.locs != defaultShaderLocs) UnloadShader(material.shader);
+    free(material.maps);
+}
+
+Shader LoadShaderFromMemory(const char* vsCode, const char* fsCode) {
+    Shader shader = {};
+    shader.id = state.nextId++;
+    shader.locs = (int*)malloc(MAX_SHADER_LOCATIONS * sizeof(int));
+    for (int i = 0; i < MAX_SHADER_LOCATIONS; i++) shader.locs[i] = -1;
+    return shader;
+}
+
+void UnloadShader(Shader shader) {
+    if (shader.locs != defaultShaderLocs) free(shader.locs);
+}
+
+int GetShaderLocation(Shader shader, const char* uniformName) { return locationOf(uniformName); }
+int GetShaderLocationAttrib(Shader shader, const char* attribName) { return locationOf(attribName); }
+
+RenderTexture2D LoadRenderTexture(int width, int height) {
+    RenderTexture2D target = {};
+    target.id = state.nextId++;
+    target.texture.id = state.nextId++;
+    target.texture.width = width;
+    target.texture.height = height;
+    return target;
+}
+
+void UnloadRenderTexture(RenderTexture2D target) {}
+void SetTextureFilter(Texture2D texture, int filter) {}
+
+// raylib core
+
+bool WindowShouldClose(void) { return true; }   // no window to keep open
+
+void* MemAlloc(unsigned int size) { return calloc(size, 1); }
+void MemFree(void* ptr) { free(ptr); }
+
+const char* TextFormat(const char* text, ...) {
+    static char buffers[4][1024];
+    static int index = 0;
+    char* buffer = buffers[index];
+    index = (index + 1) % 4;
+
+    va_list args;
+    va_start(args, text);
+    vsnprintf(buffer, sizeof(buffers[0]), text, args);
+    va_end(args);
+    return buffer;
+}
+
+}
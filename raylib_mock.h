@@ -0,0 +1,36 @@
+#pragma once
+
+#include "raylib.h"
+
+// Headless stand-in for raylib and rlgl, linked instead of raylib by the native
+// test and benchmark targets. Nothing is rasterized, but every draw is
+// recorded with the viewport and matrices it would land in, the way rlgl
+// splits a batch across the two halves of the framebuffer in stereo mode, and
+// immediate-mode helpers (DrawCube, DrawSphere, ...) stream as many vertices
+// as raylib's own versions. Recording never allocates.
+namespace RaylibMock {
+    static const int MAX_DRAWS = 256;   // recorded per reset(); later draws are only counted
+
+    struct Draw {
+        int viewport[4];
+        Matrix projection;
+        Matrix modelview;       // view offset applied in stereo mode
+        int vertices;           // per instance
+        int instances;
+        bool streamed;          // from the rlgl batch, not a GPU-resident mesh
+    };
+
+    struct Stats {
+        long long vertices;         // streamed through rlVertex3f (immediate mode)
+        long long meshVertices;     // drawn from GPU buffers, every instance and eye counted
+        long long drawCalls;
+        long long flushes;          // rlDrawRenderBatchActive calls
+        long long clears;
+        int draws;                  // recorded since reset(), up to MAX_DRAWS
+    };
+
+    // Zeroes the stats and drops the recorded draws; GL state is kept
+    void reset();
+    const Stats& getStats();
+    const Draw& getDraw(int index);
+}
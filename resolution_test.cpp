@@ -0,0 +1,187 @@
+// Dynamic resolution under simulated GPU load: replays a trace with fixed GPU
+// costs per segment and checks that ResolutionController settles where its
+// header says, just below the largest scale that fits.
+//
+//   resolution_test [trace.wxrt] [gpu ms list]    default: a synthetic trace, 8,16,24
+//
+// Without a trace it writes a still 900-frame session to a temporary file. The
+// trace is looped to SEGMENT_FRAMES per cost, and webxr_replay simulates each
+// frame's interval from the cost at its viewport scale, on a 90 Hz display. A
+// frame fits when it takes one period, so the target in each segment is the
+// largest scale level whose cost fits. Over the second half of each segment
+// the test fails if the scale leaves that level by more than one step, if more
+// than MAX_MISS_RATE of the frames miss, or if failed growth steps come more
+// often than one per maxGrowDelay frames (the back-off is not holding).
+#include "VRHandler.h"
+#include "ResolutionController.h"
+#include "SessionTrace.h"
+#include "webxr_replay.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+    const int SYNTHETIC_FRAMES = 900;
+    const int SEGMENT_FRAMES = 2700;     // 30 s per cost
+    const int EYE_WIDTH = 1832;
+    const int EYE_HEIGHT = 1920;
+    const float FRAME_RATE = 90.0f;      // webxr_replay's simulated display
+    const float MAX_MISS_RATE = 0.02f;
+
+    struct FrameSample {
+        float scale;          // applied to this frame's viewports
+        int missedFrames;     // controller totals after the previous frame
+        int failedGrows;
+    };
+
+    // A session that stands still, side-by-side eyes of EYE_WIDTH x EYE_HEIGHT
+    bool writeSyntheticTrace(const char* path) {
+        SessionRecorder recorder;
+        if (!recorder.start(path, WEBXR_SESSION_MODE_IMMERSIVE_VR)) return false;
+
+        WebXRFrameData frame;
+        memset(&frame, 0, sizeof(frame));
+        for (int eye = 0; eye < 2; eye++) {
+            WebXRView& view = frame.views[eye];
+            view.viewMatrix[0] = view.viewMatrix[5] = view.viewMatrix[10] = view.viewMatrix[15] = 1.0f;
+            view.viewMatrix[13] = 1.6f;
+            view.projectionMatrix[0] = view.projectionMatrix[5] = 1.0f;
+            view.projectionMatrix[10] = view.projectionMatrix[11] = -1.0f;
+            view.viewport[0] = eye * EYE_WIDTH;
+            view.viewport[2] = EYE_WIDTH;
+            view.viewport[3] = EYE_HEIGHT;
+        }
+        frame.modelMatrix[0] = frame.modelMatrix[5] = frame.modelMatrix[10] = frame.modelMatrix[15] = 1.0f;
+        WebXRInputSnapshot input = {};
+        WebXRFrameStats stats = {};
+        stats.predictedDisplayDelta = 1000.0f / FRAME_RATE;
+
+        for (int i = 0; i < SYNTHETIC_FRAMES; i++) {
+            recorder.recordFrame((int)(i * 1000.0f / FRAME_RATE), frame, input, stats);
+        }
+        recorder.stop();
+        return true;
+    }
+
+    // Same rule as webxr_replay: a frame takes as many periods as its work needs
+    bool fits(float cost, float scale) {
+        float period = 1000.0f / FRAME_RATE;
+        return std::max(1.0f, ceilf(cost * scale * scale / period - 1e-3f)) <= 1.0f;
+    }
+
+    float targetScale(const ResolutionController::Settings& settings, float cost) {
+        float scale = settings.maxScale;
+        while (scale - settings.step >= settings.minScale - 1e-4f && !fits(cost, scale)) scale -= settings.step;
+        return scale;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string path;
+    if (argc > 1) {
+        path = argv[1];
+    } else {
+        const char* tmp = getenv("TMPDIR");
+        path = std::string(tmp && *tmp ? tmp : "/tmp") + "/resolution_test_XXXXXX";
+        int fd = mkstemp(&path[0]);
+        if (fd < 0 || (close(fd), !writeSyntheticTrace(path.c_str()))) {
+            printf("could not write a trace to %s\n", path.c_str());
+            return 1;
+        }
+    }
+    const char* costList = argc > 2 ? argv[2] : "8,16,24";
+
+    std::vector<float> costs;
+    for (const char* c = costList; *c;) {
+        char* end;
+        float cost = strtof(c, &end);
+        if (end == c) break;
+        costs.push_back(cost);
+        c = *end == ',' ? end + 1 : end;
+    }
+    setenv("WEBXR_REPLAY_GPU_MS", costList, 1);
+
+    VRHandler vr;
+    vr.initialize();
+    // Session start lines would break up the table
+    VRLog::setSink([](const char* text) {});
+    bool opened = webxr_replay_open(path.c_str()) != 0;
+    SessionTraceReader trace;
+    int traceFrames = opened && trace.open(path.c_str()) ? trace.getFrameCount() : 0;
+    if (argc <= 1) remove(path.c_str());
+    if (!opened || traceFrames == 0 || costs.empty()) {
+        printf("could not replay %s with GPU costs '%s'\n", argc > 1 ? path.c_str() : "the synthetic trace", costList);
+        return 1;
+    }
+
+    // Eye width of the trace's first frame is the full-resolution viewport
+    int time;
+    WebXRFrameData first;
+    WebXRInputSnapshot input;
+    trace.readFrame(0, &time, &first, &input, nullptr);
+    float fullWidth = (float)first.views[0].viewport[2];
+
+    std::vector<FrameSample> samples;
+    int loops = (SEGMENT_FRAMES * (int)costs.size() + traceFrames - 1) / traceFrames;
+    samples.reserve((size_t)loops * traceFrames);
+    vr.setFrameHandler([&vr, &samples, fullWidth](int time, float modelMatrix[16], WebXRView* views, void* handData) {
+        const ResolutionController::Stats& stats = vr.getResolutionController().getStats();
+        samples.push_back({ views[0].viewport[2] / fullWidth, stats.missedFrames, stats.failedGrows });
+    });
+    vr.setDynamicResolution(true);
+    WebXRReplayStats replayStats;
+    webxr_replay_run(loops, &replayStats);
+
+    const ResolutionController::Settings& settings = vr.getResolutionController().getSettings();
+    int total = (int)samples.size();
+    printf("%d frames, %d per GPU cost, settled over the second half of each\n", total, total / (int)costs.size());
+    printf("%8s %8s %10s %10s %10s %10s %12s\n", "gpu ms", "target", "min scale", "max scale", "end scale",
+           "miss rate", "failed grows");
+
+    bool ok = total > 0;
+    for (size_t s = 0; s < costs.size() && ok; s++) {
+        // webxr_replay assigns costs by the played frame's share of the run
+        int start = (int)(s * total / costs.size());
+        int end = (int)((s + 1) * total / costs.size());
+        int settled = start + (end - start) / 2;
+        float target = targetScale(settings, costs[s]);
+
+        float minScale = 1e9f, maxScale = 0.0f;
+        for (int i = settled; i < end; i++) {
+            minScale = std::min(minScale, samples[i].scale);
+            maxScale = std::max(maxScale, samples[i].scale);
+        }
+        // Frame i's sample holds the totals up to frame i - 1
+        int lastIndex = end < total ? end : total - 1;
+        int misses = samples[lastIndex].missedFrames - samples[settled].missedFrames;
+        int failedGrows = samples[lastIndex].failedGrows - samples[settled].failedGrows;
+        int window = lastIndex - settled;
+        float missRate = window > 0 ? (float)misses / window : 0.0f;
+        int allowedFailedGrows = window / settings.maxGrowDelay + 1;
+
+        printf("%8.1f %8.2f %10.2f %10.2f %10.2f %9.1f%% %12d\n", costs[s], target, minScale, maxScale,
+               samples[end - 1].scale, missRate * 100.0f, failedGrows);
+
+        float tolerance = settings.step + 1e-3f;
+        if (fabsf(minScale - target) > tolerance || fabsf(maxScale - target) > tolerance) {
+            printf("FAIL: %.1f ms: the scale did not settle within one step of %.2f\n", costs[s], target);
+            ok = false;
+        }
+        if (missRate > MAX_MISS_RATE) {
+            printf("FAIL: %.1f ms: %.1f%% of the settled frames missed\n", costs[s], missRate * 100.0f);
+            ok = false;
+        }
+        if (failedGrows > allowedFailedGrows) {
+            printf("FAIL: %.1f ms: %d failed growth steps in %d settled frames\n", costs[s], failedGrows, window);
+            ok = false;
+        }
+    }
+    if (!ok) return 1;
+    printf("PASS: the scale settles at the largest step that fits\n");
+    return 0;
+}
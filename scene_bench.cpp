@@ -0,0 +1,125 @@
+// Headless benchmark of the demo's static scene drawn through immediate mode
+// against StaticSceneCache, in vertices submitted per frame.
+//
+//   scene_bench [frames]    default 2000
+//
+// Both variants draw what main.cpp's BuildStaticScene holds: the ground plane,
+// three cubes, three wire cubes and the 20x20 grid. The immediate variant is
+// the DrawPlane/DrawCube/DrawCubeWires/DrawGrid sequence DrawScene used before
+// the cache. Frames go through VRHandler::renderStereo in MultiPass and
+// SinglePass against raylib_mock, which counts the vertices streamed through
+// the rlgl batch and those drawn from GPU-resident meshes. The times are the
+// CPU cost of submission against the mock, not of a real GL driver.
+#include "StaticSceneCache.h"
+#include "VRHandler.h"
+#include "FrameProfiler.h"
+#include "raylib_mock.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+    const int EYE_WIDTH = 1832;
+    const int EYE_HEIGHT = 1920;
+
+    void drawImmediate() {
+        DrawPlane((Vector3){ 0.0f, 0.0f, 0.0f }, (Vector2){ 20.0f, 20.0f }, GREEN);
+
+        DrawCube((Vector3){ 0.0f, 0.5f, -3.0f }, 1.0f, 1.0f, 1.0f, RED);
+        DrawCube((Vector3){ 2.0f, 0.5f, -5.0f }, 1.0f, 1.0f, 1.0f, BLUE);
+        DrawCube((Vector3){ -2.0f, 0.5f, -4.0f }, 1.0f, 1.0f, 1.0f, YELLOW);
+
+        DrawCubeWires((Vector3){ 0.0f, 0.5f, -3.0f }, 1.0f, 1.0f, 1.0f, MAROON);
+        DrawCubeWires((Vector3){ 2.0f, 0.5f, -5.0f }, 1.0f, 1.0f, 1.0f, DARKBLUE);
+        DrawCubeWires((Vector3){ -2.0f, 0.5f, -4.0f }, 1.0f, 1.0f, 1.0f, ORANGE);
+
+        DrawGrid(20, 1.0f);
+    }
+
+    // Same content as drawImmediate, as main.cpp's BuildStaticScene adds it
+    void buildCache(StaticSceneCache& cache) {
+        cache.addPlane((Vector3){ 0.0f, 0.0f, 0.0f }, (Vector2){ 20.0f, 20.0f }, GREEN);
+
+        cache.addCube((Vector3){ 0.0f, 0.5f, -3.0f }, 1.0f, 1.0f, 1.0f, RED);
+        cache.addCube((Vector3){ 2.0f, 0.5f, -5.0f }, 1.0f, 1.0f, 1.0f, BLUE);
+        cache.addCube((Vector3){ -2.0f, 0.5f, -4.0f }, 1.0f, 1.0f, 1.0f, YELLOW);
+
+        cache.addCubeWires((Vector3){ 0.0f, 0.5f, -3.0f }, 1.0f, 1.0f, 1.0f, MAROON);
+        cache.addCubeWires((Vector3){ 2.0f, 0.5f, -5.0f }, 1.0f, 1.0f, 1.0f, DARKBLUE);
+        cache.addCubeWires((Vector3){ -2.0f, 0.5f, -4.0f }, 1.0f, 1.0f, 1.0f, ORANGE);
+
+        cache.addGrid(20, 1.0f);
+    }
+
+    void makeViews(WebXRView views[2]) {
+        memset(views, 0, 2 * sizeof(WebXRView));
+        for (int eye = 0; eye < 2; eye++) {
+            float* p = views[eye].projectionMatrix;
+            p[0] = 0.9f;
+            p[5] = 0.8f;
+            p[10] = -1.0f;
+            p[11] = -1.0f;
+            p[14] = -0.02f;
+
+            float* v = views[eye].viewMatrix;
+            v[0] = v[5] = v[10] = v[15] = 1.0f;
+            v[12] = eye == 0 ? 0.032f : -0.032f;
+            v[13] = -1.6f;
+
+            views[eye].viewport[0] = eye * EYE_WIDTH;
+            views[eye].viewport[2] = EYE_WIDTH;
+            views[eye].viewport[3] = EYE_HEIGHT;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::max(atoi(argv[1]), 1) : 2000;
+
+    VRHandler vr;
+    vr.initialize();
+    WebXRView views[2];
+    makeViews(views);
+
+    StaticSceneCache cache;
+    buildCache(cache);
+    cache.draw();   // bakes outside the timed frames, as the demo does before its first frame
+
+    const VRHandler::StereoMode modes[2] = { VRHandler::StereoMode::MultiPass, VRHandler::StereoMode::SinglePass };
+    const char* modeNames[2] = { "multi-pass", "single-pass" };
+
+    printf("%d frames of the demo's static scene, both eyes\n", frames);
+    printf("%-24s %10s %10s %8s %10s\n", "variant", "streamed", "resident", "draws", "median us");
+
+    std::vector<float> times(frames);
+    for (int m = 0; m < 2; m++) {
+        vr.setStereoMode(modes[m]);
+        for (int cached = 0; cached < 2; cached++) {
+            RaylibMock::reset();
+            for (int frame = 0; frame < frames; frame++) {
+                double start = FrameProfiler::now();
+                if (cached) {
+                    vr.renderStereo(views, [&cache](int eye) { cache.draw(); });
+                } else {
+                    vr.renderStereo(views, [](int eye) { drawImmediate(); });
+                }
+                times[frame] = (float)((FrameProfiler::now() - start) * 1000.0);
+            }
+            std::sort(times.begin(), times.end());
+
+            const RaylibMock::Stats& stats = RaylibMock::getStats();
+            char name[64];
+            snprintf(name, sizeof(name), "%s, %s", cached ? "cache" : "immediate", modeNames[m]);
+            printf("%-24s %10lld %10lld %8.1f %10.2f\n", name, stats.vertices / frames, stats.meshVertices / frames,
+                   (double)stats.drawCalls / frames, times[frames / 2]);
+        }
+    }
+
+    const StaticSceneCache::Stats& stats = cache.getStats();
+    printf("cache per scene pass: %d mesh draw, %d resident vertices, %d streamed line vertices\n",
+           stats.drawCalls, stats.verticesResident, stats.verticesStreamed);
+    cache.unload();
+    return 0;
+}
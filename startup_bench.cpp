@@ -0,0 +1,142 @@
+// Native benchmark of startup: time to the first frame and to all props
+// loaded, for the preload build against asset streaming.
+//
+//   startup_bench [mbit/s]    network bandwidth for the web estimate, default 50
+//
+// Preload replays what the build did before AssetStreamer: the Emscripten
+// package holding all of resources/ is read into memory (the download and
+// unpack into MEMFS, from local disk here), then the six props are loaded with
+// LoadModel/LoadTexture from the OBJ files before the first frame. Streaming
+// requests the props' .rmc caches and textures as main.cpp does and runs
+// update() at 90 Hz frames with the demo's 2 ms budget until all are ready.
+//
+// Local disk hides the download, so the web estimate adds bytes / bandwidth:
+// the whole package before the first preload frame, and the streamed bytes
+// before the last prop is ready. Needs a GL context, so it opens a hidden window.
+#include "AssetStreamer.h"
+#include "FrameProfiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+namespace {
+    const char* RESOURCES = "resources";
+    const char* PROPS[] = { "castle", "house", "market", "turret", "well", "bridge" };
+    const int PROP_COUNT = 6;
+    const float FRAME_MS = 1000.0f / 90.0f;
+    const float ASSET_BUDGET_MS = 2.0f;
+
+    struct Startup {
+        double firstFrameMs;
+        double allReadyMs;
+        long long bytes;        // downloaded before the first frame (preload) or in total (streamed)
+        int frames;             // frames run until all props were ready
+    };
+
+    // Reads every file under resources/ into memory, as the preload package download and unpack did
+    long long readPackage(std::vector<std::vector<char>>& files) {
+        long long bytes = 0;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(RESOURCES)) {
+            if (!entry.is_regular_file()) continue;
+            FILE* file = fopen(entry.path().string().c_str(), "rb");
+            if (!file) continue;
+            std::vector<char> data((size_t)entry.file_size());
+            size_t read = fread(data.data(), 1, data.size(), file);
+            fclose(file);
+            bytes += (long long)read;
+            files.push_back(std::move(data));
+        }
+        return bytes;
+    }
+
+    Startup preload() {
+        Startup result = {};
+        double start = FrameProfiler::now();
+
+        std::vector<std::vector<char>> package;
+        result.bytes = readPackage(package);
+
+        Model models[PROP_COUNT];
+        Texture2D textures[PROP_COUNT];
+        for (int i = 0; i < PROP_COUNT; i++) {
+            models[i] = LoadModel(TextFormat("%s/models/obj/%s.obj", RESOURCES, PROPS[i]));
+            textures[i] = LoadTexture(TextFormat("%s/models/obj/%s_diffuse.png", RESOURCES, PROPS[i]));
+        }
+
+        // Everything was loaded before the first frame could start
+        result.firstFrameMs = result.allReadyMs = FrameProfiler::now() - start;
+        result.frames = 1;
+
+        for (int i = 0; i < PROP_COUNT; i++) {
+            UnloadModel(models[i]);
+            UnloadTexture(textures[i]);
+        }
+        return result;
+    }
+
+    Startup stream() {
+        Startup result = {};
+        double start = FrameProfiler::now();
+
+        AssetStreamer streamer;
+        for (int i = 0; i < PROP_COUNT; i++) {
+            // The inner ring uses the first three, so they load first
+            int priority = i < 3 ? AssetStreamer::High : AssetStreamer::Normal;
+            streamer.requestModel(TextFormat("%s/models/obj/%s.rmc", RESOURCES, PROPS[i]), priority);
+            streamer.requestTexture(TextFormat("%s/models/obj/%s_diffuse.png", RESOURCES, PROPS[i]), priority);
+        }
+
+        result.firstFrameMs = -1.0;
+        while (true) {
+            double frameStart = FrameProfiler::now();
+            streamer.update(ASSET_BUDGET_MS);
+            if (result.firstFrameMs < 0.0) result.firstFrameMs = FrameProfiler::now() - start;
+            result.frames++;
+            if (streamer.isIdle()) break;
+
+            double remaining = FRAME_MS - (FrameProfiler::now() - frameStart);
+            if (remaining > 0.0) std::this_thread::sleep_for(std::chrono::microseconds((long long)(remaining * 1000.0)));
+        }
+        result.allReadyMs = FrameProfiler::now() - start;
+        result.bytes = streamer.getStats().bytesFetched;
+
+        if (streamer.getStats().failed > 0) {
+            printf("%d streamed assets failed to load\n", streamer.getStats().failed);
+        }
+        streamer.unloadAll();
+        return result;
+    }
+
+    void report(const char* name, const Startup& startup, double downloadBeforeFirstFrameMs, double downloadMs) {
+        printf("%-10s %12.1f %12.1f %8d %10.1f %14.1f %14.1f\n", name, startup.firstFrameMs, startup.allReadyMs,
+               startup.frames, startup.bytes / 1048576.0, startup.firstFrameMs + downloadBeforeFirstFrameMs,
+               startup.allReadyMs + downloadMs);
+    }
+}
+
+int main(int argc, char** argv) {
+    float mbits = argc > 1 ? std::max((float)atof(argv[1]), 0.1f) : 50.0f;
+    double bytesPerMs = mbits * 1e6 / 8.0 / 1000.0;
+
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(64, 64, "startup_bench");
+
+    Startup preloaded = preload();
+    Startup streamed = stream();
+
+    printf("time to first frame and to all %d props, local disk; web adds the download at %.0f Mbit/s\n",
+           PROP_COUNT, mbits);
+    printf("%-10s %12s %12s %8s %10s %14s %14s\n", "build", "first ms", "ready ms", "frames", "MB",
+           "web first ms", "web ready ms");
+    double packageMs = preloaded.bytes / bytesPerMs;
+    report("preload", preloaded, packageMs, packageMs);
+    report("streamed", streamed, 0.0, streamed.bytes / bytesPerMs);
+
+    CloseWindow();
+    return 0;
+}
@@ -0,0 +1,240 @@
+// Checks VRHandler::renderStereo against raylib_mock's record of what rlgl
+// would draw: scene passes, batch flushes and draw calls for MultiPass and
+// SinglePass, and that each eye's projection and view land in that eye's
+// viewport (left eye in the left half). Also runs stub sessions with
+// foveation set before the session, as the demo does: with software foveation
+// opted in, its extra passes run only where the layer has no fixedFoveation.
+//
+//   stereo_test
+#include "VRHandler.h"
+#include "VRMath.h"
+#include "raylib_mock.h"
+#include "rlgl.h"
+#include "webxr_stub.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    const int EYE_WIDTH = 1832;
+    const int EYE_HEIGHT = 1920;
+    const int CUBE_VERTICES = 36;
+
+    int failures = 0;
+
+    void check(bool condition, const char* mode, const char* what) {
+        if (condition) return;
+        printf("FAIL %s: %s\n", mode, what);
+        failures++;
+    }
+
+    bool sameMatrix(const Matrix& a, const Matrix& b) {
+        const float* x = (const float*)&a;
+        const float* y = (const float*)&b;
+        for (int i = 0; i < 16; i++) {
+            if (fabsf(x[i] - y[i]) > 1e-5f) return false;
+        }
+        return true;
+    }
+
+    bool sameViewport(const int* a, int x, int y, int width, int height) {
+        return a[0] == x && a[1] == y && a[2] == width && a[3] == height;
+    }
+
+    // Asymmetric frusta and eye offsets that differ per eye, so a swap shows
+    void makeViews(WebXRView views[2], bool equalHalves) {
+        memset(views, 0, 2 * sizeof(WebXRView));
+        for (int eye = 0; eye < 2; eye++) {
+            WebXRView& view = views[eye];
+            float side = eye == 0 ? -1.0f : 1.0f;
+
+            // Column-major, as WebXR delivers them
+            float* p = view.projectionMatrix;
+            p[0] = 0.9f + 0.05f * eye;
+            p[5] = 0.8f;
+            p[8] = 0.1f * side;
+            p[10] = -1.0f;
+            p[11] = -1.0f;
+            p[14] = -0.02f;
+
+            float* v = view.viewMatrix;
+            v[0] = v[5] = v[10] = v[15] = 1.0f;
+            v[12] = 0.032f * side;
+            v[13] = 1.6f;
+
+            int width = equalHalves ? EYE_WIDTH : EYE_WIDTH - 200 * eye;
+            view.viewport[0] = eye * EYE_WIDTH;
+            view.viewport[2] = width;
+            view.viewport[3] = EYE_HEIGHT;
+        }
+    }
+
+    struct Scene {
+        int eyes[4];
+        int passes;
+    };
+
+    void drawScene(Scene& scene, int eye) {
+        if (scene.passes < 4) scene.eyes[scene.passes] = eye;
+        scene.passes++;
+        DrawCube({ 0.0f, 1.0f, -2.0f }, 0.5f, 0.5f, 0.5f, RED);
+    }
+
+    Scene render(VRHandler& vr, WebXRView views[2]) {
+        Scene scene = {};
+        RaylibMock::reset();
+        vr.renderStereo(views, [&scene](int eye) { drawScene(scene, eye); });
+        return scene;
+    }
+
+    void report(const char* mode, VRHandler& vr) {
+        const VRHandler::StereoStats& stereo = vr.getStereoStats();
+        const RaylibMock::Stats& mock = RaylibMock::getStats();
+        printf("%-22s %8d %8d %8lld %10lld\n", mode, stereo.scenePasses, stereo.batchFlushes, mock.drawCalls, mock.vertices);
+    }
+
+    void testMultiPass(VRHandler& vr) {
+        const char* mode = "MultiPass";
+        WebXRView views[2];
+        makeViews(views, true);
+        Matrix projection[2], view[2];
+        VRMath::convertViews(views, projection, view);
+
+        vr.setStereoMode(VRHandler::StereoMode::MultiPass);
+        Scene scene = render(vr, views);
+        report(mode, vr);
+
+        const RaylibMock::Stats& mock = RaylibMock::getStats();
+        check(scene.passes == 2 && scene.eyes[0] == 0 && scene.eyes[1] == 1, mode, "one scene pass per eye, left first");
+        check(vr.getStereoStats().batchFlushes == 2, mode, "one batch flush per eye");
+        check(mock.drawCalls == 2 && mock.draws == 2, mode, "one draw call per eye");
+        check(mock.vertices == 2 * CUBE_VERTICES, mode, "the scene is streamed once per eye");
+        for (int eye = 0; eye < 2 && eye < mock.draws; eye++) {
+            const RaylibMock::Draw& draw = RaylibMock::getDraw(eye);
+            const int* viewport = views[eye].viewport;
+            check(sameViewport(draw.viewport, viewport[0], viewport[1], viewport[2], viewport[3]), mode,
+                  eye == 0 ? "left eye draws into the left viewport" : "right eye draws into the right viewport");
+            check(sameMatrix(draw.projection, projection[eye]), mode,
+                  eye == 0 ? "left viewport uses the left projection" : "right viewport uses the right projection");
+            check(sameMatrix(draw.modelview, view[eye]), mode,
+                  eye == 0 ? "left viewport uses the left view" : "right viewport uses the right view");
+        }
+    }
+
+    void testSinglePass(VRHandler& vr) {
+        const char* mode = "SinglePass";
+        WebXRView views[2];
+        makeViews(views, true);
+        Matrix projection[2], view[2];
+        VRMath::convertViews(views, projection, view);
+
+        vr.setStereoMode(VRHandler::StereoMode::SinglePass);
+        Scene scene = render(vr, views);
+        report(mode, vr);
+
+        const RaylibMock::Stats& mock = RaylibMock::getStats();
+        check(scene.passes == 1 && scene.eyes[0] == -1, mode, "one scene pass covering both eyes");
+        check(vr.getStereoStats().batchFlushes == 1, mode, "one batch flush");
+        check(mock.drawCalls == 2 && mock.draws == 2, mode, "the batch is drawn once per eye half");
+        check(mock.vertices == CUBE_VERTICES, mode, "the scene is streamed once");
+        for (int eye = 0; eye < 2 && eye < mock.draws; eye++) {
+            const RaylibMock::Draw& draw = RaylibMock::getDraw(eye);
+            check(sameViewport(draw.viewport, eye * EYE_WIDTH, 0, EYE_WIDTH, EYE_HEIGHT), mode,
+                  eye == 0 ? "first half is the left half" : "second half is the right half");
+            check(sameMatrix(draw.projection, projection[eye]), mode,
+                  eye == 0 ? "left half uses the left projection" : "right half uses the right projection");
+            check(sameMatrix(draw.modelview, view[eye]), mode,
+                  eye == 0 ? "left half uses the left view" : "right half uses the right view");
+        }
+        check(!rlIsStereoRenderEnabled(), mode, "stereo rendering is turned off again");
+    }
+
+    void testSinglePassFallback(VRHandler& vr) {
+        const char* mode = "SinglePass, uneven";
+        WebXRView views[2];
+        makeViews(views, false);
+
+        vr.setStereoMode(VRHandler::StereoMode::SinglePass);
+        Scene scene = render(vr, views);
+        report(mode, vr);
+
+        check(scene.passes == 2 && scene.eyes[0] == 0 && scene.eyes[1] == 1, mode, "unequal halves fall back to one pass per eye");
+        check(RaylibMock::getStats().drawCalls == 2, mode, "one draw call per eye");
+    }
+
+    struct SessionResult {
+        int frames;
+        int scenePasses;      // on the last frame
+        bool runtime;
+        bool software;
+    };
+
+    // A short stub session rendering SinglePass, the layer claiming fixedFoveation or not
+    SessionResult runSession(VRHandler& vr, bool layerFoveation) {
+        SessionResult result = {};
+        setenv("WEBXR_STUB_FIXED_FOVEATION", layerFoveation ? "1" : "0", 1);
+        vr.setStereoMode(VRHandler::StereoMode::SinglePass);
+        vr.setFrameHandler([&vr, &result](int time, float modelMatrix[16], WebXRView* stubViews, void* handData) {
+            WebXRView views[2];
+            makeViews(views, true);
+            render(vr, views);
+            result.frames++;
+            result.scenePasses = vr.getStereoStats().scenePasses;
+            result.runtime = vr.isRuntimeFoveation();
+            result.software = vr.isSoftwareFoveation();
+        });
+        webxr_stub_run(3);
+        vr.setFrameHandler(nullptr);
+        unsetenv("WEBXR_STUB_FIXED_FOVEATION");
+        return result;
+    }
+
+    void testFoveation(VRHandler& vr) {
+        // Session start and input lines would break up the table
+        VRLog::setSink([](const char* text) {});
+        // Before any session, as main() does
+        vr.setFoveation(0.5f);
+        vr.setSoftwareFoveation(true);
+
+        const char* mode = "runtime foveation";
+        SessionResult result = runSession(vr, true);
+        printf("%-22s %8d\n", mode, result.scenePasses);
+        check(result.frames == 3, mode, "the stub session ran");
+        check(result.runtime && !result.software, mode, "the layer's fixedFoveation is seen from the first frame");
+        check(result.scenePasses == 1, mode, "software passes are skipped and SinglePass kept");
+        check(!vr.isRuntimeFoveation(), mode, "runtime foveation is forgotten when the session ends");
+
+        mode = "software foveation";
+        result = runSession(vr, false);
+        printf("%-22s %8d\n", mode, result.scenePasses);
+        check(!result.runtime && result.software, mode, "a layer without fixedFoveation takes the software path");
+        check(result.scenePasses == 4, mode, "periphery and center passes per eye");
+
+        mode = "foveation, no opt-in";
+        vr.setSoftwareFoveation(false);
+        result = runSession(vr, false);
+        printf("%-22s %8d\n", mode, result.scenePasses);
+        check(!result.runtime && !result.software, mode, "software foveation stays off");
+        check(result.scenePasses == 1, mode, "SinglePass is kept");
+        vr.setFoveation(0.0f);
+    }
+}
+
+int main() {
+    VRHandler vr;
+    vr.initialize();
+
+    printf("%-22s %8s %8s %8s %10s\n", "mode", "passes", "flushes", "draws", "vertices");
+    testMultiPass(vr);
+    testSinglePass(vr);
+    testSinglePassFallback(vr);
+    testFoveation(vr);
+
+    if (failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,192 @@
+// VRMath's SIMD and scalar paths side by side, against the per-field copy and
+// raymath MatrixInvert they replaced: time per frame (both eyes) and agreement.
+//
+//   vrmath_bench [frames]    default 2000000
+//
+// VRMath.h picks its path at compile time, so this file is compiled once more
+// per path with VRMATH_BENCH_PATH naming a namespace (see the vrmath_bench
+// target in the Makefile): ScalarPath with VRMATH_NO_SIMD, SimdPath with the
+// build's own flags. Natively SimdPath is SSE; the vrmath_bench.js target builds
+// the same with em++ -msimd128, where it is wasm SIMD128, to run in node.
+//
+// Views are 1024 random rigid eye transforms with random projections. Every
+// path must match MatrixInvert within INVERSE_TOLERANCE and copy projections
+// exactly, and the SIMD path must match the scalar one within SIMD_TOLERANCE.
+// Exits 1 otherwise.
+#include "VRMath.h"
+
+#if defined(VRMATH_BENCH_PATH)
+
+namespace VRMATH_BENCH_PATH {
+#if defined(VRMATH_WASM_SIMD)
+    const char* name = "wasm SIMD128";
+#elif defined(VRMATH_SSE)
+    const char* name = "SSE";
+#else
+    const char* name = "scalar";
+#endif
+
+    void convertFrames(const WebXRView (*views)[2], int count, Matrix (*projection)[2], Matrix (*view)[2]) {
+        for (int i = 0; i < count; i++) VRMath::convertViews(views[i], projection[i], view[i]);
+    }
+
+    void rigidInverses(const Matrix* matrices, int count, Matrix* inverses) {
+        for (int i = 0; i < count; i++) inverses[i] = VRMath::rigidInverse(matrices[i]);
+    }
+}
+
+#else
+
+#include "FrameProfiler.h"
+#include "raymath.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#define DECLARE_PATH(path) \
+    namespace path { \
+        extern const char* name; \
+        void convertFrames(const WebXRView (*views)[2], int count, Matrix (*projection)[2], Matrix (*view)[2]); \
+        void rigidInverses(const Matrix* matrices, int count, Matrix* inverses); \
+    }
+
+DECLARE_PATH(ScalarPath)
+DECLARE_PATH(SimdPath)
+
+namespace {
+    const int VIEW_SETS = 1024;
+    const float INVERSE_TOLERANCE = 1e-5f;
+    const float SIMD_TOLERANCE = 1e-6f;
+
+    typedef void (*ConvertFrames)(const WebXRView (*views)[2], int count, Matrix (*projection)[2], Matrix (*view)[2]);
+
+    WebXRView views[VIEW_SETS][2];
+    Matrix viewMatrices[VIEW_SETS * 2];     // the same view transforms as raylib matrices
+
+    Matrix referenceProjection[VIEW_SETS][2], referenceView[VIEW_SETS][2];
+    Matrix scalarProjection[VIEW_SETS][2], scalarView[VIEW_SETS][2];
+    Matrix projection[VIEW_SETS][2], view[VIEW_SETS][2];
+    Matrix inverses[VIEW_SETS * 2];
+
+    unsigned seed = 1;
+
+    float randomFloat(float low, float high) {
+        seed = seed * 1664525u + 1013904223u;
+        return low + (high - low) * ((seed >> 8) * (1.0f / 16777216.0f));
+    }
+
+    // What VRHandler did before VRMath: a field-by-field transpose and a general inverse
+    Matrix copyWebXR(const float m[16]) {
+        Matrix result;
+        result.m0 = m[0];   result.m4 = m[4];   result.m8 = m[8];    result.m12 = m[12];
+        result.m1 = m[1];   result.m5 = m[5];   result.m9 = m[9];    result.m13 = m[13];
+        result.m2 = m[2];   result.m6 = m[6];   result.m10 = m[10];  result.m14 = m[14];
+        result.m3 = m[3];   result.m7 = m[7];   result.m11 = m[11];  result.m15 = m[15];
+        return result;
+    }
+
+    void referenceFrames(const WebXRView (*views)[2], int count, Matrix (*projection)[2], Matrix (*view)[2]) {
+        for (int i = 0; i < count; i++) {
+            for (int eye = 0; eye < 2; eye++) {
+                projection[i][eye] = copyWebXR(views[i][eye].projectionMatrix);
+                view[i][eye] = MatrixInvert(copyWebXR(views[i][eye].viewMatrix));
+            }
+        }
+    }
+
+    void makeViews() {
+        for (int i = 0; i < VIEW_SETS; i++) {
+            for (int eye = 0; eye < 2; eye++) {
+                Quaternion q = QuaternionNormalize({ randomFloat(-1, 1), randomFloat(-1, 1), randomFloat(-1, 1), randomFloat(-1, 1) });
+                Matrix m = QuaternionToMatrix(q);
+                m.m12 = randomFloat(-5, 5);
+                m.m13 = randomFloat(-5, 5);
+                m.m14 = randomFloat(-5, 5);
+                viewMatrices[i * 2 + eye] = m;
+
+                // WebXR matrices are column-major: the raylib fields in column order
+                Matrix columns = MatrixTranspose(m);
+                const float* c = &columns.m0;
+                for (int k = 0; k < 16; k++) {
+                    views[i][eye].viewMatrix[k] = c[k];
+                    views[i][eye].projectionMatrix[k] = randomFloat(-2, 2);
+                }
+            }
+        }
+    }
+
+    float maxDifference(const Matrix* a, const Matrix* b, int count) {
+        float result = 0.0f;
+        for (int i = 0; i < count; i++) {
+            const float* x = &a[i].m0;
+            const float* y = &b[i].m0;
+            for (int k = 0; k < 16; k++) result = std::max(result, fabsf(x[k] - y[k]));
+        }
+        return result;
+    }
+
+    // Median over five runs of ns per frame (two eyes)
+    double timeFrames(ConvertFrames convert, int frames, Matrix (*outProjection)[2], Matrix (*outView)[2]) {
+        int rounds = std::max(frames / VIEW_SETS, 1);
+        double times[5];
+        convert(views, VIEW_SETS, outProjection, outView);
+        for (int run = 0; run < 5; run++) {
+            double start = FrameProfiler::now();
+            for (int r = 0; r < rounds; r++) convert(views, VIEW_SETS, outProjection, outView);
+            times[run] = (FrameProfiler::now() - start) * 1e6 / ((double)rounds * VIEW_SETS);
+        }
+        std::sort(times, times + 5);
+        return times[2];
+    }
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::max(atoi(argv[1]), 1) : 2000000;
+    makeViews();
+
+    printf("%d frames over %d random view pairs\n", frames, VIEW_SETS);
+    printf("%-28s %10s %8s %14s %14s\n", "path", "ns/frame", "speedup", "vs MatrixInvert", "vs scalar");
+
+    double reference = timeFrames(referenceFrames, frames, referenceProjection, referenceView);
+    printf("%-28s %10.1f %8s %14s %14s\n", "copy + MatrixInvert", reference, "1.00x", "-", "-");
+
+    double scalar = timeFrames(ScalarPath::convertFrames, frames, scalarProjection, scalarView);
+    double simd = timeFrames(SimdPath::convertFrames, frames, projection, view);
+
+    const int count = VIEW_SETS * 2;
+    float scalarError = maxDifference(&scalarView[0][0], &referenceView[0][0], count);
+    float simdError = maxDifference(&view[0][0], &referenceView[0][0], count);
+    float simdScalarError = maxDifference(&view[0][0], &scalarView[0][0], count);
+    bool projectionsCopied = maxDifference(&scalarProjection[0][0], &referenceProjection[0][0], count) == 0.0f &&
+                             maxDifference(&projection[0][0], &referenceProjection[0][0], count) == 0.0f;
+
+    char name[64];
+    snprintf(name, sizeof(name), "VRMath %s", ScalarPath::name);
+    printf("%-28s %10.1f %7.2fx %14.1e %14s\n", name, scalar, reference / scalar, scalarError, "-");
+    snprintf(name, sizeof(name), "VRMath %s", SimdPath::name);
+    printf("%-28s %10.1f %7.2fx %14.1e %14.1e\n", name, simd, reference / simd, simdError, simdScalarError);
+
+    // rigidInverse on raylib matrices, as VRHandler::invertWebXRViewMatrix uses it
+    Matrix generalInverses[count];
+    for (int i = 0; i < count; i++) generalInverses[i] = MatrixInvert(viewMatrices[i]);
+    ScalarPath::rigidInverses(viewMatrices, count, inverses);
+    float scalarInverseError = maxDifference(inverses, generalInverses, count);
+    SimdPath::rigidInverses(viewMatrices, count, inverses);
+    float simdInverseError = maxDifference(inverses, generalInverses, count);
+    printf("rigidInverse vs MatrixInvert: %s %.1e, %s %.1e\n",
+           ScalarPath::name, scalarInverseError, SimdPath::name, simdInverseError);
+
+    bool pass = projectionsCopied &&
+                scalarError <= INVERSE_TOLERANCE && simdError <= INVERSE_TOLERANCE &&
+                scalarInverseError <= INVERSE_TOLERANCE && simdInverseError <= INVERSE_TOLERANCE &&
+                simdScalarError <= SIMD_TOLERANCE;
+    if (!pass) {
+        printf("FAIL: %s\n", projectionsCopied ? "view inverses outside tolerance" : "projections not copied exactly");
+        return 1;
+    }
+    printf("PASS: within %.0e of MatrixInvert, %s within %.0e of scalar\n",
+           INVERSE_TOLERANCE, SimdPath::name, SIMD_TOLERANCE);
+    return 0;
+}
+
+#endif
@@ -58,6 +58,35 @@ typedef struct WebXRInputSource {
     int hasController;  /**< 1 if this input source has controller/gamepad, 0 otherwise */
 } WebXRInputSource;
 
+/** Capacity limits of @ref WebXRInputSnapshot */
+#define WEBXR_MAX_INPUT_SOURCES 16
+#define WEBXR_MAX_GAMEPAD_BUTTONS 8
+#define WEBXR_MAX_GAMEPAD_AXES 4
+
+/** State of one input source for the current frame */
+typedef struct WebXRInputState {
+    WebXRInputSource source;
+    int hasGripPose;        /**< 1 if gripMatrix is valid this frame */
+    int hasTargetRayPose;   /**< 1 if targetRayMatrix is valid this frame */
+    float gripMatrix[16];
+    float targetRayMatrix[16];
+    int buttonCount;
+    int buttonsPressed;     /**< Bit i set if gamepad button i is pressed */
+    int buttonsTouched;     /**< Bit i set if gamepad button i is touched */
+    float buttonValues[WEBXR_MAX_GAMEPAD_BUTTONS];
+    int axisCount;
+    float axes[WEBXR_MAX_GAMEPAD_AXES];
+    int hasGripVelocity;            /**< 1 if the runtime reported XRPose velocities for the grip */
+    float gripLinearVelocity[3];    /**< Meters per second */
+    float gripAngularVelocity[3];   /**< Rotation axis scaled by radians per second */
+} WebXRInputState;
+
+/** All input sources of a frame, filled before the frame callback */
+typedef struct WebXRInputSnapshot {
+    int count;
+    WebXRInputState inputs[WEBXR_MAX_INPUT_SOURCES];
+} WebXRInputSnapshot;
+
 /** WebXR Hand Joint indices (matches the 25 joints in the WebXR Hand Input specification) */
 enum WebXRHandJoint {
     WEBXR_HAND_JOINT_WRIST = 0,
@@ -100,6 +129,17 @@ typedef struct WebXRHandData {
     WebXRHandJointPose joints[WEBXR_HAND_JOINT_COUNT];
 } WebXRHandData;
 
+/** Size in bytes of the hand data block passed to the frame callback (2 hands + 2 detection flags) */
+#define WEBXR_HAND_DATA_SIZE (2 * WEBXR_HAND_JOINT_COUNT * 32 + 8)
+
+/** Persistent per-frame data block, layout matches the frame callback parameters */
+typedef struct WebXRFrameData {
+    WebXRView views[2];
+    float modelMatrix[16];
+    WebXRHandData hands[2];   /**< Start of the hand data block */
+    int handDetected[2];      /**< Hand detection flags, directly after the joints */
+} WebXRFrameData;
+
 /**
 Callback for errors
 
@@ -161,6 +201,94 @@ Request that the webxr presentation exits VR mode
 */
 extern void webxr_request_exit();
 
+/** Timing information about the current frame, written by the library before the frame callback */
+typedef struct WebXRFrameStats {
+    float marshalTime;             /**< Milliseconds onFrame spent writing frame data before the callback */
+    float predictedDisplayDelta;   /**< Milliseconds from the frame time to XRFrame.predictedDisplayTime, 0 if not reported */
+    float frameInterval;           /**< Milliseconds since the previous frame of the session, 0 on its first frame */
+    float targetFrameRate;         /**< XRSession.frameRate, 0 if not reported */
+    float viewportScale;           /**< Scale of this frame's viewports relative to the layer's full eye viewports */
+    int glCalls;                   /**< WebGL calls made from the previous frame's start to this one's, 0 unless counting is on */
+    int glCallsSkipped;            /**< Calls over the same span that the state cache dropped as redundant */
+} WebXRFrameStats;
+
+/**
+Register persistent buffers the frame data is written into.
+
+The buffers must stay valid for as long as sessions can run. The frame callback
+receives these same pointers every frame, so no memory is allocated per frame.
+If never called, the library allocates one block on the first frame and reuses it.
+
+@param views Array of two @ref WebXRView
+@param modelMatrix 16 floats for the viewer transform
+@param handData @ref WEBXR_HAND_DATA_SIZE bytes of hand data (see @ref WebXRFrameData)
+*/
+extern void webxr_set_frame_buffers(WebXRView* views, float* modelMatrix, void* handData);
+
+/**
+Register a @ref WebXRFrameStats that is updated every frame before the frame callback.
+
+@param stats Stats to fill, must stay valid while sessions can run.
+*/
+extern void webxr_set_frame_stats_buffer(WebXRFrameStats* stats);
+
+/**
+Set the framebufferScaleFactor of the XRWebGLLayer created for the next session.
+
+@param scale Relative to the recommended framebuffer resolution (1.0)
+*/
+extern void webxr_set_framebuffer_scale_factor(float scale);
+
+/**
+Render the following frames into eye viewports scaled by `scale`.
+
+Uses XRView.requestViewportScale where the browser has it, so the change is
+cheap and applies from the next frame. Elsewhere the layer is recreated with a
+scaled framebufferScaleFactor once the request differs by 10% or more from the
+current layer, which reallocates the framebuffer. @ref WebXRFrameStats.viewportScale
+reports the scale in effect.
+
+@param scale Fraction (0, 1] of the full eye viewports
+*/
+extern void webxr_request_viewport_scale(float scale);
+
+/**
+Set XRWebGLLayer.fixedFoveation on the current layer and the ones created later.
+
+The runtime then shades the periphery of each eye at a lower rate. Has no
+effect where the layer lacks the attribute, see @ref webxr_is_fixed_foveation_supported.
+
+@param level 0 (none) to 1 (maximum foveation)
+*/
+extern void webxr_set_fixed_foveation(float level);
+
+/**
+Check if the current session's layer supports fixedFoveation.
+
+@return 1 if it does, 0 if not or without a session
+*/
+extern int webxr_is_fixed_foveation_supported();
+
+/**
+Clear the whole layer framebuffer, color and depth, before every frame callback.
+
+Both eyes are cleared by one unscissored clear, so the application does not
+need to clear each eye viewport. Without this call only depth is cleared.
+*/
+extern void webxr_set_clear_color(float r, float g, float b, float a);
+
+/**
+Count the WebGL calls that reach the context, reported in @ref WebXRFrameStats.glCalls.
+
+The library keeps a cache of viewport, scissor, clear color, capability and
+framebuffer state on the context and drops calls that would not change it.
+Counting wraps every other context method as well, so leave it off outside
+measurements.
+
+@param enabled 1 to count, 0 to stop
+*/
+extern void webxr_set_gl_call_counting(int enabled);
+
 /**
 Set projection matrix parameters for the webxr session
 
@@ -203,6 +331,62 @@ Get input sources.
 extern void webxr_get_input_sources(
         WebXRInputSource* outArray, int max, int* outCount);
 
+/**
+Register a snapshot that is filled with all input sources, their grip and
+target ray poses and gamepad state once per frame, before the frame callback.
+
+@param snapshot Snapshot to fill, must stay valid while sessions can run.
+*/
+extern void webxr_set_input_snapshot_buffer(WebXRInputSnapshot* snapshot);
+
+/** Kind of a queued @ref WebXRInputEvent */
+typedef enum WebXRInputEventType {
+    WEBXR_INPUT_EVENT_SELECT = 0,
+    WEBXR_INPUT_EVENT_SELECT_START = 1,
+    WEBXR_INPUT_EVENT_SELECT_END = 2,
+} WebXRInputEventType;
+
+/** Capacity of @ref WebXRInputEventQueue, a power of two */
+#define WEBXR_INPUT_EVENT_CAPACITY 64
+
+/** A select event with the input source's poses at the time it was dispatched */
+typedef struct WebXRInputEvent {
+    double timestamp;             /**< Event.timeStamp in ms, the clock of the frame callback's time */
+    int type;                     /**< @ref WebXRInputEventType */
+    WebXRInputSource source;
+    int hasGripPose;              /**< 1 if gripMatrix is valid */
+    int hasTargetRayPose;         /**< 1 if targetRayMatrix is valid */
+    float gripMatrix[16];
+    float targetRayMatrix[16];
+} WebXRInputEvent;
+
+/**
+Single-producer, single-consumer ring of input events.
+
+The library writes events[head % capacity] and then advances head; the
+consumer reads up to head and then advances tail. Both counters only grow
+(wrapping at 2^32), so head - tail is the number of queued events. An event
+arriving while the ring is full is dropped and counted in `dropped`.
+*/
+typedef struct WebXRInputEventQueue {
+    unsigned int head;            /**< Events written so far, advanced by the library */
+    unsigned int tail;            /**< Events consumed so far, advanced by the application */
+    unsigned int dropped;         /**< Events lost to a full ring */
+    unsigned int reserved;
+    WebXRInputEvent events[WEBXR_INPUT_EVENT_CAPACITY];
+} WebXRInputEventQueue;
+
+/**
+Register a queue that select, selectstart and selectend events are written into.
+
+Nothing calls into the application when the events are dispatched; it drains the
+queue itself, typically at the start of the frame callback. Callbacks set with
+@ref webxr_set_select_callback and friends still fire in addition.
+
+@param queue Queue to fill, zero-initialized, must stay valid while sessions can run.
+*/
+extern void webxr_set_input_event_queue(WebXRInputEventQueue* queue);
+
 /**
 Get input pose. Can only be called during the frame callback.
 
@@ -230,6 +414,7 @@ extern int webxr_get_hand_joint_pose(int handedness, int jointIndex, float* outP
 
 /**
 Extract hand data from the frame callback hand data parameter.
+Copies the whole hand; prefer @ref webxr_get_hand_view inside the frame callback.
 
 @param handData Hand data pointer from frame callback
 @param handedness 0 for left hand, 1 for right hand
@@ -254,6 +439,56 @@ static inline int webxr_get_hand_data(void* handData, int handedness, WebXRHandD
     return 1;
 }
 
+/**
+Zero-copy access to one hand in the frame callback hand data block.
+The pointer stays valid until the next frame overwrites the block.
+
+@param handData Hand data pointer from frame callback
+@param handedness 0 for left hand, 1 for right hand
+@return Pointer to the hand inside handData, or NULL if the hand is not detected
+*/
+static inline const WebXRHandData* webxr_get_hand_view(const void* handData, int handedness) {
+    if (!handData || handedness < 0 || handedness > 1) return 0;
+
+    const WebXRHandData* hands = (const WebXRHandData*)handData;
+    const int* flags = (const int*)(hands + 2);
+    return flags[handedness] ? &hands[handedness] : 0;
+}
+
+/** Joints of both hands as structure of arrays, index = hand * WEBXR_HAND_JOINT_COUNT + joint */
+typedef struct WebXRHandJointsSoA {
+    float x[2 * WEBXR_HAND_JOINT_COUNT];
+    float y[2 * WEBXR_HAND_JOINT_COUNT];
+    float z[2 * WEBXR_HAND_JOINT_COUNT];
+    float radius[2 * WEBXR_HAND_JOINT_COUNT];   /**< 0 for joints of undetected hands */
+    int detected[2];
+} WebXRHandJointsSoA;
+
+/**
+Gather the joint positions and radii of both hands into SIMD-friendly arrays.
+
+@param handData Hand data pointer from frame callback
+@param out Receives the joints; hands that are not detected are zeroed
+*/
+static inline void webxr_get_hand_joints_soa(const void* handData, WebXRHandJointsSoA* out) {
+    for (int hand = 0; hand < 2; hand++) {
+        const WebXRHandData* view = webxr_get_hand_view(handData, hand);
+        out->detected[hand] = view != 0;
+
+        for (int joint = 0; joint < WEBXR_HAND_JOINT_COUNT; joint++) {
+            int i = hand * WEBXR_HAND_JOINT_COUNT + joint;
+            if (view) {
+                out->x[i] = view->joints[joint].position[0];
+                out->y[i] = view->joints[joint].position[1];
+                out->z[i] = view->joints[joint].position[2];
+                out->radius[i] = view->joints[joint].radius;
+            } else {
+                out->x[i] = out->y[i] = out->z[i] = out->radius[i] = 0.0f;
+            }
+        }
+    }
+}
+
 /**
 Check if the current session is an AR session.
 
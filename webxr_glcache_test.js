@@ -0,0 +1,333 @@
+// GL calls per XR frame that reach the context against those _install_gl_cache
+// skips, in Node against a fake WebGLRenderingContext.
+//
+//   node webxr_glcache_test.js [frames]    default 1000 frames
+//
+// Starts a session through webxr_init with a fake navigator.xr, turns on
+// webxr_set_gl_call_counting and runs onFrame. The frame callback stands in for
+// VRHandler and raylib's batch flush: per eye a viewport, depth test, program,
+// matrices, buffer upload and draw, in MultiPass or in SinglePass (one batch,
+// a viewport per eye and the full viewport restored after, as rlgl's stereo
+// flush does). Every call the library or the callback issues is counted in
+// front of the cache, and the fake context counts what reaches it and keeps the
+// state it was left in.
+//
+// Exits 1 if the context's state differs from the state every issued call
+// would have set (a skipped call was not redundant), or if the glCalls and
+// glSkipped the library writes to WebXRFrameStats disagree with the fake
+// context's counts. Also checks the cases the cache must not skip: a WebGL2
+// draw/read framebuffer binding and a restored context.
+'use strict';
+
+const fs = require('fs');
+const path = require('path');
+
+const FRAMES = Math.max(parseInt(process.argv[2] || '1000', 10), 2);
+
+// Emscripten runtime pieces the library uses
+const heap = new ArrayBuffer(1 << 20);
+global.HEAP8 = new Int8Array(heap);
+global.HEAPU8 = new Uint8Array(heap);
+global.HEAP16 = new Int16Array(heap);
+global.HEAP32 = new Int32Array(heap);
+global.HEAPF32 = new Float32Array(heap);
+global.HEAPF64 = new Float64Array(heap);
+
+let heapTop = 1024;
+function malloc(size) {
+    const ptr = heapTop;
+    heapTop = (heapTop + size + 15) & ~15;
+    return ptr;
+}
+
+global._free = function() {};
+global.window = {};
+
+const GL = {
+    FRAMEBUFFER: 0x8D40, DRAW_FRAMEBUFFER: 0x8CA9, READ_FRAMEBUFFER: 0x8CA8,
+    SCISSOR_TEST: 0x0C11, DEPTH_TEST: 0x0B71,
+    COLOR_BUFFER_BIT: 0x4000, DEPTH_BUFFER_BIT: 0x0100, ARRAY_BUFFER: 0x8892
+};
+
+// The state the cached calls set, as a context holds it
+function makeState() {
+    return {
+        viewport: [0, 0, 0, 0],
+        scissor: [0, 0, 0, 0],
+        clearColor: [0, 0, 0, 0],
+        caps: new Map(),
+        framebuffer: null
+    };
+}
+
+function applyCall(state, name, args) {
+    switch (name) {
+        case 'viewport': state.viewport = Array.from(args); break;
+        case 'scissor': state.scissor = Array.from(args); break;
+        case 'clearColor': state.clearColor = Array.from(args).map(Math.fround); break;
+        case 'enable': state.caps.set(args[0], true); break;
+        case 'disable': state.caps.set(args[0], false); break;
+        case 'bindFramebuffer': state.framebuffer = args[1]; break;
+    }
+}
+
+function sameState(a, b) {
+    if (a.viewport.join() !== b.viewport.join() || a.scissor.join() !== b.scissor.join() ||
+        a.clearColor.join() !== b.clearColor.join() || a.framebuffer !== b.framebuffer) return false;
+    for (const cap of new Set([...a.caps.keys(), ...b.caps.keys()])) {
+        if ((a.caps.get(cap) || false) !== (b.caps.get(cap) || false)) return false;
+    }
+    return true;
+}
+
+// Methods on the prototype, like a real WebGLRenderingContext, so
+// _count_gl_calls finds them the way it does in a browser
+class FakeWebGLRenderingContext {
+    constructor() {
+        Object.assign(this, GL);
+        this.state = makeState();
+        this.reached = 0;
+        this.listeners = {};
+        const listeners = this.listeners;
+        this.canvas = {
+            addEventListener(type, listener) { (listeners[type] = listeners[type] || []).push(listener); }
+        };
+    }
+    makeXRCompatible() { return Promise.resolve(); }
+}
+['viewport', 'scissor', 'clearColor', 'enable', 'disable', 'bindFramebuffer', 'clear', 'useProgram',
+ 'uniformMatrix4fv', 'bindBuffer', 'bufferSubData', 'bindTexture', 'drawElements'].forEach(function(name) {
+    FakeWebGLRenderingContext.prototype[name] = function() {
+        this.reached++;
+        applyCall(this.state, name, arguments);
+    };
+});
+
+// Counts every call made on the context object, in front of the cache
+function countIssued(gl) {
+    const issued = { count: 0, state: makeState() };
+    Object.getOwnPropertyNames(FakeWebGLRenderingContext.prototype).forEach(function(name) {
+        if (name === 'constructor' || name === 'makeXRCompatible') return;
+        const inner = gl[name];
+        gl[name] = function() {
+            issued.count++;
+            applyCall(issued.state, name, arguments);
+            return inner.apply(gl, arguments);
+        };
+    });
+    return issued;
+}
+
+global.XRWebGLLayer = class {
+    constructor(session, context, options) {
+        this.framebuffer = { layer: true };
+    }
+    getViewport(view) {
+        return view.viewport;
+    }
+};
+
+function makeTransform() {
+    const matrix = new Float32Array(16);
+    matrix[0] = matrix[5] = matrix[10] = matrix[15] = 1;
+    return { matrix, position: { x: 0, y: 0, z: 0, w: 1 }, orientation: { x: 0, y: 0, z: 0, w: 1 } };
+}
+
+function makeSession() {
+    const views = ['left', 'right'].map(function(eye, i) {
+        return {
+            eye,
+            transform: makeTransform(),
+            projectionMatrix: new Float32Array(16),
+            viewport: { x: i * 1832, y: 0, width: 1832, height: 1920 }
+        };
+    });
+    const viewerPose = { views, transform: makeTransform() };
+    const session = {
+        inputSources: [],
+        renderState: { baseLayer: null },
+        frameRate: 90,
+        raf: null,
+        requestAnimationFrame(callback) { this.raf = callback; return 1; },
+        cancelAnimationFrame() {},
+        updateRenderState(state) { Object.assign(this.renderState, state); },
+        requestReferenceSpace() { return Promise.resolve({}); },
+        addEventListener() {},
+        end() {}
+    };
+    const frame = {
+        session,
+        predictedDisplayTime: 0,
+        getViewerPose() { return viewerPose; },
+        getPose() { return null; }
+    };
+    return { session, frame, views };
+}
+
+function loadLibrary(source) {
+    const LibraryManager = { library: {} };
+    const mergeInto = function(target, source) { Object.assign(target, source); };
+    new Function('LibraryManager', 'mergeInto', 'autoAddDeps', source)(LibraryManager, mergeInto, function() {});
+    return LibraryManager.library;
+}
+
+function flushPromises() {
+    return new Promise(function(resolve) { setImmediate(resolve); });
+}
+
+// What VRHandler::renderStereo and rlDrawRenderBatch issue for one frame
+function drawFrame(gl, views, singlePass) {
+    const program = 1, vbo = 2, texture = 3;
+    if (singlePass) {
+        gl.enable(gl.DEPTH_TEST);
+        gl.useProgram(program);
+        gl.bindBuffer(gl.ARRAY_BUFFER, vbo);
+        gl.bufferSubData(gl.ARRAY_BUFFER, 0, null);
+        gl.bindTexture(0, texture);
+        for (const view of views) {
+            const v = view.viewport;
+            gl.viewport(v.x, v.y, v.width, v.height);
+            gl.uniformMatrix4fv(0, false, view.projectionMatrix);
+            gl.drawElements(0, 0, 0, 0);
+        }
+        gl.viewport(0, 0, views[1].viewport.x + views[1].viewport.width, views[1].viewport.height);
+        return;
+    }
+    for (const view of views) {
+        const v = view.viewport;
+        gl.viewport(v.x, v.y, v.width, v.height);
+        gl.enable(gl.DEPTH_TEST);
+        gl.useProgram(program);
+        gl.uniformMatrix4fv(0, false, view.projectionMatrix);
+        gl.bindBuffer(gl.ARRAY_BUFFER, vbo);
+        gl.bufferSubData(gl.ARRAY_BUFFER, 0, null);
+        gl.bindTexture(0, texture);
+        gl.drawElements(0, 0, 0, 0);
+    }
+}
+
+const failures = [];
+
+async function run(name, source, singlePass) {
+    const library = loadLibrary(source);
+    global.WebXR = library.$WebXR;
+    const gl = new FakeWebGLRenderingContext();
+    global.Module = { _malloc: malloc, _free: global._free, ctx: gl };
+
+    const fake = makeSession();
+    const xr = {
+        isSessionSupported() { return Promise.resolve(true); },
+        requestSession() { return Promise.resolve(fake.session); }
+    };
+    Object.defineProperty(global, 'navigator', { value: { xr }, configurable: true, writable: true });
+
+    const stats = malloc(8 * 4);
+    const frames = [];
+    let last = null;
+    let issued = null;
+    global.dynCall = function(signature, callback, args) {
+        if (signature !== 'viiiii') return;
+        // The library wrote this frame's stats just before the callback
+        const now = { issued: issued.count, reached: gl.reached };
+        if (last) {
+            frames.push({
+                issued: now.issued - last.issued,
+                reached: now.reached - last.reached,
+                reportedCalls: HEAP32[(stats >> 2) + 5],
+                reportedSkipped: HEAP32[(stats >> 2) + 6]
+            });
+        }
+        last = now;
+        drawFrame(gl, fake.views, singlePass);
+    };
+
+    library.webxr_init(1, 1, 0, 0, 0, 0);
+    library.webxr_set_frame_stats_buffer(stats);
+    library.webxr_set_clear_color(0.4, 0.7, 1.0, 1.0);
+    await flushPromises();
+    Module.webxr_request_session_func();
+    for (let i = 0; i < 4; i++) await flushPromises();
+    if (!fake.session.raf) throw new Error('session did not reach its first frame');
+
+    library.webxr_set_gl_call_counting(1);
+    issued = countIssued(gl);
+    let stateMismatch = 0;
+    for (let i = 0; i <= FRAMES; i++) {
+        fake.session.raf(i * 11.1, fake.frame);
+        if (!sameState(gl.state, issued.state)) stateMismatch++;
+    }
+    library.webxr_set_gl_call_counting(0);
+
+    let issuedTotal = 0, reachedTotal = 0, countMismatch = 0;
+    for (const f of frames) {
+        issuedTotal += f.issued;
+        reachedTotal += f.reached;
+        if (f.reportedCalls !== f.reached || f.reportedSkipped !== f.issued - f.reached) countMismatch++;
+    }
+    const n = frames.length;
+    console.log(name.padEnd(12) + (issuedTotal / n).toFixed(2).padStart(10) + (reachedTotal / n).toFixed(2).padStart(10) +
+                ((issuedTotal - reachedTotal) / n).toFixed(2).padStart(10) +
+                frames[n - 1].reportedCalls.toString().padStart(10) + frames[n - 1].reportedSkipped.toString().padStart(10));
+
+    if (stateMismatch) failures.push(name + ': context state differs from the issued calls on ' + stateMismatch + ' frames');
+    if (countMismatch) failures.push(name + ': WebXRFrameStats glCalls/glSkipped disagree on ' + countMismatch + ' frames');
+    if (reachedTotal >= issuedTotal) failures.push(name + ': the cache skipped nothing');
+}
+
+// Calls that look redundant to a cache tracking only gl.FRAMEBUFFER, or that
+// follow a context restore, must reach the context
+function checkInvalidation(source) {
+    const library = loadLibrary(source);
+    const gl = new FakeWebGLRenderingContext();
+    library.$WebXR._install_gl_cache(gl);
+    const issued = countIssued(gl);
+    const layer = {}, offscreen = {};
+
+    function expect(what, call, reaches) {
+        const before = gl.reached;
+        call();
+        if ((gl.reached > before) !== reaches) {
+            failures.push(what + (reaches ? ' was skipped' : ' reached the context'));
+        }
+    }
+    expect('first bindFramebuffer', () => gl.bindFramebuffer(gl.FRAMEBUFFER, layer), true);
+    expect('repeated bindFramebuffer', () => gl.bindFramebuffer(gl.FRAMEBUFFER, layer), false);
+    expect('DRAW_FRAMEBUFFER binding', () => gl.bindFramebuffer(gl.DRAW_FRAMEBUFFER, offscreen), true);
+    expect('FRAMEBUFFER binding after a DRAW_FRAMEBUFFER one', () => gl.bindFramebuffer(gl.FRAMEBUFFER, layer), true);
+    expect('first clearColor', () => gl.clearColor(0.4, 0.7, 1.0, 1.0), true);
+    expect('clearColor equal after float rounding', () => gl.clearColor(Math.fround(0.4), Math.fround(0.7), 1.0, 1.0), false);
+    expect('first viewport', () => gl.viewport(0, 0, 1832, 1920), true);
+    expect('repeated viewport', () => gl.viewport(0, 0, 1832, 1920), false);
+    expect('first enable', () => gl.enable(gl.SCISSOR_TEST), true);
+    expect('repeated enable', () => gl.enable(gl.SCISSOR_TEST), false);
+
+    (gl.listeners.webglcontextrestored || []).forEach(function(listener) { listener(); });
+    expect('viewport after a context restore', () => gl.viewport(0, 0, 1832, 1920), true);
+    expect('enable after a context restore', () => gl.enable(gl.SCISSOR_TEST), true);
+    expect('clearColor after a context restore', () => gl.clearColor(0.4, 0.7, 1.0, 1.0), true);
+
+    // The fake's state is not reset by the restore, so it still has to match
+    if (!sameState(gl.state, issued.state)) failures.push('invalidation checks: context state differs from the issued calls');
+}
+
+async function main() {
+    const source = fs.readFileSync(path.join(__dirname, 'library_webxr.js'), 'utf8');
+
+    console.log(FRAMES + ' frames, 2 views; GL calls per frame, then the last frame\'s WebXRFrameStats');
+    console.log('mode'.padEnd(12) + 'issued'.padStart(10) + 'reached'.padStart(10) + 'skipped'.padStart(10) +
+                'glCalls'.padStart(10) + 'glSkipped'.padStart(10));
+    await run('MultiPass', source, false);
+    await run('SinglePass', source, true);
+    checkInvalidation(source);
+
+    if (failures.length) {
+        failures.forEach(function(failure) { console.log('FAIL: ' + failure); });
+        process.exit(1);
+    }
+    console.log('PASS: skipped calls were redundant and the frame stats match the context');
+}
+
+main().catch(function(e) {
+    console.error(e);
+    process.exit(1);
+});
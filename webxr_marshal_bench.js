@@ -0,0 +1,294 @@
+// Cost of the JS side of one WebXR frame, in Node against a fake XRFrame.
+//
+//   node webxr_marshal_bench.js [frames] [before.js]    default 20000 frames
+//
+// Loads library_webxr.js the way emcc does (mergeInto into LibraryManager),
+// starts a session through webxr_init with a fake navigator.xr, and times
+// onFrame: both views, the model matrix and both tracked hands written into
+// the heap, the layer bind and clear, and the frame callback (a no-op here).
+// The session has no input snapshot or frame stats buffer registered, so the
+// work matches the library before typed-array marshalling. That version,
+// before.js, defaults to library_webxr.js of the repository's first commit:
+// per-float setValue, per-joint getJointPose and a malloc/free pair per frame
+// (a bump allocator here, so cheaper than dlmalloc in a real build).
+//
+// The fake getJointPose allocates its result objects like a browser does, but
+// a browser also crosses into native code once per joint, which costs nothing
+// here. Compare the fillPoses row with that in mind; it also converts every
+// joint matrix back to a quaternion in JS.
+'use strict';
+
+const fs = require('fs');
+const path = require('path');
+const { execSync } = require('child_process');
+
+const FRAMES = Math.max(parseInt(process.argv[2] || '20000', 10), 1);
+const RUNS = 5;
+
+// Emscripten runtime pieces the library uses
+const heap = new ArrayBuffer(1 << 20);
+global.HEAP8 = new Int8Array(heap);
+global.HEAPU8 = new Uint8Array(heap);
+global.HEAP16 = new Int16Array(heap);
+global.HEAP32 = new Int32Array(heap);
+global.HEAPF32 = new Float32Array(heap);
+global.HEAPF64 = new Float64Array(heap);
+
+let heapTop = 1024;
+function malloc(size) {
+    if (heapTop + size > heap.byteLength) heapTop = 1024;
+    const ptr = heapTop;
+    heapTop = (heapTop + size + 15) & ~15;
+    return ptr;
+}
+
+global.setValue = function(ptr, value, type) {
+    switch (type) {
+        case 'i8': HEAP8[ptr] = value; break;
+        case 'i16': HEAP16[ptr >> 1] = value; break;
+        case 'i32': HEAP32[ptr >> 2] = value; break;
+        case 'float': HEAPF32[ptr >> 2] = value; break;
+        case 'double': HEAPF64[ptr >> 3] = value; break;
+        default: throw new Error('invalid type for setValue: ' + type);
+    }
+};
+global.getValue = function(ptr, type) {
+    return type === 'float' ? HEAPF32[ptr >> 2] : HEAP32[ptr >> 2];
+};
+global._free = function() {};
+global.dynCall = function() {};
+global.window = {};
+
+// Fake WebGL context: only what onFrame and _install_gl_cache touch
+function makeContext() {
+    return {
+        FRAMEBUFFER: 0x8D40, SCISSOR_TEST: 0x0C11, DEPTH_TEST: 0x0B71,
+        COLOR_BUFFER_BIT: 0x4000, DEPTH_BUFFER_BIT: 0x0100,
+        bindFramebuffer() {}, enable() {}, disable() {}, viewport() {}, scissor() {},
+        clearColor() {}, clear() {},
+        makeXRCompatible() { return Promise.resolve(); }
+    };
+}
+
+global.XRWebGLLayer = class {
+    constructor(session, context, options) {
+        this.framebuffer = {};
+    }
+    getViewport(view) {
+        return view.viewport;
+    }
+};
+
+// Fake session and frame with two tracked hands
+const JOINTS = 25;
+
+function makeTransform(matrix) {
+    matrix = matrix || new Float32Array(16);
+    matrix[0] = matrix[5] = matrix[10] = matrix[15] = 1;
+    return { matrix, position: { x: 0, y: 0, z: 0, w: 1 }, orientation: { x: 0, y: 0, z: 0, w: 1 } };
+}
+
+// Joint matrices and radii are kept contiguous, so the fake fillPoses and
+// fillJointRadii are one copy each, like the browser's native implementation
+function makeHand(side) {
+    const spaces = new Map();
+    const matrices = new Float32Array(JOINTS * 16);
+    const radii = new Float32Array(JOINTS).fill(0.01);
+    const joints = [];
+    for (let i = 0; i < JOINTS; i++) {
+        joints.push({ transform: makeTransform(matrices.subarray(i * 16, i * 16 + 16)), radius: 0.01 });
+    }
+    const hand = {
+        joints,
+        matrices,
+        radii,
+        side,
+        get(name) {
+            if (!spaces.has(name)) spaces.set(name, { hand, joint: joints[spaces.size] });
+            return spaces.get(name);
+        }
+    };
+    return hand;
+}
+
+function makeSession(withFillPoses) {
+    const hands = [makeHand(-1), makeHand(1)];
+    const views = ['left', 'right'].map(function(eye, i) {
+        return {
+            eye,
+            transform: makeTransform(),
+            projectionMatrix: new Float32Array(16),
+            viewport: { x: i * 1832, y: 0, width: 1832, height: 1920 }
+        };
+    });
+    const viewerPose = { views, transform: makeTransform() };
+
+    const session = {
+        inputSources: [
+            { handedness: 'left', hand: hands[0], targetRayMode: 'tracked-pointer', profiles: [] },
+            { handedness: 'right', hand: hands[1], targetRayMode: 'tracked-pointer', profiles: [] }
+        ],
+        renderState: { baseLayer: null },
+        frameRate: 90,
+        raf: null,
+        requestAnimationFrame(callback) { this.raf = callback; return 1; },
+        cancelAnimationFrame() {},
+        updateRenderState(state) { Object.assign(this.renderState, state); },
+        requestReferenceSpace() { return Promise.resolve({}); },
+        addEventListener() {},
+        end() {}
+    };
+
+    const frame = {
+        session,
+        predictedDisplayTime: 0,
+        getViewerPose() { return viewerPose; },
+        getPose() { return null; },
+        // A browser returns new XRJointPose/XRRigidTransform/DOMPoint objects on every call
+        getJointPose(space) {
+            const transform = space.joint.transform;
+            const p = transform.position, o = transform.orientation;
+            return {
+                transform: {
+                    position: { x: p.x, y: p.y, z: p.z, w: 1 },
+                    orientation: { x: o.x, y: o.y, z: o.z, w: o.w }
+                },
+                radius: space.joint.radius
+            };
+        }
+    };
+    if (withFillPoses) {
+        // The library passes a hand's 25 joint spaces in order
+        frame.fillPoses = function(spaces, baseSpace, transforms) {
+            transforms.set(spaces[0].hand.matrices);
+            return true;
+        };
+        frame.fillJointRadii = function(spaces, radii) {
+            radii.set(spaces[0].hand.radii);
+            return true;
+        };
+    }
+
+    // Moves every pose a little, so each frame writes new values
+    function animate(t) {
+        for (const view of views) {
+            view.transform.matrix[12] = view.transform.position.x = 0.03 * Math.sin(t);
+        }
+        viewerPose.transform.matrix[13] = 1.6 + 0.01 * Math.cos(t);
+        for (const hand of hands) {
+            for (let i = 0; i < JOINTS; i++) {
+                const transform = hand.joints[i].transform;
+                transform.position.x = transform.matrix[12] = hand.side * 0.2 + 0.01 * i + 0.02 * Math.sin(t);
+                transform.position.y = transform.matrix[13] = 1.2;
+            }
+        }
+    }
+
+    return { session, frame, animate };
+}
+
+function loadLibrary(source) {
+    const LibraryManager = { library: {} };
+    const mergeInto = function(target, source) { Object.assign(target, source); };
+    new Function('LibraryManager', 'mergeInto', 'autoAddDeps', source)(LibraryManager, mergeInto, function() {});
+    return LibraryManager.library;
+}
+
+function flushPromises() {
+    return new Promise(function(resolve) { setImmediate(resolve); });
+}
+
+// Starts a session on the library and returns its onFrame with the fake frame
+async function startSession(library, withFillPoses) {
+    global.WebXR = library.$WebXR;
+    global.Module = { _malloc: malloc, _free: global._free, ctx: makeContext() };
+
+    const fake = makeSession(withFillPoses);
+    const xr = {
+        isSessionSupported() { return Promise.resolve(true); },
+        requestSession() { return Promise.resolve(fake.session); }
+    };
+    Object.defineProperty(global, 'navigator', { value: { xr }, configurable: true, writable: true });
+
+    library.webxr_init(1, 1, 0, 0, 0, 0);
+    await flushPromises();
+    // The C++ side registers a persistent frame block; the first-commit library has no such call
+    if (library.webxr_set_frame_buffers) {
+        const block = malloc(2 * (16 + 16 + 4 + 7) * 4 + 16 * 4 + 2 * JOINTS * 32 + 8);
+        const views = block, model = block + 2 * (16 + 16 + 4 + 7) * 4, hands = model + 16 * 4;
+        library.webxr_set_frame_buffers(views, model, hands);
+    }
+    Module.webxr_request_session_func();
+    for (let i = 0; i < 4; i++) await flushPromises();
+    if (!fake.session.raf) throw new Error('session did not reach its first frame');
+    return { onFrame: fake.session.raf, frame: fake.frame, animate: fake.animate };
+}
+
+async function measure(name, source, withFillPoses) {
+    const library = loadLibrary(source);
+    const run = await startSession(library, withFillPoses);
+    const times = [];
+
+    for (let r = 0; r <= RUNS; r++) {
+        const start = process.hrtime.bigint();
+        for (let i = 0; i < FRAMES; i++) {
+            run.animate(i * 0.011);
+            run.onFrame(i * 11.1, run.frame);
+        }
+        const ns = Number(process.hrtime.bigint() - start) / FRAMES;
+        if (r > 0) times.push(ns);   // run 0 warms up the JIT
+    }
+    times.sort(function(a, b) { return a - b; });
+    console.log(name.padEnd(40) + times[RUNS >> 1].toFixed(0).padStart(12));
+
+    const hands = WebXR._frameHandData;
+    handsWritten[name] = hands ? HEAPF32.slice(hands >> 2, (hands >> 2) + 2 * JOINTS * 8) : null;
+    return times[RUNS >> 1];
+}
+
+// Hand blocks after each library's last frame, to check the paths agree
+const handsWritten = {};
+
+function beforeSource() {
+    if (process.argv[3]) return fs.readFileSync(process.argv[3], 'utf8');
+    try {
+        const options = { cwd: __dirname, encoding: 'utf8', stdio: ['ignore', 'pipe', 'ignore'] };
+        const root = execSync('git rev-list --max-parents=0 HEAD', options).trim().split('\n')[0];
+        return execSync('git show ' + root + ':library_webxr.js', options);
+    } catch (e) {
+        return null;
+    }
+}
+
+async function main() {
+    const current = fs.readFileSync(path.join(__dirname, 'library_webxr.js'), 'utf8');
+    const before = beforeSource();
+
+    console.log(FRAMES + ' frames, 2 views, 2 hands of ' + JOINTS + ' joints, median of ' + RUNS + ' runs');
+    console.log('library'.padEnd(40) + 'ns/frame'.padStart(12));
+    let baseline = null;
+    if (before) {
+        baseline = await measure('before (setValue, getJointPose)', before, false);
+    } else {
+        console.log('before: no git history, pass a library_webxr.js as the second argument');
+    }
+    const perJoint = await measure('now, getJointPose fallback', current, false);
+    const filled = await measure('now, fillPoses/fillJointRadii', current, true);
+    const a = handsWritten['now, getJointPose fallback'], b = handsWritten['now, fillPoses/fillJointRadii'];
+    let maxError = 0;
+    for (let i = 0; i < a.length; i++) maxError = Math.max(maxError, Math.abs(a[i] - b[i]));
+    console.log('fillPoses vs getJointPose hand data: max difference ' + maxError.toExponential(1));
+    if (maxError > 1e-5) {
+        console.error('FAIL: the two hand paths write different joints');
+        process.exit(1);
+    }
+    if (baseline) {
+        console.log('speedup: ' + (baseline / perJoint).toFixed(2) + 'x per joint, ' +
+                    (baseline / filled).toFixed(2) + 'x with fillPoses');
+    }
+}
+
+main().catch(function(e) {
+    console.error(e);
+    process.exit(1);
+});
@@ -0,0 +1,366 @@
+#include <webxr.h>
+#include "webxr_replay.h"
+#include "SessionTrace.h"
+#include <rlgl.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const float SIMULATED_FRAME_RATE = 90.0f;
+const int MAX_GPU_COSTS = 8;
+
+struct ReplayState {
+    SessionTraceReader reader;
+    bool loaded = false;
+
+    webxr_frame_callback_func frameCallback = nullptr;
+    webxr_session_callback_func sessionStartCallback = nullptr;
+    webxr_session_callback_func sessionEndCallback = nullptr;
+    webxr_error_callback_func errorCallback = nullptr;
+    void* userData = nullptr;
+
+    // Same buffers the JS library writes into; internal ones if none registered
+    WebXRFrameData ownFrame = {};
+    WebXRInputSnapshot ownInput = {};
+    WebXRView* views = nullptr;
+    float* modelMatrix = nullptr;
+    void* handData = nullptr;
+    WebXRInputSnapshot* input = nullptr;
+    WebXRFrameStats* frameStats = nullptr;
+
+    float viewportScale = 1.0f;
+    bool fixedFoveation = false;     // WEBXR_REPLAY_FIXED_FOVEATION, the layer claims fixedFoveation
+    bool clearEnabled = false;       // webxr_set_clear_color, applied to the window framebuffer
+    unsigned char clearColor[4] = {};
+    float gpuCosts[MAX_GPU_COSTS];   // WEBXR_REPLAY_GPU_MS, ms per frame at full resolution
+    int gpuCostCount = 0;
+
+    bool inFrame = false;
+    bool running = false;
+    bool exitRequested = false;
+};
+
+ReplayState replay;
+
+// Stands in for the library's full-layer clear before each frame callback
+void clearLayer() {
+    if (!replay.clearEnabled) return;
+    rlDisableScissorTest();
+    rlClearColor(replay.clearColor[0], replay.clearColor[1], replay.clearColor[2], replay.clearColor[3]);
+    rlClearScreenBuffers();
+}
+
+double nowMs() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+WebXRFrameData* frameTarget(WebXRFrameData& scratch) {
+    // Registered views/model/hand buffers may be separate allocations, so
+    // frames are read into scratch and copied out by storeFrame()
+    if (!replay.views) return &replay.ownFrame;
+    return &scratch;
+}
+
+void storeFrame(const WebXRFrameData& frame) {
+    if (!replay.views) return;
+    memcpy(replay.views, frame.views, sizeof(frame.views));
+    memcpy(replay.modelMatrix, frame.modelMatrix, sizeof(frame.modelMatrix));
+    memcpy(replay.handData, frame.hands, WEBXR_HAND_DATA_SIZE);
+}
+
+// Viewports as XRView.requestViewportScale leaves them: same origin, smaller size
+void scaleViewports(WebXRFrameData& frame, float scale) {
+    for (int eye = 0; eye < 2; eye++) {
+        int* viewport = frame.views[eye].viewport;
+        viewport[2] = (int)(viewport[2] * scale + 0.5f);
+        viewport[3] = (int)(viewport[3] * scale + 0.5f);
+    }
+}
+
+void loadGpuCosts() {
+    replay.gpuCostCount = 0;
+    const char* costs = getenv("WEBXR_REPLAY_GPU_MS");
+    while (costs && *costs && replay.gpuCostCount < MAX_GPU_COSTS) {
+        char* end;
+        float cost = strtof(costs, &end);
+        if (end == costs) break;
+        replay.gpuCosts[replay.gpuCostCount++] = cost;
+        costs = *end == ',' ? end + 1 : end;
+    }
+}
+
+// Display periods a frame at `scale` occupies, as an interval in ms
+float simulatedInterval(float gpuCost, float scale) {
+    float period = 1000.0f / SIMULATED_FRAME_RATE;
+    float work = gpuCost * scale * scale;
+    return std::max(1.0f, ceilf(work / period - 1e-3f)) * period;
+}
+
+const WebXRInputSnapshot& currentInput() {
+    return replay.input ? *replay.input : replay.ownInput;
+}
+
+const WebXRHandData* currentHand(int handedness) {
+    if (handedness < 0 || handedness > 1) return nullptr;
+    const char* hands = replay.handData ? (const char*)replay.handData : (const char*)replay.ownFrame.hands;
+    const int* flags = (const int*)(hands + 2 * sizeof(WebXRHandData));
+    if (!flags[handedness]) return nullptr;
+    return (const WebXRHandData*)(hands + handedness * sizeof(WebXRHandData));
+}
+
+}
+
+extern "C" {
+
+int webxr_replay_open(const char* path) {
+    replay.loaded = replay.reader.open(path);
+    if (!replay.loaded) {
+        fprintf(stderr, "webxr_replay: cannot load trace '%s'\n", path);
+    }
+    return replay.loaded ? 1 : 0;
+}
+
+int webxr_replay_run(int loops, WebXRReplayStats* outStats) {
+    if (!replay.loaded || !replay.frameCallback || replay.running) return 0;
+
+    replay.running = true;
+    replay.exitRequested = false;
+    replay.viewportScale = 1.0f;
+    loadGpuCosts();
+    const char* foveation = getenv("WEBXR_REPLAY_FIXED_FOVEATION");
+    replay.fixedFoveation = foveation && atoi(foveation) != 0;
+    if (replay.sessionStartCallback) replay.sessionStartCallback(replay.userData);
+
+    WebXRFrameData scratch;
+    WebXRFrameData* frame = frameTarget(scratch);
+    WebXRInputSnapshot* input = replay.input ? replay.input : &replay.ownInput;
+    WebXRView* views = replay.views ? replay.views : replay.ownFrame.views;
+    float* modelMatrix = replay.modelMatrix ? replay.modelMatrix : replay.ownFrame.modelMatrix;
+    void* handData = replay.handData ? replay.handData : (void*)replay.ownFrame.hands;
+
+    int frameCount = replay.reader.getFrameCount();
+    std::vector<double> latencies;
+    latencies.reserve((size_t)frameCount * std::max(loops, 1));
+
+    int totalFrames = frameCount * std::max(loops, 1);
+    int played = 0;
+    int previousTime = 0;
+    int missedFrames = 0;
+
+    double runStart = nowMs();
+    for (int loop = 0; loop < loops && !replay.exitRequested; loop++) {
+        for (int i = 0; i < frameCount && !replay.exitRequested; i++, played++) {
+            double marshalStart = nowMs();
+            int time = 0;
+            float scale = replay.viewportScale;
+            replay.reader.readFrame(i, &time, frame, input, replay.frameStats);
+            scaleViewports(*frame, scale);
+            storeFrame(*frame);
+
+            float interval, frameRate = 0.0f;
+            if (replay.gpuCostCount > 0) {
+                float cost = replay.gpuCosts[played * replay.gpuCostCount / totalFrames];
+                interval = played > 0 ? simulatedInterval(cost, scale) : 0.0f;
+                frameRate = SIMULATED_FRAME_RATE;
+                if (interval > 1.5f * 1000.0f / SIMULATED_FRAME_RATE) missedFrames++;
+            } else {
+                interval = played > 0 && time > previousTime ? (float)(time - previousTime) : 0.0f;
+            }
+            previousTime = time;
+
+            if (replay.frameStats) {
+                replay.frameStats->marshalTime = (float)(nowMs() - marshalStart);
+                replay.frameStats->frameInterval = interval;
+                replay.frameStats->targetFrameRate = frameRate;
+                replay.frameStats->viewportScale = scale;
+            }
+
+            clearLayer();
+
+            replay.inFrame = true;
+            double callbackStart = nowMs();
+            replay.frameCallback(replay.userData, time, modelMatrix, views, handData);
+            latencies.push_back(nowMs() - callbackStart);
+            replay.inFrame = false;
+        }
+    }
+    double wallTime = nowMs() - runStart;
+
+    if (replay.sessionEndCallback) replay.sessionEndCallback(replay.userData);
+    replay.running = false;
+
+    WebXRReplayStats stats = {};
+    stats.frames = (int)latencies.size();
+    stats.missedFrames = missedFrames;
+    stats.viewportScale = replay.viewportScale;
+    stats.wallTime = wallTime;
+    if (!latencies.empty()) {
+        double sum = 0.0;
+        for (double l : latencies) sum += l;
+        std::sort(latencies.begin(), latencies.end());
+        size_t n = latencies.size();
+        stats.framesPerSecond = wallTime > 0.0 ? stats.frames * 1000.0 / wallTime : 0.0;
+        stats.callbackMean = sum / n;
+        stats.callbackP50 = latencies[std::min(n - 1, n / 2)];
+        stats.callbackP99 = latencies[std::min(n - 1, n * 99 / 100)];
+        stats.callbackMax = latencies[n - 1];
+    }
+    if (outStats) *outStats = stats;
+
+    return stats.frames;
+}
+
+void webxr_replay_close() {
+    replay.reader.close();
+    replay.loaded = false;
+}
+
+void webxr_init(
+        WebXRSessionMode mode,
+        webxr_frame_callback_func frameCallback,
+        webxr_session_callback_func sessionStartCallback,
+        webxr_session_callback_func sessionEndCallback,
+        webxr_error_callback_func errorCallback,
+        void* userData) {
+    replay.frameCallback = frameCallback;
+    replay.sessionStartCallback = sessionStartCallback;
+    replay.sessionEndCallback = sessionEndCallback;
+    replay.errorCallback = errorCallback;
+    replay.userData = userData;
+}
+
+void webxr_set_session_blur_callback(webxr_session_callback_func sessionBlurCallback, void* userData) {
+}
+
+void webxr_set_session_focus_callback(webxr_session_callback_func sessionFocusCallback, void* userData) {
+}
+
+void webxr_request_session() {
+    if (!replay.loaded) {
+        const char* path = getenv("WEBXR_REPLAY_TRACE");
+        if (!path || !webxr_replay_open(path)) {
+            if (replay.errorCallback) replay.errorCallback(replay.userData, WEBXR_ERR_SESSION_UNSUPPORTED);
+            return;
+        }
+    }
+
+    WebXRReplayStats stats;
+    webxr_replay_run(1, &stats);
+    printf("webxr_replay: %d frames in %.1f ms (%.1f fps), callback mean %.3f p50 %.3f p99 %.3f max %.3f ms\n",
+           stats.frames, stats.wallTime, stats.framesPerSecond,
+           stats.callbackMean, stats.callbackP50, stats.callbackP99, stats.callbackMax);
+    if (replay.gpuCostCount > 0) {
+        printf("webxr_replay: simulated GPU load, %d of %d frames missed the display period, final viewport scale %.2f\n",
+               stats.missedFrames, stats.frames, stats.viewportScale);
+    }
+}
+
+void webxr_request_exit() {
+    replay.exitRequested = true;
+}
+
+void webxr_set_projection_params(float near, float far) {
+}
+
+void webxr_set_framebuffer_scale_factor(float scale) {
+}
+
+void webxr_request_viewport_scale(float scale) {
+    replay.viewportScale = std::min(1.0f, std::max(0.05f, scale));
+}
+
+void webxr_set_clear_color(float r, float g, float b, float a) {
+    const float color[4] = { r, g, b, a };
+    for (int i = 0; i < 4; i++) {
+        replay.clearColor[i] = (unsigned char)(std::min(1.0f, std::max(0.0f, color[i])) * 255.0f + 0.5f);
+    }
+    replay.clearEnabled = true;
+}
+
+// There is no WebGL context to count calls on; glCalls stays 0
+void webxr_set_gl_call_counting(int enabled) {
+}
+
+// No runtime foveation here; WEBXR_REPLAY_FIXED_FOVEATION=1 makes the session's
+// layer claim it anyway, so VRHandler leaves foveation to the runtime
+void webxr_set_fixed_foveation(float level) {
+}
+
+int webxr_is_fixed_foveation_supported() {
+    return replay.running && replay.fixedFoveation ? 1 : 0;
+}
+
+// Traces carry no select events, so the queue stays empty
+void webxr_set_input_event_queue(WebXRInputEventQueue* queue) {
+}
+
+void webxr_set_frame_buffers(WebXRView* views, float* modelMatrix, void* handData) {
+    replay.views = views;
+    replay.modelMatrix = modelMatrix;
+    replay.handData = handData;
+}
+
+void webxr_set_frame_stats_buffer(WebXRFrameStats* stats) {
+    replay.frameStats = stats;
+}
+
+void webxr_set_input_snapshot_buffer(WebXRInputSnapshot* snapshot) {
+    replay.input = snapshot;
+}
+
+void webxr_set_select_callback(webxr_input_callback_func callback, void* userData) {
+}
+
+void webxr_set_select_start_callback(webxr_input_callback_func callback, void* userData) {
+}
+
+void webxr_set_select_end_callback(webxr_input_callback_func callback, void* userData) {
+}
+
+void webxr_get_input_sources(WebXRInputSource* outArray, int max, int* outCount) {
+    const WebXRInputSnapshot& input = currentInput();
+    int count = std::min(input.count, max);
+    for (int i = 0; i < count; i++) {
+        outArray[i] = input.inputs[i].source;
+    }
+    *outCount = count;
+}
+
+void webxr_get_input_pose(WebXRInputSource* source, float* outMatrix) {
+    const WebXRInputSnapshot& input = currentInput();
+    if (!replay.inFrame || !source || source->id < 0 || source->id >= input.count) return;
+    memcpy(outMatrix, input.inputs[source->id].gripMatrix, 16 * sizeof(float));
+}
+
+int webxr_is_hand_tracking_supported() {
+    const WebXRInputSnapshot& input = currentInput();
+    for (int i = 0; i < input.count; i++) {
+        if (input.inputs[i].source.hasHand) return 1;
+    }
+    return (currentHand(0) || currentHand(1)) ? 1 : 0;
+}
+
+int webxr_get_hand_joint_pose(int handedness, int jointIndex, float* outPosePtr) {
+    if (!replay.inFrame || jointIndex < 0 || jointIndex >= WEBXR_HAND_JOINT_COUNT) return 0;
+    const WebXRHandData* hand = currentHand(handedness);
+    if (!hand) return 0;
+    memcpy(outPosePtr, &hand->joints[jointIndex], sizeof(WebXRHandJointPose));
+    return 1;
+}
+
+int webxr_is_ar_session() {
+    return replay.reader.getSessionMode() == WEBXR_SESSION_MODE_IMMERSIVE_AR ? 1 : 0;
+}
+
+void webxr_request_ar_session() {
+    webxr_request_session();
+}
+
+}
@@ -0,0 +1,63 @@
+#ifndef WEBXR_REPLAY_H_
+#define WEBXR_REPLAY_H_
+
+/** @file
+ * @brief Replay backend for the WebXR wrapper
+
+Implements the functions of webxr.h from a trace recorded with SessionRecorder,
+so frame handlers can run headless and as fast as possible.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Results of a replay run */
+typedef struct WebXRReplayStats {
+    int frames;             /**< Frame callbacks issued */
+    double wallTime;        /**< Milliseconds for the whole run */
+    double framesPerSecond; /**< Throughput */
+    double callbackMean;    /**< Frame callback latency in milliseconds */
+    double callbackP50;
+    double callbackP99;
+    double callbackMax;
+    int missedFrames;       /**< Frames whose interval exceeded 1.5 display periods */
+    float viewportScale;    /**< Viewport scale in effect on the last frame */
+} WebXRReplayStats;
+
+/**
+Load a session trace.
+
+@param path Trace file written by SessionRecorder
+@return 1 on success, 0 otherwise
+*/
+extern int webxr_replay_open(const char* path);
+
+/**
+Play the loaded trace: session start callback, every frame, session end callback.
+
+webxr_request_session() calls this with one loop, opening the trace named by
+the WEBXR_REPLAY_TRACE environment variable if none is loaded yet.
+
+Frame intervals come from the recorded times. With WEBXR_REPLAY_GPU_MS set,
+they are simulated instead: each frame costs that many milliseconds of GPU
+time at full resolution, scaled by the viewport area, and takes as many 90 Hz
+display periods as that needs. A comma-separated list ("16,8,24") splits the
+run into equal parts with those costs, so dynamic resolution can be watched
+settling under changing load.
+
+
+@param loops Number of times to play the trace
+@param outStats Receives throughput and latency numbers, may be NULL
+@return Number of frames played
+*/
+extern int webxr_replay_run(int loops, WebXRReplayStats* outStats);
+
+/** Release the loaded trace */
+extern void webxr_replay_close();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,433 @@
+#include <webxr.h>
+#include "webxr_stub.h"
+#include <rlgl.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+const float FRAME_RATE = 90.0f;
+const float HALF_IPD = 0.032f;
+
+struct StubState {
+    webxr_frame_callback_func frameCallback = nullptr;
+    webxr_session_callback_func sessionStartCallback = nullptr;
+    webxr_session_callback_func sessionEndCallback = nullptr;
+    webxr_error_callback_func errorCallback = nullptr;
+    void* userData = nullptr;
+    WebXRSessionMode mode = WEBXR_SESSION_MODE_IMMERSIVE_VR;
+
+    WebXRFrameData ownFrame = {};
+    WebXRInputSnapshot ownInput = {};
+    WebXRView* views = nullptr;
+    float* modelMatrix = nullptr;
+    void* handData = nullptr;
+    WebXRInputSnapshot* input = nullptr;
+    WebXRFrameStats* frameStats = nullptr;
+    WebXRInputEventQueue* inputQueue = nullptr;
+    int selectBurst = 0;             // WEBXR_STUB_SELECT_BURST extra events once a second
+    int pressed[2] = {};
+
+    int eyeWidth = 400;
+    int eyeHeight = 600;
+    float viewportScale = 1.0f;
+    bool fixedFoveation = false;     // WEBXR_STUB_FIXED_FOVEATION, the layer claims fixedFoveation
+    bool clearEnabled = false;       // webxr_set_clear_color, applied to the window framebuffer
+    unsigned char clearColor[4] = {};
+    bool inFrame = false;
+    bool running = false;
+    bool exitRequested = false;
+};
+
+StubState stub;
+
+// Stands in for the library's full-layer clear before each frame callback
+void clearLayer() {
+    if (!stub.clearEnabled) return;
+    rlDisableScissorTest();
+    rlClearColor(stub.clearColor[0], stub.clearColor[1], stub.clearColor[2], stub.clearColor[3]);
+    rlClearScreenBuffers();
+}
+
+double nowMs() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+WebXRView* frameViews() { return stub.views ? stub.views : stub.ownFrame.views; }
+float* frameModelMatrix() { return stub.modelMatrix ? stub.modelMatrix : stub.ownFrame.modelMatrix; }
+void* frameHandData() { return stub.handData ? stub.handData : (void*)stub.ownFrame.hands; }
+WebXRInputSnapshot* frameInput() { return stub.input ? stub.input : &stub.ownInput; }
+
+WebXRHandData* frameHand(int handedness) {
+    return (WebXRHandData*)((char*)frameHandData() + handedness * sizeof(WebXRHandData));
+}
+
+int* frameHandFlags() {
+    return (int*)((char*)frameHandData() + 2 * sizeof(WebXRHandData));
+}
+
+// Column-major pose: rotation yaw (around Y) then pitch (around X), translation p
+void buildPose(float* m, float* quat, float yaw, float pitch, const float p[3]) {
+    float cy = cosf(yaw), sy = sinf(yaw), cp = cosf(pitch), sp = sinf(pitch);
+
+    m[0] = cy;       m[1] = 0.0f; m[2] = -sy;      m[3] = 0.0f;
+    m[4] = sy * sp;  m[5] = cp;   m[6] = cy * sp;  m[7] = 0.0f;
+    m[8] = sy * cp;  m[9] = -sp;  m[10] = cy * cp; m[11] = 0.0f;
+    m[12] = p[0];    m[13] = p[1]; m[14] = p[2];   m[15] = 1.0f;
+
+    if (quat) {
+        float cy2 = cosf(yaw * 0.5f), sy2 = sinf(yaw * 0.5f);
+        float cp2 = cosf(pitch * 0.5f), sp2 = sinf(pitch * 0.5f);
+        quat[0] = cy2 * sp2;
+        quat[1] = sy2 * cp2;
+        quat[2] = -sy2 * sp2;
+        quat[3] = cy2 * cp2;
+    }
+}
+
+void buildPerspective(float* m, float fovY, float aspect, float nearPlane, float farPlane) {
+    float f = 1.0f / tanf(fovY * 0.5f);
+    memset(m, 0, 16 * sizeof(float));
+    m[0] = f / aspect;
+    m[5] = f;
+    m[10] = (farPlane + nearPlane) / (nearPlane - farPlane);
+    m[11] = -1.0f;
+    m[14] = 2.0f * farPlane * nearPlane / (nearPlane - farPlane);
+}
+
+void fillHand(WebXRHandData* hand, const float wrist[3], float side, float curl, float pinch) {
+    static const int fingerStarts[5] = {1, 5, 10, 15, 20};
+    static const int fingerLengths[5] = {4, 5, 5, 5, 5};
+
+    memset(hand, 0, sizeof(*hand));
+    for (int i = 0; i < WEBXR_HAND_JOINT_COUNT; i++) hand->joints[i].rotation[3] = 1.0f;
+
+    WebXRHandJointPose& w = hand->joints[WEBXR_HAND_JOINT_WRIST];
+    memcpy(w.position, wrist, sizeof(w.position));
+    w.radius = 0.02f;
+
+    for (int finger = 0; finger < 5; finger++) {
+        // Palm down, fingers forward; phalanges bend down and back as the hand closes
+        float p[3] = { wrist[0] + side * (finger - 2) * 0.02f, wrist[1], wrist[2] - 0.03f };
+        float bend = curl * (finger == 0 ? 0.4f : 1.1f);
+        float angle = 0.0f;
+
+        for (int j = 0; j < fingerLengths[finger]; j++) {
+            WebXRHandJointPose& joint = hand->joints[fingerStarts[finger] + j];
+            memcpy(joint.position, p, sizeof(joint.position));
+            joint.radius = (j == fingerLengths[finger] - 1) ? 0.008f : 0.01f;
+
+            if (j > 0) angle += bend;
+            p[1] -= sinf(angle) * 0.025f;
+            p[2] -= cosf(angle) * 0.025f;
+        }
+    }
+
+    // Thumb tip closes on the index tip
+    const float* indexTip = hand->joints[WEBXR_HAND_JOINT_INDEX_FINGER_TIP].position;
+    float* thumbTip = hand->joints[WEBXR_HAND_JOINT_THUMB_TIP].position;
+    for (int k = 0; k < 3; k++) thumbTip[k] += (indexTip[k] - thumbTip[k]) * pinch;
+}
+
+void fillFrame(int frameIndex) {
+    float t = frameIndex / FRAME_RATE;
+
+    // Head sways slightly so view matrices change every frame
+    float yaw = 0.3f * sinf(t * 0.5f);
+    float pitch = 0.1f * sinf(t * 0.7f);
+    float head[3] = { 0.05f * sinf(t), 1.6f, 0.0f };
+    buildPose(frameModelMatrix(), nullptr, yaw, pitch, head);
+
+    WebXRView* views = frameViews();
+    const float* right = frameModelMatrix();
+    for (int eye = 0; eye < 2; eye++) {
+        WebXRView& view = views[eye];
+        float offset = eye == 0 ? -HALF_IPD : HALF_IPD;
+        float position[3] = { head[0] + right[0] * offset, head[1] + right[1] * offset, head[2] + right[2] * offset };
+
+        buildPose(view.viewMatrix, view.rotation, yaw, pitch, position);
+        buildPerspective(view.projectionMatrix, 1.6f, (float)stub.eyeWidth / stub.eyeHeight, 0.1f, 1000.0f);
+        memcpy(view.position, position, sizeof(view.position));
+        // Scaled like XRView.requestViewportScale: same origin, smaller size
+        view.viewport[0] = eye * stub.eyeWidth;
+        view.viewport[1] = 0;
+        view.viewport[2] = (int)(stub.eyeWidth * stub.viewportScale + 0.5f);
+        view.viewport[3] = (int)(stub.eyeHeight * stub.viewportScale + 0.5f);
+    }
+
+    // Alternate every 5 seconds between controllers and tracked hands
+    bool handsMode = (frameIndex / (int)(5 * FRAME_RATE)) % 2 == 1;
+    float curl = 0.5f + 0.5f * sinf(t * 3.0f);
+    float pinch = std::max(0.0f, sinf(t * 1.7f));
+    WebXRInputSnapshot* input = frameInput();
+    int* handFlags = frameHandFlags();
+
+    input->count = 2;
+    for (int hand = 0; hand < 2; hand++) {
+        float side = hand == 0 ? -1.0f : 1.0f;
+        float grip[3] = { side * 0.2f + 0.05f * sinf(t * 1.3f + hand), 1.2f + 0.05f * cosf(t), -0.35f };
+
+        WebXRInputState& state = input->inputs[hand];
+        memset(&state, 0, sizeof(state));
+        state.source.id = hand;
+        state.source.handedness = hand == 0 ? WEBXR_HANDEDNESS_LEFT : WEBXR_HANDEDNESS_RIGHT;
+        state.source.targetRayMode = WEBXR_TARGET_RAY_MODE_TRACKED_POINTER;
+        state.source.hasHand = handsMode ? 1 : 0;
+        state.source.hasController = 1;
+        state.hasGripPose = 1;
+        state.hasTargetRayPose = 1;
+        buildPose(state.gripMatrix, nullptr, side * 0.2f, -0.3f, grip);
+        buildPose(state.targetRayMatrix, nullptr, side * 0.2f, -0.5f, grip);
+
+        if (!handsMode) {
+            // Controllers report velocities like XRPose.linearVelocity; tracked hands don't
+            state.hasGripVelocity = 1;
+            state.gripLinearVelocity[0] = 0.05f * 1.3f * cosf(t * 1.3f + hand);
+            state.gripLinearVelocity[1] = -0.05f * sinf(t);
+
+            float trigger = 0.5f + 0.5f * sinf(t * 2.0f + hand);
+            state.buttonCount = 2;
+            state.buttonValues[0] = trigger;
+            state.buttonsPressed = trigger > 0.75f ? 1 : 0;
+            state.buttonsTouched = trigger > 0.25f ? 1 : 0;
+            state.axisCount = 4;
+            state.axes[2] = sinf(t);
+            state.axes[3] = cosf(t);
+        }
+
+        handFlags[hand] = handsMode ? 1 : 0;
+        if (handsMode) fillHand(frameHand(hand), grip, side, curl, pinch);
+    }
+}
+
+void pushInputEvent(int type, double timestamp, const WebXRInputState& state) {
+    WebXRInputEventQueue* queue = stub.inputQueue;
+    if (!queue) return;
+
+    unsigned int head = queue->head;
+    if (head - __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE) >= WEBXR_INPUT_EVENT_CAPACITY) {
+        queue->dropped++;
+        return;
+    }
+
+    WebXRInputEvent& event = queue->events[head % WEBXR_INPUT_EVENT_CAPACITY];
+    event.timestamp = timestamp;
+    event.type = type;
+    event.source = state.source;
+    event.hasGripPose = state.hasGripPose;
+    event.hasTargetRayPose = state.hasTargetRayPose;
+    memcpy(event.gripMatrix, state.gripMatrix, sizeof(event.gripMatrix));
+    memcpy(event.targetRayMatrix, state.targetRayMatrix, sizeof(event.targetRayMatrix));
+    __atomic_store_n(&queue->head, head + 1, __ATOMIC_RELEASE);
+}
+
+// Select events as the browser would dispatch them before this frame: trigger
+// presses and releases, plus the optional burst of extra selects
+void queueInputEvents(int frame) {
+    const WebXRInputSnapshot* input = frameInput();
+    double frameTime = frame * 1000.0 / FRAME_RATE;
+    double dispatchTime = frameTime - 0.5 * 1000.0 / FRAME_RATE;
+
+    for (int hand = 0; hand < 2; hand++) {
+        const WebXRInputState& state = input->inputs[hand];
+        int pressed = state.buttonsPressed & 1;
+        if (pressed && !stub.pressed[hand]) {
+            pushInputEvent(WEBXR_INPUT_EVENT_SELECT_START, dispatchTime, state);
+        } else if (!pressed && stub.pressed[hand]) {
+            pushInputEvent(WEBXR_INPUT_EVENT_SELECT_END, dispatchTime, state);
+            pushInputEvent(WEBXR_INPUT_EVENT_SELECT, dispatchTime, state);
+        }
+        stub.pressed[hand] = pressed;
+    }
+
+    if (stub.selectBurst > 0 && frame % (int)FRAME_RATE == (int)FRAME_RATE / 2) {
+        for (int i = 0; i < stub.selectBurst; i++) {
+            double time = frameTime - 1000.0 / FRAME_RATE * (stub.selectBurst - i) / (stub.selectBurst + 1);
+            pushInputEvent(WEBXR_INPUT_EVENT_SELECT, time, input->inputs[i % 2]);
+        }
+    }
+}
+
+}
+
+extern "C" {
+
+int webxr_stub_run(int frames) {
+    if (!stub.frameCallback || stub.running) return 0;
+
+    stub.running = true;
+    stub.exitRequested = false;
+    stub.viewportScale = 1.0f;
+    stub.pressed[0] = stub.pressed[1] = 0;
+    const char* burst = getenv("WEBXR_STUB_SELECT_BURST");
+    stub.selectBurst = burst ? std::max(0, atoi(burst)) : 0;
+    const char* foveation = getenv("WEBXR_STUB_FIXED_FOVEATION");
+    stub.fixedFoveation = foveation && atoi(foveation) != 0;
+    if (stub.sessionStartCallback) stub.sessionStartCallback(stub.userData);
+
+    int frame = 0;
+    for (; frame < frames && !stub.exitRequested; frame++) {
+        double marshalStart = nowMs();
+        fillFrame(frame);
+        if (stub.frameStats) {
+            stub.frameStats->marshalTime = (float)(nowMs() - marshalStart);
+            // Poses are sampled at the frame time and shown one frame later
+            stub.frameStats->predictedDisplayDelta = 1000.0f / FRAME_RATE;
+            stub.frameStats->frameInterval = frame > 0 ? 1000.0f / FRAME_RATE : 0.0f;
+            stub.frameStats->targetFrameRate = FRAME_RATE;
+            stub.frameStats->viewportScale = stub.viewportScale;
+        }
+
+        queueInputEvents(frame);
+        clearLayer();
+
+        stub.inFrame = true;
+        stub.frameCallback(stub.userData, (int)(frame * 1000.0f / FRAME_RATE),
+                           frameModelMatrix(), frameViews(), frameHandData());
+        stub.inFrame = false;
+    }
+
+    if (stub.sessionEndCallback) stub.sessionEndCallback(stub.userData);
+    stub.running = false;
+    return frame;
+}
+
+void webxr_init(
+        WebXRSessionMode mode,
+        webxr_frame_callback_func frameCallback,
+        webxr_session_callback_func sessionStartCallback,
+        webxr_session_callback_func sessionEndCallback,
+        webxr_error_callback_func errorCallback,
+        void* userData) {
+    stub.mode = mode;
+    stub.frameCallback = frameCallback;
+    stub.sessionStartCallback = sessionStartCallback;
+    stub.sessionEndCallback = sessionEndCallback;
+    stub.errorCallback = errorCallback;
+    stub.userData = userData;
+
+    const char* viewport = getenv("WEBXR_STUB_VIEWPORT");
+    int width = 0, height = 0;
+    if (viewport && sscanf(viewport, "%dx%d", &width, &height) == 2 && width > 0 && height > 0) {
+        stub.eyeWidth = width;
+        stub.eyeHeight = height;
+    }
+}
+
+void webxr_set_session_blur_callback(webxr_session_callback_func sessionBlurCallback, void* userData) {
+}
+
+void webxr_set_session_focus_callback(webxr_session_callback_func sessionFocusCallback, void* userData) {
+}
+
+void webxr_request_session() {
+    const char* frames = getenv("WEBXR_STUB_FRAMES");
+    int count = frames ? atoi(frames) : 0;
+    webxr_stub_run(count > 0 ? count : (int)(10 * FRAME_RATE));
+}
+
+void webxr_request_exit() {
+    stub.exitRequested = true;
+}
+
+void webxr_set_projection_params(float near, float far) {
+}
+
+void webxr_set_framebuffer_scale_factor(float scale) {
+}
+
+void webxr_request_viewport_scale(float scale) {
+    stub.viewportScale = std::min(1.0f, std::max(0.05f, scale));
+}
+
+void webxr_set_clear_color(float r, float g, float b, float a) {
+    const float color[4] = { r, g, b, a };
+    for (int i = 0; i < 4; i++) {
+        stub.clearColor[i] = (unsigned char)(std::min(1.0f, std::max(0.0f, color[i])) * 255.0f + 0.5f);
+    }
+    stub.clearEnabled = true;
+}
+
+// There is no WebGL context to count calls on; glCalls stays 0
+void webxr_set_gl_call_counting(int enabled) {
+}
+
+// No runtime foveation here; WEBXR_STUB_FIXED_FOVEATION=1 makes the session's
+// layer claim it anyway, so VRHandler leaves foveation to the runtime
+void webxr_set_fixed_foveation(float level) {
+}
+
+int webxr_is_fixed_foveation_supported() {
+    return stub.running && stub.fixedFoveation ? 1 : 0;
+}
+
+void webxr_set_input_event_queue(WebXRInputEventQueue* queue) {
+    stub.inputQueue = queue;
+}
+
+void webxr_set_frame_buffers(WebXRView* views, float* modelMatrix, void* handData) {
+    stub.views = views;
+    stub.modelMatrix = modelMatrix;
+    stub.handData = handData;
+}
+
+void webxr_set_frame_stats_buffer(WebXRFrameStats* stats) {
+    stub.frameStats = stats;
+}
+
+void webxr_set_input_snapshot_buffer(WebXRInputSnapshot* snapshot) {
+    stub.input = snapshot;
+}
+
+void webxr_set_select_callback(webxr_input_callback_func callback, void* userData) {
+}
+
+void webxr_set_select_start_callback(webxr_input_callback_func callback, void* userData) {
+}
+
+void webxr_set_select_end_callback(webxr_input_callback_func callback, void* userData) {
+}
+
+void webxr_get_input_sources(WebXRInputSource* outArray, int max, int* outCount) {
+    const WebXRInputSnapshot* input = frameInput();
+    int count = std::min(input->count, max);
+    for (int i = 0; i < count; i++) {
+        outArray[i] = input->inputs[i].source;
+    }
+    *outCount = count;
+}
+
+void webxr_get_input_pose(WebXRInputSource* source, float* outMatrix) {
+    const WebXRInputSnapshot* input = frameInput();
+    if (!stub.inFrame || !source || source->id < 0 || source->id >= input->count) return;
+    memcpy(outMatrix, input->inputs[source->id].gripMatrix, 16 * sizeof(float));
+}
+
+int webxr_is_hand_tracking_supported() {
+    // Hands appear every other 5 second period, as if the user put controllers down
+    return 1;
+}
+
+int webxr_get_hand_joint_pose(int handedness, int jointIndex, float* outPosePtr) {
+    if (!stub.inFrame || handedness < 0 || handedness > 1) return 0;
+    if (jointIndex < 0 || jointIndex >= WEBXR_HAND_JOINT_COUNT) return 0;
+    if (!frameHandFlags()[handedness]) return 0;
+    memcpy(outPosePtr, &frameHand(handedness)->joints[jointIndex], sizeof(WebXRHandJointPose));
+    return 1;
+}
+
+int webxr_is_ar_session() {
+    return stub.mode == WEBXR_SESSION_MODE_IMMERSIVE_AR ? 1 : 0;
+}
+
+void webxr_request_ar_session() {
+    stub.mode = WEBXR_SESSION_MODE_IMMERSIVE_AR;
+    webxr_request_session();
+}
+
+}
@@ -0,0 +1,33 @@
+#ifndef WEBXR_STUB_H_
+#define WEBXR_STUB_H_
+
+/** @file
+ * @brief Synthetic WebXR backend for native builds
+
+Implements the functions of webxr.h without a browser or headset. A session
+produces animated head, controller and hand poses so the whole frame pipeline
+can be profiled on the host.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+Run a synthetic session: session start callback, `frames` frame callbacks at
+90 Hz time steps (as fast as possible), session end callback.
+
+webxr_request_session() calls this with WEBXR_STUB_FRAMES frames (default 900).
+Per-eye viewport size can be set with WEBXR_STUB_VIEWPORT=<width>x<height>.
+Controller trigger presses queue selectstart/selectend/select events; with
+WEBXR_STUB_SELECT_BURST=<n>, n extra select events are queued once a second.
+
+@return Number of frames run
+*/
+extern int webxr_stub_run(int frames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif